@@ -18,7 +18,9 @@
  */
 
 #include "cz_Define.h"
+#include "cz_Ffunc.h"
 #include <string>
+#include <stdlib.h>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -110,25 +112,47 @@ public:
     pitch[2] = m_pch[2];
   }
 
+  // #################################################################
+  /**
+   * @brief S3D配列の確保形状
+   * @param [in]  sz  配列サイズ
+   * @param [out] ext K, I, J方向の配列の長さ（ガイドセルとパディングを含む）
+   * @ret 要素数
+   * @note パディングは cz_layout_set_() の指定による．Fortranカーネルの宣言と同じ形状を返す
+   */
+  size_t Size_S3D(const int* sz, int* ext=NULL)
+  {
+    int m_sz[3] = {sz[0], sz[1], sz[2]};
+    int gc = GUIDE;
+    int e[3];
+
+    cz_layout_ext_(m_sz, &gc, e);
+
+    if ( ext ) {
+      ext[0] = e[0];
+      ext[1] = e[1];
+      ext[2] = e[2];
+    }
+
+    return (size_t)e[0] * (size_t)e[1] * (size_t)e[2];
+  }
+
   // #################################################################
   /**
    * @brief S3D配列のアロケート
    * @param [in] sz 配列サイズ
    * @ret pointer
+   * @note 先頭を CZ_ALIGN バイトに揃える．free()で解放
    */
   REAL_TYPE* Alloc_Real_S3D(const int* sz)
   {
     if ( !sz ) return NULL;
 
-    size_t dims[3], nx;
-
-    dims[0] = (size_t)(sz[0] + 2*GUIDE);
-    dims[1] = (size_t)(sz[1] + 2*GUIDE);
-    dims[2] = (size_t)(sz[2] + 2*GUIDE);
-
-    nx = dims[0] * dims[1] * dims[2];
+    size_t nx = Size_S3D(sz);
 
-    REAL_TYPE* var = new REAL_TYPE[nx];
+    void* ptr = NULL;
+    if ( posix_memalign(&ptr, CZ_ALIGN, nx*sizeof(REAL_TYPE)) != 0 ) return NULL;
+    REAL_TYPE* var = (REAL_TYPE*)ptr;
 
   #pragma omp parallel for
     for (int i=0; i<nx; i++) var[i]=0.0;
@@ -87,11 +87,16 @@ private:
   int ls_type;             ///< 線形ソルバ種類
   int pc_type;             ///< 前処理ソルバ種類
   double eps;              ///< convergence criteria
+  int res_lag;             ///< 収束判定を遅らせる反復数 0-同期的に判定
+  double lag_res[RES_LAG_MAX+1]; ///< 遅延判定の残差の集計バッファ
+  int lag_itr[RES_LAG_MAX+1];    ///< 遅延判定の集計を開始した反復
   REAL_TYPE ac1;           ///< acceleration coef.
   double res_normal;       ///< 全計算点数
   REAL_TYPE cf[7];         ///< 係数
   std::string precon;      ///< 前処理文字列
   int SW_maf;
+  int SW_mtr;              ///< MAFの計量 1-配列を参照, 0-格子点毎に再計算
+  int SW_omg;              ///< 加速係数 1-収束率から推定, 0-指定値
   int SW_esa;
 
 
@@ -107,6 +112,10 @@ private:
   SubDomain D;               ///< 領域分割情報保持クラス
   BrickComm CM;              ///< 通信クラス
   MPI_Request req[NOFACE*2]; ///< Communication identifier for nonblocking
+  MPI_Request req_sum;       ///< 非同期Allreduceの識別子
+  MPI_Request lag_req[RES_LAG_MAX+1]; ///< 遅延判定の残差の非同期Allreduceの識別子
+  BrickComm CMg[MG_LEVEL_MAX]; ///< マルチグリッドの粗格子の通信クラス
+  MPI_Comm comm_k;           ///< 同じ(I,J)位置でK方向に並ぶランクの通信子
 #endif
 
   FILE* fph;
@@ -132,9 +141,21 @@ public:
   REAL_TYPE* pcg_t ; ///< work for BiCGstab
   REAL_TYPE* pcg_t_; ///< work for BiCGstab
   
+  REAL_TYPE* pcg_r_; ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_q_; ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_w;  ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_w_; ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_y;  ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_z;  ///< work for pipelined BiCGstab / CG
+  REAL_TYPE* pcg_z_; ///< work for pipelined BiCGstab
+  REAL_TYPE* pcg_v;  ///< work for pipelined BiCGstab
+  
   REAL_TYPE* xc; ///< 格子
   REAL_TYPE* yc;
   REAL_TYPE* zc;
+  REAL_TYPE* mtx; ///< MAFの計量係数 (3, size[0]+2*GUIDE)
+  REAL_TYPE* mty;
+  REAL_TYPE* mtz;
   REAL_TYPE* vrtmp; ///< temporary for supressing vector reduction
   REAL_TYPE* pvt; ///< 行の最大要素
 
@@ -149,6 +170,89 @@ public:
   REAL_TYPE* SC;
   REAL_TYPE* SD;
 
+  REAL_TYPE* FE;     ///< PCR係数キャッシュ e
+  REAL_TYPE* FA;     ///< PCR係数キャッシュ e*a
+  REAL_TYPE* FC;     ///< PCR係数キャッシュ e*c
+  REAL_TYPE* F2;     ///< PCR最終段 2x2系の逆行列
+  REAL_TYPE* F4;     ///< PCR最終段 4x4系の逆行列
+  REAL_TYPE* TW;     ///< PCR-Thomas法 前進消去の対角の逆数
+  REAL_TYPE* TA;     ///< PCR-Thomas法 前進消去の係数
+  REAL_TYPE* TC;     ///< PCR-Thomas法 後退代入の係数
+  int hyb_q;         ///< PCR-Thomas法のPCRの段数
+  int hyb_nt;        ///< PCR-Thomas法の対象長 2**hyb_q の倍数
+  REAL_TYPE* FD;     ///< PCR用の袖付きライン配列
+  REAL_TYPE* FD1;    ///< PCR用の袖付きライン配列
+
+  int* RBL;          ///< 2色オーダリングのライン(i,j)リスト 色0, 色1の順
+  int rbl_num[2];    ///< 各色のライン数
+
+  REAL_TYPE* FU;     ///< K方向分割時のPCR minus側の境界値1に対する応答
+  REAL_TYPE* FV;     ///< K方向分割時のPCR plus側の境界値1に対する応答
+  REAL_TYPE* PYE;    ///< ラインの両端の局所解 (2, nl)
+  REAL_TYPE* PXE;    ///< ラインの隣接ランク側の境界値 (2, nl)
+  REAL_TYPE* PYA;    ///< K方向の全ランクのラインの両端の局所解 (2, nl, pcr_np)
+  double* pcr_cf;    ///< K方向の縮約系の係数 (uF, uL, Mi00, Mi10, e0, e1) x pcr_np
+  int pcr_np;        ///< K方向のランク数 1のときは分割なし
+  int pcr_lanes;     ///< pcr_rbで同時に解くライン数（SIMDレーン数） 0のときは1ライン毎
+  int pcr_kr;        ///< K方向のランク番号
+
+  REAL_TYPE* TBW;    ///< 時間ブロッキングの中間段リングバッファ
+  int tb_depth;      ///< 時間ブロッキングで1ブロックに進める反復数
+
+  int mg_lv;                       ///< マルチグリッドの階層数（細格子を含む）
+  int mg_sz[MG_LEVEL_MAX][3];      ///< 各階層の配列サイズ
+  int mg_idx[MG_LEVEL_MAX][6];     ///< 各階層の内点インデクス範囲
+  int mg_ip[MG_LEVEL_MAX];         ///< 各階層の2色オーダリングの基点の色
+  REAL_TYPE mg_s[MG_LEVEL_MAX];    ///< 各階層の物理境界の外挿係数
+  REAL_TYPE* mg_x[MG_LEVEL_MAX];   ///< 各階層の補正量 [0]は未使用
+  REAL_TYPE* mg_b[MG_LEVEL_MAX];   ///< 各階層の残差 [0]は未使用
+
+  REAL_TYPE* chb_r;  ///< Chebyshev反復の残差
+  REAL_TYPE* chb_d;  ///< Chebyshev反復の修正量
+  REAL_TYPE* chb_e;  ///< Chebyshev反復の次の修正量
+  double chb_lo;     ///< D^{-1}A の最小固有値の推定値
+  double chb_hi;     ///< D^{-1}A の最大固有値の推定値
+
+  REAL_TYPE* ir_xl;  ///< 反復改良の解の下位（上位は解ベクトル）
+  REAL_TYPE* ir_r;   ///< 反復改良の残差
+  REAL_TYPE* ir_d;   ///< 反復改良の修正量
+
+  REAL_TYPE* ca_y;   ///< s-step BiCGSTABの基底 [P (2s+1本), R (2s本)] を連続に確保
+  REAL_TYPE* ca_rt;  ///< s-step BiCGSTABのシャドウ残差
+  int ca_s;          ///< 1回の集団通信で進める反復数 s
+  int ca_rr;         ///< 残差を陽に再計算する外側反復の間隔 0-再計算しない
+  int ca_basis;      ///< 基底 0-単項式, 1-Newton
+  double ca_sg;      ///< 基底のスケール
+  double ca_th[2*CA_S_MAX]; ///< Newton基底のシフト
+
+  REAL_TYPE* gm_v;   ///< FGMRESのKrylov基底 V (m+1本) を連続に確保
+  REAL_TYPE* gm_z;   ///< FGMRESの前処理後の基底 Z (m本) を連続に確保
+  int gm_m;          ///< FGMRESのリスタート長 m
+
+  REAL_TYPE* ws_x;   ///< 初期値の推定に使う過去の解 (K本のリングバッファ) を連続に確保
+  REAL_TYPE* ws_r;   ///< 射影に使う残差 (K本) を連続に確保
+  REAL_TYPE* ws_b;   ///< 繰り返し求解の試験で変化させる前のRHS
+  int ws_type;       ///< 初期値 0-ゼロ, 1-多項式外挿, 2-最小二乗射影
+  int ws_k;          ///< 保持する過去の解の本数 K
+  int ws_cnt;        ///< これまでに保持した解の数
+  int ws_steps;      ///< 繰り返し求解の回数
+
+  REAL_TYPE* bt_x[BATCH_MAX]; ///< 一括求解の解ベクトル [0]はP
+  REAL_TYPE* bt_b[BATCH_MAX]; ///< 一括求解のRHS [0]はRHS
+  REAL_TYPE* bt_w;   ///< RHSの番号を最内にした一括求解の作業配列 (x, b, BiCGstabの8本) を連続に確保
+  REAL_TYPE* bt_buf; ///< 一括求解の袖通信のパックバッファ
+  double bt_res[BATCH_MAX]; ///< RHS毎の残差
+  int bt_n;          ///< 一括求解するRHSの本数 1のときは一括求解しない
+  int bt_face;       ///< 最大の面の節点数
+
+  REAL_TYPE* sp_x[2]; ///< 色毎に分けた解ベクトル [0]色0, [1]色1
+  REAL_TYPE* sp_b[2]; ///< 色毎に分けたRHS
+  int sp_nh;          ///< 色毎の配列のK方向の長さ
+  int SW_split;       ///< sor2smaの配列 1-色毎に分ける, 0-自然順
+
+  int mc_nc;          ///< 多色SORの色数 4 or 8
+  REAL_TYPE* MCT;     ///< 多色SORの区間ブロックの逆行列 (w, w, w)
+
 public:
   // コンストラクタ
   CZ()
@@ -160,10 +264,74 @@ public:
     ls_type = 0;
     pc_type = 0;
     eps = 1.0e-5;
+    res_lag = 0;
+    for (int i=0; i<=RES_LAG_MAX; i++) {
+      lag_res[i] = 0.0;
+      lag_itr[i] = 0;
+    }
     ac1 = 0.0;
     res_normal = 0.0;
     SW_maf = 0;
+    SW_mtr = 0;
+    SW_omg = 0;
+    mtx = mty = mtz = NULL;
+    fph = NULL;
+    WRK = P = RHS = MSK = SRC = EXS = ERR = NULL;
+    pcg_p = pcg_p_ = pcg_r = pcg_r0 = pcg_q = NULL;
+    pcg_s = pcg_s_ = pcg_t = pcg_t_ = NULL;
+    pcg_r_ = pcg_q_ = pcg_w = pcg_w_ = NULL;
+    pcg_y = pcg_z = pcg_z_ = pcg_v = NULL;
+    xc = yc = zc = vrtmp = pvt = NULL;
+    WA = WC = WD = WAA = WCC = WDD = NULL;
+    SA = SC = SD = NULL;
+    FE = FA = FC = F2 = F4 = FD = FD1 = NULL;
+    TW = TA = TC = NULL;
+    hyb_q = hyb_nt = 0;
     SW_esa = 0;
+    RBL = NULL;
+    rbl_num[0] = rbl_num[1] = 0;
+    FU = FV = NULL;
+    PYE = PXE = PYA = NULL;
+    pcr_cf = NULL;
+    pcr_np = 1;
+    pcr_lanes = 0;
+    pcr_kr = 0;
+    TBW = NULL;
+    tb_depth = TB_DEPTH;
+    mg_lv = 0;
+    for (int l=0; l<MG_LEVEL_MAX; l++) {
+      mg_x[l] = mg_b[l] = NULL;
+      mg_ip[l] = 0;
+      mg_s[l] = 0.0;
+    }
+    chb_r = chb_d = chb_e = NULL;
+    chb_lo = chb_hi = 0.0;
+    ir_xl = ir_r = ir_d = NULL;
+    ca_y = ca_rt = NULL;
+    ca_s = 4;
+    ca_rr = 0;
+    ca_basis = 1;
+    ca_sg = 1.0;
+    for (int i=0; i<2*CA_S_MAX; i++) ca_th[i] = 0.0;
+    gm_v = gm_z = NULL;
+    gm_m = 30;
+    ws_x = ws_r = ws_b = NULL;
+    ws_type = 0;
+    ws_k = 3;
+    ws_cnt = 0;
+    ws_steps = 1;
+    for (int i=0; i<BATCH_MAX; i++) {
+      bt_x[i] = bt_b[i] = NULL;
+      bt_res[i] = 0.0;
+    }
+    bt_w = bt_buf = NULL;
+    bt_n = 1;
+    bt_face = 0;
+    sp_x[0] = sp_x[1] = sp_b[0] = sp_b[1] = NULL;
+    sp_nh = 0;
+    SW_split = 0;
+    mc_nc = 4;
+    MCT = NULL;
     
     
     for (int i=0; i<6; i++) {
@@ -177,17 +345,153 @@ public:
       exit(0);
     }
     for (int i=0; i<NOFACE*2; i++) req[i] = MPI_REQUEST_NULL;
+    req_sum = MPI_REQUEST_NULL;
+    for (int i=0; i<=RES_LAG_MAX; i++) lag_req[i] = MPI_REQUEST_NULL;
+    comm_k = MPI_COMM_NULL;
 #endif
   }
 
 
-  // デストラクタ
-  ~CZ() {}
+  // デストラクタ Setup()で確保した配列を解放
+  ~CZ()
+  {
+    czDelete(WRK);
+    czDelete(P);
+    czDelete(RHS);
+    czDelete(MSK);
+    czDelete(SRC);
+    czDelete(EXS);
+    czDelete(ERR);
+
+    czDelete(pcg_p);
+    czDelete(pcg_p_);
+    czDelete(pcg_r);
+    czDelete(pcg_r0);
+    czDelete(pcg_q);
+    czDelete(pcg_s);
+    czDelete(pcg_s_);
+    czDelete(pcg_t);
+    czDelete(pcg_t_);
+    czDelete(pcg_r_);
+    czDelete(pcg_q_);
+    czDelete(pcg_w);
+    czDelete(pcg_w_);
+    czDelete(pcg_y);
+    czDelete(pcg_z);
+    czDelete(pcg_z_);
+    czDelete(pcg_v);
+
+    czDelete(xc);
+    czDelete(yc);
+    czDelete(zc);
+    czDelete(mtx);
+    czDelete(mty);
+    czDelete(mtz);
+    czDelete(vrtmp);
+    czDelete(pvt);
+
+    czDelete(WA);
+    czDelete(WC);
+    czDelete(WD);
+    czDelete(WAA);
+    czDelete(WCC);
+    czDelete(WDD);
+    czDelete(SA);
+    czDelete(SC);
+    czDelete(SD);
+
+    czDelete(FE);
+    czDelete(FA);
+    czDelete(FC);
+    czDelete(F2);
+    czDelete(F4);
+    czDelete(TW);
+    czDelete(TA);
+    czDelete(TC);
+    czDelete(FD);
+    czDelete(FD1);
+    czDelete(RBL);
+    czDelete(FU);
+    czDelete(FV);
+    czDelete(PYE);
+    czDelete(PXE);
+    czDelete(PYA);
+    czDelete(pcr_cf);
+
+    czDelete(TBW);
+    for (int l=0; l<MG_LEVEL_MAX; l++) {
+      czDelete(mg_x[l]);
+      czDelete(mg_b[l]);
+    }
+    czDelete(chb_r);
+    czDelete(chb_d);
+    czDelete(chb_e);
+    czDelete(ir_xl);
+    czDelete(ir_r);
+    czDelete(ir_d);
+    czDelete(ca_y);
+    czDelete(ca_rt);
+    czDelete(gm_v);
+    czDelete(gm_z);
+    czDelete(ws_x);
+    czDelete(ws_r);
+    czDelete(ws_b);
+
+    // [0]は P, RHS
+    for (int m=1; m<BATCH_MAX; m++) {
+      czDelete(bt_x[m]);
+      czDelete(bt_b[m]);
+    }
+    czDelete(bt_w);
+    czDelete(bt_buf);
+    for (int c=0; c<2; c++) {
+      czDelete(sp_x[c]);
+      czDelete(sp_b[c]);
+    }
+    czDelete(MCT);
+
+    if (fph) fclose(fph);
+
+#ifndef DISABLE_MPI
+    int fin = 0;
+    MPI_Finalized(&fin);
+    if ( !fin && comm_k != MPI_COMM_NULL ) MPI_Comm_free(&comm_k);
+#endif
+  }
 
 
 public:
+  // コマンドラインで指定された問題を解く Setup(), Solve(), Post() の順に呼ぶ
   int Evaluate(int argc, char **argv);
 
+  // 領域分割，配列の確保と前計算
+  int Setup(int argc, char **argv);
+
+  // Setup()済みの状態で1回解く
+  int Solve(double& res,
+            REAL_TYPE* X,
+            REAL_TYPE* B,
+            double& flop,
+            const double tol=0.0);
+
+  // タイミングと誤差の出力
+  int Post();
+
+  // 繰り返し求解の初期値 過去の解から推定する
+  bool InitialGuess(REAL_TYPE* X,
+                    REAL_TYPE* B,
+                    double& flop);
+
+  // 求めた解を初期値の推定用に保持
+  void storeSolution(REAL_TYPE* X);
+
+  // 複数のRHSを一括で解く
+  int SolveBatch(double* res,
+                 REAL_TYPE** X,
+                 REAL_TYPE** B,
+                 const int nr,
+                 double& flop);
+
   void debug(int m_mode) {
       debug_mode = m_mode;
   }
@@ -205,20 +509,16 @@ public:
    * @brief S3D配列のアロケート
    * @param [in] sz 配列サイズ
    * @ret pointer
+   * @note 形状はパディングを含めて Size_S3D() による
    */
   template <typename T>
   T* czAllocR_S3D(const int* sz, T type)
   {
     if ( !sz ) return NULL;
     
-    size_t dims[3], nx;
-    
-    dims[0] = (size_t)(sz[0] + 2*GUIDE);
-    dims[1] = (size_t)(sz[1] + 2*GUIDE);
-    dims[2] = (size_t)(sz[2] + 2*GUIDE);
-    
-    nx = dims[0] * dims[1] * dims[2];
-    T* var = new T[nx];
+    size_t nx = Size_S3D(sz);
+    T* var = czAllocAligned(nx, type);
+    if ( !var ) return NULL;
     
 #ifndef __NEC__
 #pragma omp parallel for schedule(static)
@@ -238,7 +538,8 @@ public:
     if ( !sz ) return NULL;
     
     size_t nx = sz;
-    T* var = new T[nx];
+    T* var = czAllocAligned(nx, type);
+    if ( !var ) return NULL;
     
 #ifndef __NEC__
 #pragma omp parallel for schedule(static)
@@ -251,12 +552,22 @@ public:
     return var;
   }
   
+  // #################################################################
+  // 先頭を CZ_ALIGN バイトに揃えた確保 czDelete()で解放
+  template <typename T>
+  T* czAllocAligned(const size_t nx, T type)
+  {
+    void* ptr = NULL;
+    if ( posix_memalign(&ptr, CZ_ALIGN, nx*sizeof(T)) != 0 ) return NULL;
+    return (T*)ptr;
+  }
+  
   // #################################################################
   template <typename T>
   void czDelete(T* ptr)
   {
     if (ptr) {
-      delete [] ptr;
+      free(ptr);
       ptr = NULL;
     }
   }
@@ -379,7 +690,11 @@ private:
 
 
   bool Comm_S(REAL_TYPE* sa, const int gc, const string label="");
+  bool Comm_S_begin(REAL_TYPE* sa, const int gc, const string label="");
+  bool Comm_S_end(REAL_TYPE* sa, const int gc, const string label="");
+  bool Comm_S_mg(REAL_TYPE* sa, const int lv, const int gc, const string label="");
   bool Comm_V(REAL_TYPE* va, const int gc, const string label="");
+  bool Comm_S_batch(REAL_TYPE* sa, const int nr, const int gc, const string label="");
   
   bool Comm_SUM_1(int* var, const string label="");
   bool Comm_SUM_1(double* var, const string label="");
@@ -391,6 +706,10 @@ private:
   bool Comm_MAX_1(float*  var, const string label="");
   bool Comm_SUM_2(double* var1, double* var2, const string label="");
   bool Comm_SUM_2(float*  var1, float*  var2, const string label="");
+  bool Comm_SUM_N_begin(double* var, const int n, const string label="");
+  bool Comm_SUM_N_end(double* var, const int n, const string label="");
+  bool Comm_Res(double& res, const int itr, int& itr_res, const string label="");
+  bool Comm_Res_flush(double& res, const string label="");
 
   bool displayMemoryInfo(FILE* fp, double& G_mem, double L_mem, const char* str);
 
@@ -398,6 +717,42 @@ private:
   // 計算する内点のインデクス範囲と点数
   double range_inner_index();
 
+  // ソルバに応じた領域分割モード
+  int getDivisionMode();
+
+  bool isSOR(const int s_type);
+
+  // 2色オーダリングのラインリスト
+  bool setRBLine(double& L_mem);
+
+  // K方向に分割されたラインソルバの縮約系
+  bool setPCRdist(double& L_mem);
+
+  // 通信と計算のオーバーラップ用の中心部と境界部の分割
+  int split_inner_index(int* core, int shell[][6], bool line=false);
+
+  int getTBdepth(int* ex, bool extend);
+
+  bool setTBbuffer(double& L_mem);
+
+  bool setMGlevel(double& L_mem);
+
+  bool setCheby(double& L_mem);
+
+  bool setChebyBound();
+
+  bool setCAbasis(double& L_mem);
+
+  bool setGMRES(double& L_mem);
+
+  bool setWarmStart(double& L_mem);
+
+  bool setBatch(double& L_mem);
+
+  bool setColorSplit(double& L_mem);
+
+  bool setMCSOR(double& L_mem);
+
 
   int JACOBI(double& res,
              REAL_TYPE* X,
@@ -423,12 +778,122 @@ private:
              int s_type,
              bool converge_check=true);
 
+  int MCSOR (double& res,
+             REAL_TYPE* X,
+             REAL_TYPE* B,
+             const int itrMax,
+             double& flop,
+             bool converge_check=true);
+
+  int RBSOR_split(double& res,
+                  REAL_TYPE* X,
+                  REAL_TYPE* B,
+                  const int itrMax,
+                  double& flop,
+                  bool converge_check=true);
+
   int PBiCGSTAB(double& res,
                 REAL_TYPE* X,
                 REAL_TYPE* B,
                 double& flop,
                 int s_type);
 
+  int PCG(double& res,
+          REAL_TYPE* X,
+          REAL_TYPE* B,
+          double& flop);
+
+  int PipeBiCGSTAB(double& res,
+                   REAL_TYPE* X,
+                   REAL_TYPE* B,
+                   double& flop,
+                   int s_type);
+
+  int MG(double& res,
+         REAL_TYPE* X,
+         REAL_TYPE* B,
+         const int itr_max,
+         double& flop,
+         int s_type,
+         bool converge_check=true);
+
+  void MG_cycle(const int lv,
+                REAL_TYPE* X,
+                REAL_TYPE* B,
+                const int gamma,
+                double& flop);
+
+  void MG_smooth(const int lv,
+                 REAL_TYPE* X,
+                 REAL_TYPE* B,
+                 const int nu,
+                 double& flop);
+
+  int CHEBY(double& res,
+            REAL_TYPE* X,
+            REAL_TYPE* B,
+            const int itr_max,
+            double& flop,
+            bool converge_check=true);
+
+  int IR(double& res,
+         REAL_TYPE* X,
+         REAL_TYPE* B,
+         double& flop);
+
+  int CA_BiCGSTAB(double& res,
+                  REAL_TYPE* X,
+                  REAL_TYPE* B,
+                  double& flop);
+
+  int FGMRES(double& res,
+             REAL_TYPE* X,
+             REAL_TYPE* B,
+             double& flop);
+
+  int SolveLS(double& res,
+              REAL_TYPE* X,
+              REAL_TYPE* B,
+              double& flop);
+
+  int RBSOR_batch(double* res,
+                  REAL_TYPE* X,
+                  REAL_TYPE* B,
+                  const int nr,
+                  const int itr_max,
+                  double& flop,
+                  bool converge_check=true);
+
+  int PBiCGSTAB_batch(double* res,
+                      REAL_TYPE* X,
+                      REAL_TYPE* B,
+                      const int nr,
+                      double& flop);
+
+  void Preconditioner_batch(REAL_TYPE* xx,
+                            REAL_TYPE* bb,
+                            const int nr,
+                            double& flop);
+
+  int SOR_auto(double& res,
+               REAL_TYPE* X,
+               REAL_TYPE* B,
+               double& flop);
+
+  int Relax(double& res,
+            REAL_TYPE* X,
+            REAL_TYPE* B,
+            const int itr_max,
+            double& flop);
+
+  bool PCR_RB_dist(REAL_TYPE* X,
+                   REAL_TYPE* B,
+                   int pn,
+                   double& res,
+                   double& flop);
+
+  bool PCR_interface(const int nl, double& flop);
+
   int LSOR_PCR(double& res,
                REAL_TYPE* X,
                REAL_TYPE* B,
@@ -484,10 +949,12 @@ private:
   void Preconditioner(REAL_TYPE* xx,
                       REAL_TYPE* bb,
                       double& flop,
-                      int s_type);
+                      int s_type,
+                      const int lc_max=8);
 
   void setStrPre();
   void setLS(char* q, char* fname);
+  bool setPCRfactor(double& L_mem);
 
 
 #ifndef DISABLE_PMLIB
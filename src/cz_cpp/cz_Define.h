@@ -39,6 +39,43 @@
 
 #define GUIDE 2  ///< ガイドセル数
 
+#define CZ_ALIGN 64 ///< 配列の先頭アドレスを揃えるバイト数
+
+#define TB_DEPTH 4  ///< 時間ブロッキングで1ブロックに進める反復数の上限
+
+#define MG_LEVEL_MAX  16 ///< マルチグリッドの最大階層数
+#define MG_NU1         2 ///< マルチグリッドの前平滑化回数
+#define MG_NU2         2 ///< マルチグリッドの後平滑化回数
+#define MG_COARSE_ITR 20 ///< マルチグリッドの最粗格子での反復回数
+
+#define CHEBY_LANCZOS 30   ///< Chebyshev反復の固有値推定に使うLanczos法の反復数
+#define CHEBY_SAFE    1.05 ///< 最大固有値の推定値に掛ける安全係数
+
+#define RES_LAG_MAX   8    ///< 収束判定の遅延反復数の上限
+
+#define OMEGA_CHUNK   10   ///< ac1=auto で収束率を測る反復区間
+#define OMEGA_MARGIN  1.05 ///< 収束率が omega-1 をこの比以上上回れば omega を更新
+#define OMEGA_BACKOFF 0.9  ///< 収束しない場合に omega-1 に掛ける縮小率
+
+#define IR_INNER_ITR  32     ///< 反復改良の内側反復（定常法）の反復数
+#define IR_INNER_EPS  1.0e-3 ///< 反復改良の内側反復（Krylov法）の相対収束判定値
+
+#define CA_S_MAX      8      ///< s-step BiCGSTABの1回の集団通信で進める反復数の上限
+#define CA_CANCEL_TOL 1.0e-4 ///< s-step BiCGSTABの基底の線形結合の丸め誤差の許容値
+
+#define GMRES_M_MAX     100    ///< FGMRES(m)のリスタート長の上限
+#define GMRES_INNER_EPS 1.0e-1 ///< FGMRESの前処理をKrylov法で解く場合の相対収束判定値
+
+#define WARM_K_MAX    8      ///< 初期値の推定に使う過去の解の本数の上限
+#define WARM_DROP_TOL 1.0e-6 ///< 初期値の射影で線形従属とみなす基底の比
+
+#define BATCH_MAX     8      ///< 一括求解するRHSの本数の上限
+
+#define PCR_LANES_MAX 16     ///< pcr_rbで同時に解くライン数の上限
+#define PCR_HYB_STAGE 3      ///< PCR-Thomas法のPCRの段数 2**段数 本の部分系に分ける
+
+#define MC_STRIP      8      ///< 多色SORのK方向の区間長（SIMD幅） cz_fparam.fi の MC_W と同じ値
+
 #define DETAIL      2
 
 #ifdef _OPENMP
@@ -85,7 +122,25 @@ enum LinearSolver
   LS_PCR_EDA_MAF,
   LS_PCR_ESA_MAF, // 16
   LS_PCR_RB_MAF,
-  LS_PCR_RB_ESA_MAF
+  LS_PCR_RB_ESA_MAF,
+  LS_JACOBI_OVL,
+  LS_PSOR_OVL, // 21
+  LS_PCR_OVL,
+  LS_PIPEBICGSTAB,
+  LS_PIPEBICGSTAB_MAF, // 25
+  LS_JACOBI_TB,
+  LS_SOR2SMA_TB,
+  LS_MG,
+  LS_MG_W,
+  LS_PCG, // 30
+  LS_SSOR,
+  LS_SOR2SMA_SYM,
+  LS_CHEBY,
+  LS_IR,
+  LS_CA_BICGSTAB,
+  LS_FGMRES,
+  LS_PCR_RB_HYB,
+  LS_MCSOR
 };
 
 
@@ -18,7 +18,97 @@
 */
 
 
+// #################################################################
+/**
+ * @brief コマンドラインで指定された問題を解く
+ * @param [in] argc  引数の数
+ * @param [in] argv  引数
+ * @retval 1-正常終了，0-エラー
+ * @note Setup() の後に Solve() を ws_steps 回呼び，Post() で集計する
+ */
 int CZ::Evaluate(int argc, char **argv)
+{
+  int gc = GUIDE;
+
+  if ( !Setup(argc, argv) ) return 0;
+
+  /////////////////////////////////////////////////////////////
+  // Loop
+
+  double res=0.0;
+  int itr=0;
+  int itr_sum=0;
+  double flop=0.0; // dummy
+
+
+  PUSH_RANGE("main loop",6);
+  for (int step=1; step<=ws_steps; step++)
+  {
+    // 時間発展を模してソース項の振幅と位置を変える 最終ステップはソース項ゼロで元の問題に戻る
+    if ( ws_steps > 1 )
+    {
+      REAL_TYPE t  = (REAL_TYPE)step / (REAL_TYPE)ws_steps;
+      REAL_TYPE c  = 100.0 * sin(M_PI * t);
+      REAL_TYPE w  = 0.1;
+      REAL_TYPE xs[3] = {(REAL_TYPE)(0.3 + 0.4*t), 0.5, (REAL_TYPE)(0.3 + 0.4*t)};
+
+      TIMING_start("Blas_Copy");
+      blas_copy_(RHS, ws_b, size, &gc);
+      TIMING_stop("Blas_Copy");
+
+      warm_source_(RHS, size, innerFidx, &gc, pitch, origin, &c, xs, &w);
+
+      if ( !Comm_S(RHS, 1) ) return 0;
+
+      TIMING_start("Warm_Start");
+      flop = 0.0;
+      if ( !InitialGuess(P, RHS, flop) ) return 0;
+      TIMING_stop("Warm_Start", flop);
+    }
+
+    flop = 0.0;
+    if ( bt_n > 1 )
+    {
+      TIMING_start("Batch_Solve");
+      if ( 0 == (itr=SolveBatch(bt_res, bt_x, bt_b, bt_n, flop)) ) return 0;
+      TIMING_stop("Batch_Solve", flop);
+      res = bt_res[0];
+    }
+    else if ( 0 == (itr=Solve(res, P, RHS, flop)) ) return 0;
+
+    storeSolution(P);
+    itr_sum += itr;
+
+    if ( ws_steps > 1 ) Hostonly_ printf("\tStep = %4d : Iter = %6d  Res = %e\n", step, itr, res);
+  }
+  POP_RANGE;
+  
+
+  Hostonly_ {
+    printf("\n=================================\n");
+    printf("Iter = %d  Res = %e\n", itr, res);
+    if ( ws_steps > 1 ) printf("Total Iter = %d in %d steps\n", itr_sum, ws_steps);
+    for (int m=1; m<bt_n; m++) printf("RHS %d : Res = %e\n", m, bt_res[m]);
+    printf("=================================\n");
+  }
+
+
+  return Post();
+}
+
+
+
+// #################################################################
+/**
+ * @brief 求解の準備
+ * @param [in] argc  引数の数
+ * @param [in] argv  引数
+ * @retval 1-正常終了，0-エラー
+ * @note 領域分割，配列の確保，ラインソルバの係数と計量の前計算，境界条件の設定までを行う
+ *       以降は Solve() を繰り返し呼んでも確保や前計算は発生しない
+ *       確保した配列はデストラクタで解放する
+ */
+int CZ::Setup(int argc, char **argv)
 {
   int div_type = 0;         ///< 分割指定 (0-自動、1-指定)
   double G_Memory = 0.0;    ///< 計算に必要なメモリ量（グローバル）
@@ -60,7 +150,10 @@ int CZ::Evaluate(int argc, char **argv)
   // pbicgstab preconditoner
   char* q = argv[4];
 
-  if ( !strcasecmp(q, "pbicgstab") || !strcasecmp(q, "pbicgstab_maf") )
+  if ( !strcasecmp(q, "pbicgstab")    || !strcasecmp(q, "pbicgstab_maf") ||
+       !strcasecmp(q, "pipebicgstab") || !strcasecmp(q, "pipebicgstab_maf") ||
+       !strcasecmp(q, "pcg")          || !strcasecmp(q, "ir") ||
+       !strcasecmp(q, "fgmres") )
     {
       if (argc!=8 && argc!=11) {
         Hostonly_ printf("command line error : pbicgstab\n");
@@ -98,6 +191,152 @@ int CZ::Evaluate(int argc, char **argv)
   // 係数
   ac1 = atof(argv[6]);
 
+  // 収束判定値
+  char* c_eps = std::getenv("CZ_EPS");
+  if ( c_eps != NULL ) eps = atof(c_eps);
+
+  // 収束判定の遅延反復数 定常法の残差のAllreduceを後続の反復と重ねる
+  char* c_lag = std::getenv("CZ_RES_LAG");
+  if ( c_lag != NULL ) {
+    res_lag = atoi(c_lag);
+    if ( res_lag < 0 ) res_lag = 0;
+    if ( res_lag > RES_LAG_MAX ) res_lag = RES_LAG_MAX;
+  }
+
+  // 線形ソルバ 領域分割の方法を決めるので先に設定する
+  char fname[20];
+  memset(fname, 0, sizeof(char)*20);
+
+  setLS(q, fname);
+
+  // s-step BiCGSTABの反復数 s，基底，残差の再計算間隔
+  if (ls_type == LS_CA_BICGSTAB)
+  {
+    char* c_s = std::getenv("CZ_CA_S");
+    if ( c_s != NULL ) {
+      ca_s = atoi(c_s);
+      if ( ca_s < 1 ) ca_s = 1;
+      if ( ca_s > CA_S_MAX ) ca_s = CA_S_MAX;
+    }
+    char* c_b = std::getenv("CZ_CA_BASIS");
+    if ( c_b != NULL && !strcasecmp(c_b, "monomial") ) ca_basis = 0;
+    char* c_rr = std::getenv("CZ_CA_RR");
+    if ( c_rr != NULL ) {
+      ca_rr = atoi(c_rr);
+      if ( ca_rr < 0 ) ca_rr = 0;
+    }
+  }
+
+  // FGMRESのリスタート長
+  if (ls_type == LS_FGMRES)
+  {
+    char* c_m = std::getenv("CZ_GMRES_M");
+    if ( c_m != NULL ) {
+      gm_m = atoi(c_m);
+      if ( gm_m < 1 ) gm_m = 1;
+      if ( gm_m > GMRES_M_MAX ) gm_m = GMRES_M_MAX;
+    }
+  }
+
+  // 繰り返し求解の回数と初期値の推定方法，過去の解の本数
+  char* c_steps = std::getenv("CZ_STEPS");
+  if ( c_steps != NULL ) {
+    ws_steps = atoi(c_steps);
+    if ( ws_steps < 1 ) ws_steps = 1;
+  }
+  char* c_warm = std::getenv("CZ_WARM");
+  if ( c_warm != NULL ) {
+    if      ( !strcasecmp(c_warm, "extrap") ) ws_type = 1;
+    else if ( !strcasecmp(c_warm, "proj") )   ws_type = 2;
+    else                                      ws_type = 0;
+  }
+  char* c_wk = std::getenv("CZ_WARM_K");
+  if ( c_wk != NULL ) {
+    ws_k = atoi(c_wk);
+    if ( ws_k < 1 ) ws_k = 1;
+    if ( ws_k > WARM_K_MAX ) ws_k = WARM_K_MAX;
+  }
+
+  // 一括求解するRHSの本数
+  char* c_bt = std::getenv("CZ_BATCH");
+  if ( c_bt != NULL ) {
+    bt_n = atoi(c_bt);
+    if ( bt_n < 1 ) bt_n = 1;
+    if ( bt_n > BATCH_MAX ) bt_n = BATCH_MAX;
+  }
+  if ( bt_n > 1 )
+  {
+    if ( !(ls_type == LS_SOR2SMA ||
+           (ls_type == LS_BICGSTAB && (pc_type == LS_SOR2SMA || pc_type == 0))) )
+    {
+      Hostonly_ printf("\tCZ_BATCH is available only for sor2sma and pbicgstab with sor2sma or no preconditioner.\n");
+      return 0;
+    }
+  }
+
+  // 多色SORの色数
+  char* c_nc = std::getenv("CZ_MC_COLORS");
+  if ( c_nc != NULL ) {
+    mc_nc = ( atoi(c_nc) == 8 ) ? 8 : 4;
+  }
+
+  // sor2smaの配列を色毎に分ける
+  char* c_lay = std::getenv("CZ_SOR_LAYOUT");
+  if ( c_lay != NULL && !strcasecmp(c_lay, "split") )
+  {
+    if ( ls_type != LS_SOR2SMA && pc_type != LS_SOR2SMA )
+    {
+      Hostonly_ printf("\tCZ_SOR_LAYOUT=split is available only for sor2sma.\n");
+      return 0;
+    }
+    SW_split = 1;
+  }
+
+  // S3D配列のK, I方向のパディング auto または K方向,I方向の要素数
+  int pad_mode = 0, pad_k = 0, pad_i = 0;
+  char* c_pad = std::getenv("CZ_PAD");
+  if ( c_pad != NULL )
+  {
+    if ( !strcasecmp(c_pad, "auto") )
+    {
+      pad_mode = 1;
+    }
+    else if ( sscanf(c_pad, "%d,%d", &pad_k, &pad_i) == 2 )
+    {
+      pad_mode = 2;
+    }
+  }
+
+  // pcr_rbで同時に解くライン数 8 or 16，それ以外は1ライン毎
+  char* c_ln = std::getenv("CZ_PCR_LANES");
+  if ( c_ln != NULL ) {
+    pcr_lanes = atoi(c_ln);
+    if ( pcr_lanes != 8 && pcr_lanes != PCR_LANES_MAX ) pcr_lanes = 0;
+  }
+
+  // MAFの計量は既定で配列に前計算，CZ_MAF_METRIC=recompute で格子点毎に再計算
+  if (SW_maf == 1)
+  {
+    SW_mtr = 1;
+    char* c_mtr = std::getenv("CZ_MAF_METRIC");
+    if ( c_mtr != NULL && !strcasecmp(c_mtr, "recompute") ) SW_mtr = 0;
+  }
+
+  // 加速係数 autoの場合は収束率から推定
+  if ( !strcasecmp(argv[6], "auto") )
+  {
+    if ( !isSOR(ls_type) ) {
+      Hostonly_ printf("\tac1=auto is available only for SOR type solvers.\n");
+      return 0;
+    }
+    if ( bt_n > 1 ) {
+      Hostonly_ printf("\tac1=auto is not available with CZ_BATCH.\n");
+      return 0;
+    }
+    SW_omg = 1;
+  }
+
+
   // 領域分割
 
   if ( numProc > 1 )
@@ -116,8 +355,8 @@ int CZ::Evaluate(int argc, char **argv)
       if ( !D.setDivision(G_div) ) return 0;
     }
 
-    // 引数 0 は3次元分割
-    if ( !D.findOptimalDivision(0) ) return 0;
+    // 0-IJK分割, 1-IJ分割（ラインソルバはK方向を分割しない）
+    if ( !D.findOptimalDivision(getDivisionMode()) ) return 0;
 
     if ( !D.createRankTable() ) return 0;
 
@@ -177,6 +416,15 @@ int CZ::Evaluate(int argc, char **argv)
   }
 
 
+  // BrickCommの袖通信はパディングのない配列を前提とするので，並列時は使わない
+  if ( pad_mode != 0 && numProc > 1 )
+  {
+    Hostonly_ printf("\tCZ_PAD is ignored in parallel run.\n");
+    pad_mode = 0;
+  }
+  cz_layout_set_(&pad_mode, &pad_k, &pad_i);
+
+
   // 通信量 双方向 x ２面
   comm_size = (double)( (size[0]+2*GUIDE) * (size[1]+2*GUIDE)
                       + (size[1]+2*GUIDE) * (size[2]+2*GUIDE)
@@ -184,18 +432,57 @@ int CZ::Evaluate(int argc, char **argv)
                       * 2.0 * 2.0 * sizeof(REAL_TYPE);
 
 
-  // 線形ソルバ
-  char fname[20];
-  memset(fname, 0, sizeof(char)*20);
-
-  setLS(q, fname);
-  
-
   printf("Iterative Mehtod = %s\n", printMethod(ls_type).c_str() );
-  if (ls_type==LS_BICGSTAB || ls_type==LS_BICGSTAB_MAF)
+  if (ls_type==LS_BICGSTAB     || ls_type==LS_BICGSTAB_MAF ||
+      ls_type==LS_PIPEBICGSTAB || ls_type==LS_PIPEBICGSTAB_MAF ||
+      ls_type==LS_PCG          || ls_type==LS_FGMRES)
   {
     printf("Preconditioner = %s\n", printMethod(pc_type).c_str() );
   }
+  if (ls_type==LS_IR)
+  {
+    printf("Inner solver = %s\n", printMethod(pc_type).c_str() );
+  }
+  if (ls_type==LS_CA_BICGSTAB)
+  {
+    printf("s-step = %d, basis = %s, residual replacement = %d\n",
+           ca_s, (ca_basis == 1) ? "newton" : "monomial", ca_rr);
+  }
+  if (ls_type==LS_FGMRES)
+  {
+    printf("Restart = %d\n", gm_m);
+  }
+  if (ws_steps > 1)
+  {
+    const char* ws_str[3] = {"zero", "extrap", "proj"};
+    printf("Steps = %d, initial guess = %s, K = %d\n", ws_steps, ws_str[ws_type], ws_k);
+  }
+  if (bt_n > 1)
+  {
+    printf("Batch = %d\n", bt_n);
+  }
+  if (SW_split == 1)
+  {
+    printf("SOR layout = split\n");
+  }
+  if (pad_mode != 0)
+  {
+    int ext[3];
+    Size_S3D(size, ext);
+    printf("Padded extent (K, I, J) = %d %d %d\n", ext[0], ext[1], ext[2]);
+  }
+  if (ls_type == LS_MCSOR || pc_type == LS_MCSOR)
+  {
+    printf("Colors = %d, strip = %d\n", mc_nc, MC_STRIP);
+  }
+  if (pcr_lanes > 0 && (ls_type == LS_PCR_RB || pc_type == LS_PCR_RB))
+  {
+    printf("PCR lanes = %d\n", pcr_lanes);
+  }
+  if (SW_maf == 1)
+  {
+    Hostonly_ printf("MAF metric = %s\n", (SW_mtr == 1) ? "array" : "recompute");
+  }
 
 
 
@@ -226,7 +513,7 @@ int CZ::Evaluate(int argc, char **argv)
   
 
   // 配列のアロケート
-  double array_size = (size[0]+2*GUIDE) * (size[1]+2*GUIDE) * (size[2]+2*GUIDE);
+  double array_size = (double)Size_S3D(size);
 
   L_Memory += ( array_size * 3 ) * (double)sizeof(REAL_TYPE);
 
@@ -247,6 +534,14 @@ int CZ::Evaluate(int argc, char **argv)
   if( (yc = czAllocR(size[1]+2*GUIDE, var_type)) == NULL ) return 0;
   if( (zc = czAllocR(size[2]+2*GUIDE, var_type)) == NULL ) return 0;
   
+  if (SW_mtr == 1)
+  {
+    if( (mtx = czAllocR(3*(size[0]+2*GUIDE), var_type)) == NULL ) return 0;
+    if( (mty = czAllocR(3*(size[1]+2*GUIDE), var_type)) == NULL ) return 0;
+    if( (mtz = czAllocR(3*(size[2]+2*GUIDE), var_type)) == NULL ) return 0;
+    L_Memory += (double)( 3*(size[0]+size[1]+size[2]+6*GUIDE) ) * (double)sizeof(REAL_TYPE);
+  }
+  
   
   if (SW_maf == 1 )
   {
@@ -272,7 +567,9 @@ int CZ::Evaluate(int argc, char **argv)
   //check_align(RHS, "rhs");
 
 
-  if (ls_type == LS_BICGSTAB || ls_type == LS_BICGSTAB_MAF)
+  if (ls_type == LS_BICGSTAB     || ls_type == LS_BICGSTAB_MAF ||
+      ls_type == LS_PIPEBICGSTAB || ls_type == LS_PIPEBICGSTAB_MAF ||
+      ((ls_type == LS_IR || ls_type == LS_FGMRES) && pc_type == LS_BICGSTAB) )
   {
     L_Memory += ( array_size * 9 ) * (double)sizeof(REAL_TYPE);
 
@@ -287,6 +584,39 @@ int CZ::Evaluate(int argc, char **argv)
     if( (pcg_t_ = czAllocR_S3D(size,var_type)) == NULL ) return 0;
   }
   
+  if (ls_type == LS_PIPEBICGSTAB || ls_type == LS_PIPEBICGSTAB_MAF)
+  {
+    L_Memory += ( array_size * 8 ) * (double)sizeof(REAL_TYPE);
+    
+    if( (pcg_r_ = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_q_ = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_w  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_w_ = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_y  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_z  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_z_ = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_v  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+  }
+  
+  if (ls_type == LS_PCG)
+  {
+    L_Memory += ( array_size * 4 ) * (double)sizeof(REAL_TYPE);
+    
+    if( (pcg_r  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_z  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_p  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (pcg_q  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+  }
+  
+  if (ls_type == LS_IR)
+  {
+    L_Memory += ( array_size * 3 ) * (double)sizeof(REAL_TYPE);
+    
+    if( (ir_xl = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (ir_r  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+    if( (ir_d  = czAllocR_S3D(size,var_type)) == NULL ) return 0;
+  }
+  
   // PCR用の配列確保
   if ( SW_esa == 1 )
   {
@@ -311,6 +641,42 @@ int CZ::Evaluate(int argc, char **argv)
     if( (SD = czAllocR(kk, var_type)) == NULL ) return 0;
     L_Memory += ( kk * 3 ) * (double)sizeof(REAL_TYPE);
   }
+  
+  // PCR係数のキャッシュ
+  if ( !setPCRfactor(L_Memory) ) return 0;
+  
+  // 2色オーダリングのラインリスト
+  if ( !setRBLine(L_Memory) ) return 0;
+  
+  // K方向に分割されたラインソルバの縮約系
+  if ( !setPCRdist(L_Memory) ) return 0;
+  
+  // 時間ブロッキングのバッファ
+  if ( !setTBbuffer(L_Memory) ) return 0;
+
+  // マルチグリッドの階層
+  if ( !setMGlevel(L_Memory) ) return 0;
+
+  // Chebyshev反復の作業配列
+  if ( !setCheby(L_Memory) ) return 0;
+
+  // s-step BiCGSTABの基底
+  if ( !setCAbasis(L_Memory) ) return 0;
+
+  // FGMRESの基底
+  if ( !setGMRES(L_Memory) ) return 0;
+
+  // 繰り返し求解の過去の解
+  if ( !setWarmStart(L_Memory) ) return 0;
+
+  // 一括求解のRHSと作業配列
+  if ( !setBatch(L_Memory) ) return 0;
+
+  // 色毎に分けたsor2smaの配列
+  if ( !setColorSplit(L_Memory) ) return 0;
+
+  // 多色SORの区間ブロックの逆行列
+  if ( !setMCSOR(L_Memory) ) return 0;
 
   POP_RANGE; // nVIdiaTools
   
@@ -364,6 +730,12 @@ int CZ::Evaluate(int argc, char **argv)
   
   POP_RANGE;  // nVidiaTools
   
+  // MAFの計量係数
+  if (SW_mtr == 1)
+  {
+    maf_metric_(size, xc, yc, zc, mtx, mty, mtz);
+  }
+  
   // 行の最大値の逆数
   PUSH_RANGE("search_pivot", 3);
   search_pivot_(pvt, size, innerFidx, &gc, xc, yc, zc);
@@ -385,6 +757,22 @@ int CZ::Evaluate(int argc, char **argv)
   
   if ( !Comm_S(RHS, 1) ) return 0;
   
+  if ( ws_steps > 1 ) blas_copy_(ws_b, RHS, size, &gc);
+  
+  // 一括求解の[1]以降は同じ境界条件で，位置の異なるソース項を加えたRHSとする
+  for (int m=1; m<bt_n; m++)
+  {
+    REAL_TYPE c  = 100.0;
+    REAL_TYPE w  = 0.1;
+    REAL_TYPE xs[3] = {(REAL_TYPE)(0.2 + 0.6*m/bt_n), 0.5, 0.5};
+
+    blas_copy_(bt_x[m], P, size, &gc);
+    blas_copy_(bt_b[m], RHS, size, &gc);
+    warm_source_(bt_b[m], size, innerFidx, &gc, pitch, origin, &c, xs, &w);
+
+    if ( !Comm_S(bt_b[m], 1) ) return 0;
+  }
+  
   
   PUSH_RANGE("imask_k", 5);
   imask_k_(MSK, size, innerFidx, &gc);
@@ -401,106 +789,29 @@ int CZ::Evaluate(int argc, char **argv)
   set_timing_label();
 #endif
 
+  // Chebyshev反復の固有値の範囲
+  if ( !setChebyBound() ) return 0;
 
+  return 1;
+}
 
-  /////////////////////////////////////////////////////////////
-  // Loop
-
-  double res=0.0;
-  int itr=0;
-  double flop=0.0; // dummy
-
-
-  PUSH_RANGE("main loop",6);
-  switch (ls_type)
-  {
-    case LS_JACOBI:
-    case LS_JACOBI_MAF:
-      TIMING_start("JACOBI");
-      if ( 0 == (itr=JACOBI(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("JACOBI", flop);
-      break;
-
-    case LS_PSOR:
-    case LS_PSOR_MAF:
-      TIMING_start("PSOR");
-      if ( 0 == (itr=PSOR(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("PSOR", flop);
-      break;
-
-    case LS_SOR2SMA:
-    case LS_SOR2SMA_MAF:
-      TIMING_start("SOR2SMA");
-      if ( 0 == (itr=RBSOR(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("SOR2SMA", flop);
-      break;
-
-    case LS_BICGSTAB:
-    case LS_BICGSTAB_MAF:
-      TIMING_start("PBiCGSTAB");
-      if ( 0 == (itr=PBiCGSTAB(res, P, RHS, flop, ls_type)) ) return 0;
-      TIMING_stop("PBiCGSTAB", flop);
-      break;
-
-    case LS_PCR:
-    case LS_PCR_MAF:
-      TIMING_start("LSOR");
-      if ( 0 == (itr=LSOR_PCR(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("LSOR", flop);
-      break;
-    
-    case LS_PCR_EDA:
-    case LS_PCR_EDA_MAF:
-    TIMING_start("LSOR");
-    if ( 0 == (itr=LSOR_PCR_EDA(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-    TIMING_stop("LSOR", flop);
-    break;
-    
-    case LS_PCR_ESA:
-    case LS_PCR_ESA_MAF:
-    TIMING_start("LSOR");
-    if ( 0 == (itr=LSOR_PCR_ESA(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-    TIMING_stop("LSOR", flop);
-    break;
-      
-    case LS_PCR_RB:
-    case LS_PCR_RB_MAF:
-      TIMING_start("LSOR");
-      if ( 0 == (itr=LSOR_PCR_RB(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("LSOR", flop);
-      break;
-      
-    case LS_PCR_RB_ESA:
-    case LS_PCR_RB_ESA_MAF:
-      TIMING_start("LSOR");
-      if ( 0 == (itr=LSOR_PCR_RB_ESA(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("LSOR", flop);
-      break;
-    
-    case LS_PCR_J_ESA:
-      TIMING_start("LSOR");
-      if ( 0 == (itr=LSOR_PCR_J_ESA(res, P, RHS, ItrMax, flop, ls_type)) ) return 0;
-      TIMING_stop("LSOR", flop);
-    break;
-    
-    default:
-      break;
-  }
-  POP_RANGE;
-  
 
-  Hostonly_ {
-    printf("\n=================================\n");
-    printf("Iter = %d  Res = %e\n", itr, res);
-    printf("=================================\n");
-  }
 
+// #################################################################
+/**
+ * @brief 履歴ファイルを閉じ，タイミングと誤差を出力する
+ * @retval 1-正常終了，0-エラー
+ */
+int CZ::Post()
+{
+  int gc = GUIDE;
 
   /////////////////////////////////////////////////////////////
   // post
 
   Hostonly_ {
-    if (!fph) fclose(fph);
+    if (fph) fclose(fph);
+    fph = NULL;
   }
 
 #ifndef DISABLE_PMLIB
@@ -568,6 +879,187 @@ int CZ::Evaluate(int argc, char **argv)
 
 
 
+// #################################################################
+/**
+ * @brief Setup() 済みの状態で1回解く
+ * @param [in,out] res    残差
+ * @param [in,out] X      解ベクトル（初期値，境界条件とガイドセルを含む）
+ * @param [in]     B      RHSベクトル（ガイドセルは同期済み）
+ * @param [in,out] flop   浮動小数点演算数
+ * @param [in]     tol    収束判定値 0以下のときは CZ_EPS の値
+ * @retval 反復数，エラーの場合は0
+ * @note 配列は size[] にガイドセル GUIDE を加えた大きさで，確保は呼び出し側
+ */
+int CZ::Solve(double& res, REAL_TYPE* X, REAL_TYPE* B, double& flop, const double tol)
+{
+  double eps_save = eps;
+  if ( tol > 0.0 ) eps = tol;
+
+  int itr = SolveLS(res, X, B, flop);
+
+  eps = eps_save;
+
+  return itr;
+}
+
+
+// #################################################################
+/**
+ * @brief ls_type の線形ソルバで1回解く
+ * @param [in,out] res    残差
+ * @param [in,out] X      解ベクトル（初期値）
+ * @param [in]     B      RHSベクトル
+ * @param [in,out] flop   浮動小数点演算数
+ * @retval 反復数，エラーの場合は0
+ */
+int CZ::SolveLS(double& res, REAL_TYPE* X, REAL_TYPE* B, double& flop)
+{
+  int itr=0;
+
+  if ( SW_omg == 1 )
+  {
+    TIMING_start("SOR_Auto");
+    if ( 0 == (itr=SOR_auto(res, X, B, flop)) ) return 0;
+    TIMING_stop("SOR_Auto", flop);
+  }
+  else switch (ls_type)
+  {
+    case LS_JACOBI:
+    case LS_JACOBI_MAF:
+    case LS_JACOBI_OVL:
+    case LS_JACOBI_TB:
+      TIMING_start("JACOBI");
+      if ( 0 == (itr=JACOBI(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("JACOBI", flop);
+      break;
+
+    case LS_PSOR:
+    case LS_PSOR_MAF:
+    case LS_PSOR_OVL:
+    case LS_SSOR:
+      TIMING_start("PSOR");
+      if ( 0 == (itr=PSOR(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("PSOR", flop);
+      break;
+
+    case LS_SOR2SMA:
+    case LS_SOR2SMA_MAF:
+    case LS_SOR2SMA_TB:
+    case LS_SOR2SMA_SYM:
+      TIMING_start("SOR2SMA");
+      if ( 0 == (itr=RBSOR(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("SOR2SMA", flop);
+      break;
+
+    case LS_MCSOR:
+      TIMING_start("MCSOR");
+      if ( 0 == (itr=MCSOR(res, X, B, ItrMax, flop)) ) return 0;
+      TIMING_stop("MCSOR", flop);
+      break;
+
+    case LS_MG:
+    case LS_MG_W:
+      TIMING_start("MG");
+      if ( 0 == (itr=MG(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("MG", flop);
+      break;
+
+    case LS_BICGSTAB:
+    case LS_BICGSTAB_MAF:
+      TIMING_start("PBiCGSTAB");
+      if ( 0 == (itr=PBiCGSTAB(res, X, B, flop, ls_type)) ) return 0;
+      TIMING_stop("PBiCGSTAB", flop);
+      break;
+
+    case LS_CHEBY:
+      TIMING_start("CHEBY");
+      if ( 0 == (itr=CHEBY(res, X, B, ItrMax, flop)) ) return 0;
+      TIMING_stop("CHEBY", flop);
+      break;
+
+    case LS_IR:
+      TIMING_start("IR");
+      if ( 0 == (itr=IR(res, X, B, flop)) ) return 0;
+      TIMING_stop("IR", flop);
+      break;
+
+    case LS_PCG:
+      TIMING_start("PCG");
+      if ( 0 == (itr=PCG(res, X, B, flop)) ) return 0;
+      TIMING_stop("PCG", flop);
+      break;
+
+    case LS_PIPEBICGSTAB:
+    case LS_PIPEBICGSTAB_MAF:
+      TIMING_start("PipeBiCGSTAB");
+      if ( 0 == (itr=PipeBiCGSTAB(res, X, B, flop, ls_type)) ) return 0;
+      TIMING_stop("PipeBiCGSTAB", flop);
+      break;
+
+    case LS_CA_BICGSTAB:
+      TIMING_start("CA_BiCGSTAB");
+      if ( 0 == (itr=CA_BiCGSTAB(res, X, B, flop)) ) return 0;
+      TIMING_stop("CA_BiCGSTAB", flop);
+      break;
+
+    case LS_FGMRES:
+      TIMING_start("FGMRES");
+      if ( 0 == (itr=FGMRES(res, X, B, flop)) ) return 0;
+      TIMING_stop("FGMRES", flop);
+      break;
+
+    case LS_PCR:
+    case LS_PCR_MAF:
+    case LS_PCR_OVL:
+      TIMING_start("LSOR");
+      if ( 0 == (itr=LSOR_PCR(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("LSOR", flop);
+      break;
+    
+    case LS_PCR_EDA:
+    case LS_PCR_EDA_MAF:
+    TIMING_start("LSOR");
+    if ( 0 == (itr=LSOR_PCR_EDA(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+    TIMING_stop("LSOR", flop);
+    break;
+    
+    case LS_PCR_ESA:
+    case LS_PCR_ESA_MAF:
+    TIMING_start("LSOR");
+    if ( 0 == (itr=LSOR_PCR_ESA(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+    TIMING_stop("LSOR", flop);
+    break;
+      
+    case LS_PCR_RB:
+    case LS_PCR_RB_MAF:
+    case LS_PCR_RB_HYB:
+      TIMING_start("LSOR");
+      if ( 0 == (itr=LSOR_PCR_RB(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("LSOR", flop);
+      break;
+      
+    case LS_PCR_RB_ESA:
+    case LS_PCR_RB_ESA_MAF:
+      TIMING_start("LSOR");
+      if ( 0 == (itr=LSOR_PCR_RB_ESA(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("LSOR", flop);
+      break;
+    
+    case LS_PCR_J_ESA:
+      TIMING_start("LSOR");
+      if ( 0 == (itr=LSOR_PCR_J_ESA(res, X, B, ItrMax, flop, ls_type)) ) return 0;
+      TIMING_stop("LSOR", flop);
+    break;
+    
+    default:
+      break;
+  }
+
+  return itr;
+}
+
+
+
 void CZ::setStrPre()
 {
   if ( !strcasecmp(precon.c_str(), "jacobi") ) {
@@ -582,8 +1074,12 @@ void CZ::setStrPre()
   else if ( !strcasecmp(precon.c_str(), "pcr_rb") ) {
     pc_type = LS_PCR_RB;
   }
+  else if ( !strcasecmp(precon.c_str(), "pcr_rb_hyb") ) {
+    pc_type = LS_PCR_RB_HYB;
+  }
   else if ( !strcasecmp(precon.c_str(), "pcr_rb_esa") ) {
     pc_type = LS_PCR_RB_ESA;
+    SW_esa = 1;
   }
   else if ( !strcasecmp(precon.c_str(), "pcr_j_esa") ) {
     pc_type = LS_PCR_J_ESA;
@@ -608,6 +1104,7 @@ void CZ::setStrPre()
   }
   else if ( !strcasecmp(precon.c_str(), "pcr_rb_esa_maf") ) {
     pc_type = LS_PCR_RB_ESA_MAF;
+    SW_esa = 1;
   }
   else if ( !strcasecmp(precon.c_str(), "pcr_maf") ) {
     pc_type = LS_PCR_MAF;
@@ -615,6 +1112,42 @@ void CZ::setStrPre()
   else if ( !strcasecmp(precon.c_str(), "pcr_eda_maf") ) {
     pc_type = LS_PCR_EDA_MAF;
   }
+  else if ( !strcasecmp(precon.c_str(), "jacobi_ovl") ) {
+    pc_type = LS_JACOBI_OVL;
+  }
+  else if ( !strcasecmp(precon.c_str(), "psor_ovl") ) {
+    pc_type = LS_PSOR_OVL;
+  }
+  else if ( !strcasecmp(precon.c_str(), "pcr_ovl") ) {
+    pc_type = LS_PCR_OVL;
+  }
+  else if ( !strcasecmp(precon.c_str(), "jacobi_tb") ) {
+    pc_type = LS_JACOBI_TB;
+  }
+  else if ( !strcasecmp(precon.c_str(), "sor2sma_tb") ) {
+    pc_type = LS_SOR2SMA_TB;
+  }
+  else if ( !strcasecmp(precon.c_str(), "mg") ) {
+    pc_type = LS_MG;
+  }
+  else if ( !strcasecmp(precon.c_str(), "mg_w") ) {
+    pc_type = LS_MG_W;
+  }
+  else if ( !strcasecmp(precon.c_str(), "ssor") ) {
+    pc_type = LS_SSOR;
+  }
+  else if ( !strcasecmp(precon.c_str(), "mcsor") ) {
+    pc_type = LS_MCSOR;
+  }
+  else if ( !strcasecmp(precon.c_str(), "sor2sma_sym") ) {
+    pc_type = LS_SOR2SMA_SYM;
+  }
+  else if ( !strcasecmp(precon.c_str(), "cheby") ) {
+    pc_type = LS_CHEBY;
+  }
+  else if ( !strcasecmp(precon.c_str(), "pbicgstab") ) {
+    pc_type = LS_BICGSTAB; // irの内側反復のみ
+  }
   else printf("precon=%s\n", precon.c_str());
 }
 
@@ -645,6 +1178,9 @@ std::string CZ::printMethod(int type)
   else if ( type == LS_PCR_RB ) {
     str = "pcr_rb";
   }
+  else if ( type == LS_PCR_RB_HYB ) {
+    str = "pcr_rb_hyb";
+  }
   else if ( type == LS_PCR_RB_ESA ) {
     str = "pcr_rb_esa";
   }
@@ -675,6 +1211,60 @@ std::string CZ::printMethod(int type)
   else if ( type == LS_PCR_ESA_MAF ) {
     str = "pcr_esa_maf";
   }
+  else if ( type == LS_JACOBI_OVL ) {
+    str = "jacobi_ovl";
+  }
+  else if ( type == LS_PSOR_OVL ) {
+    str = "psor_ovl";
+  }
+  else if ( type == LS_PCR_OVL ) {
+    str = "pcr_ovl";
+  }
+  else if ( type == LS_BICGSTAB ) {
+    str = "pbicgstab";
+  }
+  else if ( type == LS_PIPEBICGSTAB ) {
+    str = "pipebicgstab";
+  }
+  else if ( type == LS_PIPEBICGSTAB_MAF ) {
+    str = "pipebicgstab_maf";
+  }
+  else if ( type == LS_JACOBI_TB ) {
+    str = "jacobi_tb";
+  }
+  else if ( type == LS_SOR2SMA_TB ) {
+    str = "sor2sma_tb";
+  }
+  else if ( type == LS_MG ) {
+    str = "mg";
+  }
+  else if ( type == LS_MG_W ) {
+    str = "mg_w";
+  }
+  else if ( type == LS_PCG ) {
+    str = "pcg";
+  }
+  else if ( type == LS_SSOR ) {
+    str = "ssor";
+  }
+  else if ( type == LS_MCSOR ) {
+    str = "mcsor";
+  }
+  else if ( type == LS_SOR2SMA_SYM ) {
+    str = "sor2sma_sym";
+  }
+  else if ( type == LS_CHEBY ) {
+    str = "cheby";
+  }
+  else if ( type == LS_IR ) {
+    str = "ir";
+  }
+  else if ( type == LS_CA_BICGSTAB ) {
+    str = "ca_bicgstab";
+  }
+  else if ( type == LS_FGMRES ) {
+    str = "fgmres";
+  }
   
   return str;
 }
@@ -698,17 +1288,49 @@ void CZ::setLS(char* q, char* fname)
     strcpy(fname, "sor2sma.txt");
   }
   
+  else if ( !strcasecmp(q, "ssor") ) {
+    ls_type = LS_SSOR;
+    strcpy(fname, "ssor.txt");
+  }
+  
+  else if ( !strcasecmp(q, "mcsor") ) {
+    ls_type = LS_MCSOR;
+    strcpy(fname, "mcsor.txt");
+  }
+  
+  else if ( !strcasecmp(q, "sor2sma_sym") ) {
+    ls_type = LS_SOR2SMA_SYM;
+    strcpy(fname, "sor2sma_sym.txt");
+  }
+  
   else if ( !strcasecmp(q, "pbicgstab") ) {
     ls_type = LS_BICGSTAB;
     strcpy(fname, "pbicgstab.txt");
     setStrPre();
   }
   
+  else if ( !strcasecmp(q, "pcg") ) {
+    ls_type = LS_PCG;
+    strcpy(fname, "pcg.txt");
+    setStrPre();
+  }
+  
+  else if ( !strcasecmp(q, "pipebicgstab") ) {
+    ls_type = LS_PIPEBICGSTAB;
+    strcpy(fname, "pipebicgstab.txt");
+    setStrPre();
+  }
+  
   else if ( !strcasecmp(q, "pcr_rb") ) {
     ls_type = LS_PCR_RB;
     strcpy(fname, "pcr_rb.txt");
   }
   
+  else if ( !strcasecmp(q, "pcr_rb_hyb") ) {
+    ls_type = LS_PCR_RB_HYB;
+    strcpy(fname, "pcr_rb_hyb.txt");
+  }
+  
   else if ( !strcasecmp(q, "pcr_rb_esa") ) {
     ls_type = LS_PCR_RB_ESA;
     strcpy(fname, "pcr_rb_esa.txt");
@@ -764,6 +1386,13 @@ void CZ::setLS(char* q, char* fname)
     SW_maf = 1;
   }
   
+  else if ( !strcasecmp(q, "pipebicgstab_maf") ) {
+    ls_type = LS_PIPEBICGSTAB_MAF;
+    strcpy(fname, "pipebicgstab_maf.txt");
+    setStrPre();
+    SW_maf = 1;
+  }
+  
   else if ( !strcasecmp(q, "pcr_rb_maf") ) {
     ls_type = LS_PCR_RB_MAF;
     strcpy(fname, "pcr_rb_maf.txt");
@@ -796,8 +1425,150 @@ void CZ::setLS(char* q, char* fname)
     SW_esa = 1;
   }
   
+  
+  // 通信と計算のオーバーラップ
+  else if ( !strcasecmp(q, "jacobi_ovl") ) {
+    ls_type = LS_JACOBI_OVL;
+    strcpy(fname, "jacobi_ovl.txt");
+  }
+  
+  else if ( !strcasecmp(q, "psor_ovl") ) {
+    ls_type = LS_PSOR_OVL;
+    strcpy(fname, "psor_ovl.txt");
+  }
+  
+  else if ( !strcasecmp(q, "pcr_ovl") ) {
+    ls_type = LS_PCR_OVL;
+    strcpy(fname, "pcr_ovl.txt");
+  }
+  
+  
+  // 時間ブロッキング
+  else if ( !strcasecmp(q, "jacobi_tb") ) {
+    ls_type = LS_JACOBI_TB;
+    strcpy(fname, "jacobi_tb.txt");
+  }
+  
+  else if ( !strcasecmp(q, "sor2sma_tb") ) {
+    ls_type = LS_SOR2SMA_TB;
+    strcpy(fname, "sor2sma_tb.txt");
+  }
+  
+  
+  // マルチグリッド
+  else if ( !strcasecmp(q, "mg") ) {
+    ls_type = LS_MG;
+    strcpy(fname, "mg.txt");
+  }
+  
+  else if ( !strcasecmp(q, "mg_w") ) {
+    ls_type = LS_MG_W;
+    strcpy(fname, "mg_w.txt");
+  }
+  
+  
+  // Chebyshev反復
+  else if ( !strcasecmp(q, "cheby") ) {
+    ls_type = LS_CHEBY;
+    strcpy(fname, "cheby.txt");
+  }
+  
+  
+  // 混合精度の反復改良
+  else if ( !strcasecmp(q, "ir") ) {
+    ls_type = LS_IR;
+    strcpy(fname, "ir.txt");
+    setStrPre();
+  }
+  
+  
+  // s-step BiCGSTAB
+  else if ( !strcasecmp(q, "ca_bicgstab") ) {
+    ls_type = LS_CA_BICGSTAB;
+    strcpy(fname, "ca_bicgstab.txt");
+  }
+  
+  
+  // 前処理が反復毎に変わってよいFGMRES(m)
+  else if ( !strcasecmp(q, "fgmres") ) {
+    ls_type = LS_FGMRES;
+    strcpy(fname, "fgmres.txt");
+    setStrPre();
+  }
+  
   else {
     printf("Invalid solver\n");
     exit(0);
   }
 }
+
+
+
+// #################################################################
+/**
+ * @brief 定数係数PCRの係数分解をキャッシュ
+ * @param [in,out] L_mem  ローカルのメモリ量
+ * @note 係数 a=c=-1/6 は全ての(i,j)ラインと反復で共通なので，
+ *       各段の e, e*a, e*c と最終段の逆行列を一度だけ計算しておく
+ */
+bool CZ::setPCRfactor(double& L_mem)
+{
+  int t[2] = {ls_type, pc_type};
+  bool flag = false;
+  
+  for (int i=0; i<2; i++)
+  {
+    if ( t[i] == LS_PCR        ||
+         t[i] == LS_PCR_OVL    ||
+         t[i] == LS_PCR_ESA    ||
+         t[i] == LS_PCR_RB     ||
+         t[i] == LS_PCR_RB_HYB ||
+         t[i] == LS_PCR_RB_ESA ||
+         t[i] == LS_PCR_J_ESA ) flag = true;
+  }
+  if ( !flag ) return true;
+  
+  int kst = innerFidx[K_minus];
+  int ked = innerFidx[K_plus];
+  int n = ked - kst + 1;
+  int pn;
+  REAL_TYPE var_type=0;
+  
+  // Nを超える最小の2べき数の乗数 pn
+  if ( -1 == (pn=getNumStage(n))) {
+    printf("error : number of stage\n");
+    exit(0);
+  }
+  
+  // 袖 最終段の参照 k+3*2^(pn-2) < kst+2^pn を含む
+  int sp = pow(2, pn-1);
+  int kk = n + 2*sp;
+  
+  if( (FE = czAllocR(n*pn, var_type)) == NULL ) return false;
+  if( (FA = czAllocR(n*pn, var_type)) == NULL ) return false;
+  if( (FC = czAllocR(n*pn, var_type)) == NULL ) return false;
+  if( (F2 = czAllocR(n*4,  var_type)) == NULL ) return false;
+  if( (F4 = czAllocR(n*16, var_type)) == NULL ) return false;
+  if( (FD = czAllocR(kk,   var_type)) == NULL ) return false;
+  if( (FD1= czAllocR(kk,   var_type)) == NULL ) return false;
+  L_mem += (double)( n*pn*3 + n*20 + kk*2 ) * (double)sizeof(REAL_TYPE);
+  
+  pcr_factorize_(innerFidx, &pn, FE, FA, FC, F2, F4);
+  
+  // PCR-Thomas法 PCRの段数は pn-1 段まで，部分系の長さを揃えて2**q の倍数に切り上げる
+  if ( ls_type == LS_PCR_RB_HYB || pc_type == LS_PCR_RB_HYB )
+  {
+    hyb_q = ( pn-1 < PCR_HYB_STAGE ) ? pn-1 : PCR_HYB_STAGE;
+    int w = 1 << hyb_q;
+    hyb_nt = ( (n + w - 1) / w ) * w;
+    
+    if( (TW = czAllocR(hyb_nt, var_type)) == NULL ) return false;
+    if( (TA = czAllocR(hyb_nt, var_type)) == NULL ) return false;
+    if( (TC = czAllocR(hyb_nt, var_type)) == NULL ) return false;
+    L_mem += (double)( hyb_nt*3 ) * (double)sizeof(REAL_TYPE);
+    
+    pcr_hyb_factorize_(innerFidx, &hyb_q, &hyb_nt, TW, TA, TC);
+  }
+  
+  return true;
+}
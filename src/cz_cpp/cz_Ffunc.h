@@ -15,6 +15,16 @@
 
 extern "C" {
 
+// cz_layout.f90
+
+void cz_layout_set_ (int* mode,
+                     int* pk,
+                     int* pi);
+
+void cz_layout_ext_ (int* sz,
+                     int* g,
+                     int* ext);
+
 // cz_solver.f90
 
 void bc_k_    (int* sz,
@@ -35,6 +45,30 @@ void jacobi_        (REAL_TYPE* p,
                      REAL_TYPE* wk2,
                      double* flop);
 
+void jacobi_sub_    (REAL_TYPE* p,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* omg,
+                     REAL_TYPE* b,
+                     double* res,
+                     REAL_TYPE* wk2,
+                     double* flop);
+
+void jacobi_tb_     (REAL_TYPE* p,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* omg,
+                     REAL_TYPE* b,
+                     double* res,
+                     int* nt,
+                     int* ex,
+                     REAL_TYPE* wb,
+                     double* flop);
+
 void psor_          (REAL_TYPE* p,
                      int* sz,
                      int* idx,
@@ -45,6 +79,16 @@ void psor_          (REAL_TYPE* p,
                      double* res,
                      double* flop);
 
+void psor_bwd_      (REAL_TYPE* p,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* omg,
+                     REAL_TYPE* b,
+                     double* res,
+                     double* flop);
+
 void psor2sma_core_ (REAL_TYPE* p,
                      int* sz,
                      int* idx,
@@ -57,41 +101,199 @@ void psor2sma_core_ (REAL_TYPE* p,
                      double* res,
                      double* flop);
 
+void psor2sma_split_ (REAL_TYPE* pc,
+                      REAL_TYPE* po,
+                      int* sz,
+                      int* idx,
+                      int* g,
+                      int* nh,
+                      REAL_TYPE* cf,
+                      int* ip,
+                      int* color,
+                      REAL_TYPE* omg,
+                      REAL_TYPE* bc,
+                      double* res,
+                      double* flop);
+
+void psor_mc_factorize_ (REAL_TYPE* cf,
+                         REAL_TYPE* ti);
+
+void psor_mc_ (REAL_TYPE* p,
+               int* sz,
+               int* idx,
+               int* g,
+               REAL_TYPE* cf,
+               int* off,
+               int* color,
+               int* nc,
+               REAL_TYPE* ti,
+               REAL_TYPE* omg,
+               REAL_TYPE* b,
+               double* res,
+               double* flop);
+
+void rb_split_pack_ (REAL_TYPE* xr,
+                     REAL_TYPE* xb,
+                     REAL_TYPE* x,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     int* nh,
+                     int* ip);
+
+void rb_split_merge_ (REAL_TYPE* x,
+                      REAL_TYPE* xr,
+                      REAL_TYPE* xb,
+                      int* sz,
+                      int* idx,
+                      int* g,
+                      int* nh,
+                      int* ip);
+
+void rb_split_face_ (REAL_TYPE* xr,
+                     REAL_TYPE* xb,
+                     REAL_TYPE* x,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     int* nh,
+                     int* ip,
+                     int* dir);
+
+void psor2sma_tb_   (REAL_TYPE* p,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     int* ip,
+                     REAL_TYPE* omg,
+                     REAL_TYPE* b,
+                     double* res,
+                     int* nt,
+                     double* flop);
+
+void pcr_factorize_ (int* idx,
+                     int* pn,
+                     REAL_TYPE* fe,
+                     REAL_TYPE* fa,
+                     REAL_TYPE* fc,
+                     REAL_TYPE* f2,
+                     REAL_TYPE* f4);
+
 void pcr_rb_ (int* sz,
               int* idx,
               int* g,
               int* pn,
-              int* ofst,
-              int* color,
+              int* nl,
+              int* lst,
               REAL_TYPE* x,
               REAL_TYPE* msk,
               REAL_TYPE* rhs,
-              REAL_TYPE* WA,
-              REAL_TYPE* WC,
-              REAL_TYPE* WD,
-              REAL_TYPE* WAA,
-              REAL_TYPE* WCC,
-              REAL_TYPE* WDD,
+              REAL_TYPE* fe,
+              REAL_TYPE* fa,
+              REAL_TYPE* fc,
+              REAL_TYPE* f2,
+              REAL_TYPE* d,
+              REAL_TYPE* d1,
               REAL_TYPE* omg,
               double* res,
               double* flop);
 
+void pcr_rb_lanes_ (int* sz,
+                    int* idx,
+                    int* g,
+                    int* pn,
+                    int* nl,
+                    int* lst,
+                    int* nv,
+                    REAL_TYPE* x,
+                    REAL_TYPE* msk,
+                    REAL_TYPE* rhs,
+                    REAL_TYPE* fe,
+                    REAL_TYPE* fa,
+                    REAL_TYPE* fc,
+                    REAL_TYPE* f2,
+                    REAL_TYPE* omg,
+                    double* res,
+                    double* flop);
+
+void pcr_hyb_factorize_ (int* idx,
+                         int* q,
+                         int* nt,
+                         REAL_TYPE* tw,
+                         REAL_TYPE* ta,
+                         REAL_TYPE* tc);
+
+void pcr_rb_hyb_ (int* sz,
+                  int* idx,
+                  int* g,
+                  int* pn,
+                  int* q,
+                  int* nt,
+                  int* nl,
+                  int* lst,
+                  REAL_TYPE* x,
+                  REAL_TYPE* msk,
+                  REAL_TYPE* rhs,
+                  REAL_TYPE* fe,
+                  REAL_TYPE* fa,
+                  REAL_TYPE* fc,
+                  REAL_TYPE* tw,
+                  REAL_TYPE* ta,
+                  REAL_TYPE* tc,
+                  REAL_TYPE* omg,
+                  double* res,
+                  double* flop);
+
+void pcr_rb_y_ (int* sz,
+                int* idx,
+                int* g,
+                int* pn,
+                int* nl,
+                int* lst,
+                REAL_TYPE* x,
+                REAL_TYPE* msk,
+                REAL_TYPE* rhs,
+                REAL_TYPE* fe,
+                REAL_TYPE* fa,
+                REAL_TYPE* fc,
+                REAL_TYPE* f2,
+                int* ex,
+                REAL_TYPE* y,
+                REAL_TYPE* ye,
+                double* flop);
+
+void pcr_rb_relax_ (int* sz,
+                    int* idx,
+                    int* g,
+                    int* nl,
+                    int* lst,
+                    REAL_TYPE* x,
+                    REAL_TYPE* msk,
+                    REAL_TYPE* y,
+                    REAL_TYPE* fu,
+                    REAL_TYPE* fv,
+                    REAL_TYPE* xe,
+                    REAL_TYPE* omg,
+                    double* res,
+                    double* flop);
+
 void pcr_rb_esa_ (int* sz,
                   int* idx,
                   int* g,
                   int* pn,
-                  int* ofst,
-                  int* color,
+                  int* nl,
+                  int* lst,
                   int* s,
                   REAL_TYPE* x,
                   REAL_TYPE* msk,
                   REAL_TYPE* rhs,
-                  REAL_TYPE* WA,
-                  REAL_TYPE* WC,
-                  REAL_TYPE* WD,
-                  REAL_TYPE* WAA,
-                  REAL_TYPE* WCC,
-                  REAL_TYPE* WDD,
+                  REAL_TYPE* fe,
+                  REAL_TYPE* fa,
+                  REAL_TYPE* fc,
+                  REAL_TYPE* f4,
+                  REAL_TYPE* d,
+                  REAL_TYPE* d1,
                   REAL_TYPE* omg,
                   double* res,
                   double* flop);
@@ -103,12 +305,12 @@ void pcr_(int* sz,
           REAL_TYPE* x,
           REAL_TYPE* msk,
           REAL_TYPE* rhs,
-          REAL_TYPE* WA,
-          REAL_TYPE* WC,
-          REAL_TYPE* WD,
-          REAL_TYPE* WAA,
-          REAL_TYPE* WCC,
-          REAL_TYPE* WDD,
+          REAL_TYPE* fe,
+          REAL_TYPE* fa,
+          REAL_TYPE* fc,
+          REAL_TYPE* f4,
+          REAL_TYPE* d,
+          REAL_TYPE* d1,
           REAL_TYPE* omg,
           double* res,
           double* flop);
@@ -135,12 +337,12 @@ void pcr_esa_(int* sz,
               REAL_TYPE* x,
               REAL_TYPE* msk,
               REAL_TYPE* rhs,
-              REAL_TYPE* SA,
-              REAL_TYPE* SC,
-              REAL_TYPE* SD,
-              REAL_TYPE* WA,
-              REAL_TYPE* WC,
-              REAL_TYPE* WD,
+              REAL_TYPE* fe,
+              REAL_TYPE* fa,
+              REAL_TYPE* fc,
+              REAL_TYPE* f4,
+              REAL_TYPE* d,
+              REAL_TYPE* d1,
               REAL_TYPE* omg,
               double* res,
               double* flop);
@@ -153,12 +355,12 @@ void pcr_j_esa_(int* sz,
                 REAL_TYPE* x,
                 REAL_TYPE* msk,
                 REAL_TYPE* rhs,
-                REAL_TYPE* SA,
-                REAL_TYPE* SC,
-                REAL_TYPE* SD,
-                REAL_TYPE* WA,
-                REAL_TYPE* WC,
-                REAL_TYPE* WD,
+                REAL_TYPE* fe,
+                REAL_TYPE* fa,
+                REAL_TYPE* fc,
+                REAL_TYPE* f2,
+                REAL_TYPE* d,
+                REAL_TYPE* d1,
                 REAL_TYPE* SRC,
                 REAL_TYPE* WRK,
                 REAL_TYPE* omg,
@@ -208,12 +410,61 @@ void psor2sma_core_maf_ (REAL_TYPE* p,
                          REAL_TYPE* tmp,
                          double* flop);
     
+void maf_metric_   (int* sz,
+                    REAL_TYPE* X,
+                    REAL_TYPE* Y,
+                    REAL_TYPE* Z,
+                    REAL_TYPE* MX,
+                    REAL_TYPE* MY,
+                    REAL_TYPE* MZ);
+  
+void jacobi_mtr_   (REAL_TYPE* p,
+                    int* sz,
+                    int* idx,
+                    int* g,
+                    REAL_TYPE* MX,
+                    REAL_TYPE* MY,
+                    REAL_TYPE* MZ,
+                    REAL_TYPE* omg,
+                    REAL_TYPE* b,
+                    double* res,
+                    REAL_TYPE* wk2,
+                    REAL_TYPE* tmp,
+                    double* flop);
+    
+void psor_mtr_     (REAL_TYPE* p,
+                    int* sz,
+                    int* idx,
+                    int* g,
+                    REAL_TYPE* MX,
+                    REAL_TYPE* MY,
+                    REAL_TYPE* MZ,
+                    REAL_TYPE* omg,
+                    REAL_TYPE* b,
+                    double* res,
+                    double* flop);
+    
+void psor2sma_core_mtr_ (REAL_TYPE* p,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* MX,
+                         REAL_TYPE* MY,
+                         REAL_TYPE* MZ,
+                         int* ip,
+                         int* color,
+                         REAL_TYPE* omg,
+                         REAL_TYPE* b,
+                         double* res,
+                         REAL_TYPE* tmp,
+                         double* flop);
+    
 void pcr_rb_maf_(int* sz,
                  int* idx,
                  int* g,
                  int* pn,
-                 int* ofst,
-                 int* color,
+                 int* nl,
+                 int* lst,
                  REAL_TYPE* x,
                  REAL_TYPE* msk,
                  REAL_TYPE* rhs,
@@ -235,8 +486,8 @@ void pcr_rb_esa_maf_(int* sz,
                      int* idx,
                      int* g,
                      int* pn,
-                     int* ofst,
-                     int* color,
+                     int* nl,
+                     int* lst,
                      int* s,
                      REAL_TYPE* x,
                      REAL_TYPE* msk,
@@ -459,6 +710,12 @@ void blas_copy_in_   (REAL_TYPE* dst,
                       REAL_TYPE* src,
                       int* sz,
                       int* g);
+
+void blas_copy_idx_  (REAL_TYPE* dst,
+                      REAL_TYPE* src,
+                      int* sz,
+                      int* idx,
+                      int* g);
   
 void blas_triad_    (REAL_TYPE* z,
                      REAL_TYPE* x,
@@ -512,6 +769,72 @@ void blas_calc_ax_  (REAL_TYPE* ap,
                      REAL_TYPE* cf,
                      double* flop);
 
+void blas_bicg_3_   (REAL_TYPE* x,
+                     REAL_TYPE* r,
+                     REAL_TYPE* p_,
+                     REAL_TYPE* s_,
+                     REAL_TYPE* s,
+                     REAL_TYPE* t,
+                     REAL_TYPE* r0,
+                     REAL_TYPE* a,
+                     REAL_TYPE* b,
+                     REAL_TYPE* rr,
+                     REAL_TYPE* rr0,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void blas_cg_1_     (REAL_TYPE* p,
+                     REAL_TYPE* z,
+                     REAL_TYPE* beta,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void blas_cg_2_     (REAL_TYPE* x,
+                     REAL_TYPE* r,
+                     REAL_TYPE* p,
+                     REAL_TYPE* q,
+                     REAL_TYPE* a,
+                     REAL_TYPE* rr,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void blas_cg_dot_   (REAL_TYPE* rz,
+                     REAL_TYPE* zq,
+                     REAL_TYPE* z,
+                     REAL_TYPE* r,
+                     REAL_TYPE* q,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void blas_calc_ax_dot_  (REAL_TYPE* ap,
+                         REAL_TYPE* p,
+                         REAL_TYPE* r0,
+                         REAL_TYPE* rr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         double* flop);
+
+void blas_calc_ax_dot2_ (REAL_TYPE* ap,
+                         REAL_TYPE* p,
+                         REAL_TYPE* s,
+                         REAL_TYPE* as,
+                         REAL_TYPE* aa,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         double* flop);
+
 void blas_calc_rk_  (REAL_TYPE* r,
                      REAL_TYPE* p,
                      REAL_TYPE* b,
@@ -521,6 +844,25 @@ void blas_calc_rk_  (REAL_TYPE* r,
                      REAL_TYPE* cf,
                      double* flop);
 
+void ir_residual_   (REAL_TYPE* r,
+                     REAL_TYPE* x,
+                     REAL_TYPE* xl,
+                     REAL_TYPE* b,
+                     double* res,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     double* flop);
+
+void ir_update_     (REAL_TYPE* x,
+                     REAL_TYPE* xl,
+                     REAL_TYPE* d,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
 void calc_rk_maf_  (REAL_TYPE* r,
                     REAL_TYPE* p,
                     REAL_TYPE* b,
@@ -544,6 +886,29 @@ void calc_ax_maf_  (REAL_TYPE* ap,
                     REAL_TYPE* pvt,
                     double* flop);
 
+void calc_rk_mtr_  (REAL_TYPE* r,
+                    REAL_TYPE* p,
+                    REAL_TYPE* b,
+                    int* sz,
+                    int* idx,
+                    int* g,
+                    REAL_TYPE* MX,
+                    REAL_TYPE* MY,
+                    REAL_TYPE* MZ,
+                    REAL_TYPE* pvt,
+                    double* flop);
+  
+void calc_ax_mtr_  (REAL_TYPE* ap,
+                    REAL_TYPE* p,
+                    int* sz,
+                    int* idx,
+                    int* g,
+                    REAL_TYPE* MX,
+                    REAL_TYPE* MY,
+                    REAL_TYPE* MZ,
+                    REAL_TYPE* pvt,
+                    double* flop);
+
 void search_pivot_ (REAL_TYPE* pvt,
                     int* sz,
                     int* idx,
@@ -553,6 +918,247 @@ void search_pivot_ (REAL_TYPE* pvt,
                     REAL_TYPE* Z);
   
   
+// cz_cheby.f90
+void cheby_seed_    (REAL_TYPE* x,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     int* hd);
+
+void cheby_lanczos_ (REAL_TYPE* w,
+                     REAL_TYPE* v,
+                     REAL_TYPE* vp,
+                     REAL_TYPE* a,
+                     REAL_TYPE* b,
+                     REAL_TYPE* ww,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void cheby_scal_    (REAL_TYPE* y,
+                     REAL_TYPE* x,
+                     REAL_TYPE* a,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void cheby_iter_    (REAL_TYPE* x,
+                     REAL_TYPE* r,
+                     REAL_TYPE* d,
+                     REAL_TYPE* dn,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* c1,
+                     REAL_TYPE* c2,
+                     double* res,
+                     double* flop);
+
+// cz_ca.f90
+void ca_basis_      (REAL_TYPE* vn,
+                     REAL_TYPE* v,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* a,
+                     REAL_TYPE* b,
+                     double* flop);
+
+void ca_gram_       (double* gm,
+                     double* gv,
+                     REAL_TYPE* y,
+                     REAL_TYPE* rt,
+                     int* nb,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void ca_update_     (REAL_TYPE* x,
+                     REAL_TYPE* y,
+                     double* cx,
+                     double* cp,
+                     double* cr,
+                     int* nb,
+                     int* ip,
+                     int* ir,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+// cz_gmres.f90
+void gmres_mdot_    (double* h,
+                     REAL_TYPE* v,
+                     REAL_TYPE* w,
+                     int* n,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+void gmres_maxpy_   (REAL_TYPE* w,
+                     REAL_TYPE* v,
+                     double* h,
+                     double* a,
+                     int* n,
+                     int* sz,
+                     int* idx,
+                     int* g,
+                     double* flop);
+
+// cz_batch.f90
+void batch_pack_        (REAL_TYPE* xb,
+                         REAL_TYPE* x,
+                         int* nr,
+                         int* m,
+                         int* sz,
+                         int* g);
+
+void batch_unpack_      (REAL_TYPE* x,
+                         REAL_TYPE* xb,
+                         int* nr,
+                         int* m,
+                         int* sz,
+                         int* g);
+
+void batch_clear_       (REAL_TYPE* x,
+                         int* nr,
+                         int* sz,
+                         int* g);
+
+void batch_copy_        (REAL_TYPE* y,
+                         REAL_TYPE* x,
+                         int* nr,
+                         int* sz,
+                         int* g);
+
+void batch_sor2sma_     (REAL_TYPE* p,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         int* ofst,
+                         int* color,
+                         REAL_TYPE* omg,
+                         REAL_TYPE* b,
+                         int* nr,
+                         double* res,
+                         double* flop);
+
+void batch_calc_rk_     (REAL_TYPE* r,
+                         REAL_TYPE* p,
+                         REAL_TYPE* b,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         double* flop);
+
+void batch_calc_ax_dot_ (REAL_TYPE* ap,
+                         REAL_TYPE* p,
+                         REAL_TYPE* r0,
+                         double* rr,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         double* flop);
+
+void batch_calc_ax_dot2_(REAL_TYPE* ap,
+                         REAL_TYPE* p,
+                         REAL_TYPE* s,
+                         double* as,
+                         double* aa,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         REAL_TYPE* cf,
+                         double* flop);
+
+void batch_dot2_        (double* r,
+                         REAL_TYPE* p,
+                         REAL_TYPE* q,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         double* flop);
+
+void batch_bicg_1_      (REAL_TYPE* p,
+                         REAL_TYPE* r,
+                         REAL_TYPE* q,
+                         double* beta,
+                         double* omg,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         double* flop);
+
+void batch_triad_       (REAL_TYPE* z,
+                         REAL_TYPE* x,
+                         REAL_TYPE* y,
+                         double* a,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         double* flop);
+
+void batch_bicg_3_      (REAL_TYPE* x,
+                         REAL_TYPE* r,
+                         REAL_TYPE* p_,
+                         REAL_TYPE* s_,
+                         REAL_TYPE* s,
+                         REAL_TYPE* t,
+                         REAL_TYPE* r0,
+                         double* a,
+                         double* b,
+                         double* rr,
+                         double* rr0,
+                         int* nr,
+                         int* sz,
+                         int* idx,
+                         int* g,
+                         double* flop);
+
+// cz_mg.f90
+
+void mg_restrict_   (int* szf,
+                     int* idxf,
+                     int* g,
+                     REAL_TYPE* cf,
+                     REAL_TYPE* x,
+                     REAL_TYPE* b,
+                     int* szc,
+                     int* idxc,
+                     REAL_TYPE* bc,
+                     double* flop);
+
+void mg_prolong_    (int* szc,
+                     int* idxc,
+                     int* g,
+                     REAL_TYPE* xc,
+                     int* szf,
+                     int* idxf,
+                     REAL_TYPE* x,
+                     double* flop);
+
+void mg_bc_         (REAL_TYPE* x,
+                     int* sz,
+                     int* g,
+                     int* nID,
+                     REAL_TYPE* s);
+
+
 // utility.f90
 
 void fileout_t_ (int* sz,
@@ -575,6 +1181,16 @@ void err_t_   (int* sz,
                REAL_TYPE* p,
                REAL_TYPE* e,
                int* loc);
+
+void warm_source_ (REAL_TYPE* b,
+                   int* sz,
+                   int* idx,
+                   int* g,
+                   REAL_TYPE* dh,
+                   REAL_TYPE* org,
+                   REAL_TYPE* c,
+                   REAL_TYPE* xs,
+                   REAL_TYPE* w);
 }
 
 
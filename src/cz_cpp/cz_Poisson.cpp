@@ -35,6 +35,21 @@
     int itr;
     double flop_count = 0.0;
     int gc = GUIDE;
+    int core[6], shell[6][6], n_shell=0;
+    bool pending = false;
+    int ex[6], nt=1, cg=1;
+
+    if (s_type==LS_JACOBI_OVL) n_shell = split_inner_index(core, shell);
+
+    // 時間ブロッキング 冗長計算する層数分のガイドセルを同期
+    if (s_type==LS_JACOBI_TB)
+    {
+      nt = getTBdepth(ex, true);
+      for (int l=0; l<6; l++) if ( ex[l] ) cg = nt;
+      if ( cg > 1 ) {
+        if ( !Comm_S(X, cg, "Comm_Poisson") ) return 0;
+      }
+    }
 
     for (itr=1; itr<=itr_max; itr++)
     {
@@ -47,10 +62,51 @@
         PUSH_RANGE("jacobi_maf", 8);
         TIMING_start("JACOBI_MAF_kernel");
         flop_count = 0.0;
-        jacobi_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ac1, B, &res, WRK, vrtmp, &flop_count);
+        if (SW_mtr == 1)
+        {
+          jacobi_mtr_(X, size, innerFidx, &gc, mtx, mty, mtz, &ac1, B, &res, WRK, vrtmp, &flop_count);
+        }
+        else
+        {
+          jacobi_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ac1, B, &res, WRK, vrtmp, &flop_count);
+        }
         TIMING_stop("JACOBI_MAF_kernel", flop_count);
         POP_RANGE;
       }
+      else if (s_type==LS_JACOBI_OVL)
+      {
+        // 中心部はガイドセルの通信中に計算
+        TIMING_start("JACOBI_kernel");
+        flop_count = 0.0;
+        jacobi_sub_(X, size, core, &gc, cf, &ac1, B, &res, WRK, &flop_count);
+        TIMING_stop("JACOBI_kernel", flop_count);
+        flop += flop_count;
+
+        if ( pending ) {
+          if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+          pending = false;
+        }
+
+        TIMING_start("JACOBI_kernel");
+        flop_count = 0.0;
+        for (int l=0; l<n_shell; l++) {
+          jacobi_sub_(X, size, shell[l], &gc, cf, &ac1, B, &res, WRK, &flop_count);
+        }
+        blas_copy_idx_(X, WRK, size, innerFidx, &gc);
+        TIMING_stop("JACOBI_kernel", flop_count);
+      }
+      else if (s_type==LS_JACOBI_TB && nt > 1 && itr < itr_max)
+      {
+        // 最大nt反復をまとめて進める
+        int m = itr_max - itr + 1;
+        if ( m > nt ) m = nt;
+
+        TIMING_start("JACOBI_kernel");
+        flop_count = 0.0;
+        jacobi_tb_(X, size, innerFidx, &gc, cf, &ac1, B, &res, &m, ex, TBW, &flop_count);
+        TIMING_stop("JACOBI_kernel", flop_count);
+        itr += m-1;
+      }
       else
       {
         TIMING_start("JACOBI_kernel");
@@ -60,24 +116,41 @@
       }
       flop += flop_count;
 
-      if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+      if (s_type==LS_JACOBI_OVL)
+      {
+        if ( !Comm_S_begin(X, 1, "Comm_Poisson") ) return 0;
+        pending = true;
+      }
+      else
+      {
+        if ( !Comm_S(X, cg, "Comm_Poisson") ) return 0;
+      }
 
 
       if ( converge_check ) {
-        if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-
-        res *= res_normal;
-        res = sqrt(res);
-        Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+        int itr_res;
+        if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
 
         TIMING_start("BoundaryCondition");
         bc_k_(size, &gc, X, pitch, origin, nID);
         TIMING_stop("BoundaryCondition");
 
-        if ( res < eps ) break;
+        if ( itr_res > 0 ) {
+          Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          if ( res < eps ) break;
+        }
       }
     }
 
+    if ( pending ) {
+      if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+    }
+
+    // 遅延判定で未完了の残差の集計
+    if ( converge_check ) {
+      if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+    }
+
     return itr;
   }
 
@@ -100,6 +173,10 @@
     int itr;
     double flop_count = 0.0;
     int gc = GUIDE;
+    int core[6], shell[6][6], n_shell=0;
+    bool pending = false;
+
+    if (s_type==LS_PSOR_OVL) n_shell = split_inner_index(core, shell);
 
     for (itr=1; itr<=itr_max; itr++)
     {
@@ -109,9 +186,53 @@
       {
         TIMING_start("SOR_MAF_kernel");
         flop_count = 0.0;
-        psor_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ac1, B, &res, &flop_count);
+        if (SW_mtr == 1)
+        {
+          psor_mtr_(X, size, innerFidx, &gc, mtx, mty, mtz, &ac1, B, &res, &flop_count);
+        }
+        else
+        {
+          psor_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ac1, B, &res, &flop_count);
+        }
         TIMING_stop("SOR_MAF_kernel", flop_count);
       }
+      else if (s_type==LS_PSOR_OVL)
+      {
+        // 中心部はガイドセルの通信中に計算
+        TIMING_start("SOR_kernel");
+        flop_count = 0.0;
+        psor_(X, size, core, &gc, cf, &ac1, B, &res, &flop_count);
+        TIMING_stop("SOR_kernel", flop_count);
+        flop += flop_count;
+
+        if ( pending ) {
+          if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+          pending = false;
+        }
+
+        TIMING_start("SOR_kernel");
+        flop_count = 0.0;
+        for (int l=0; l<n_shell; l++) {
+          psor_(X, size, shell[l], &gc, cf, &ac1, B, &res, &flop_count);
+        }
+        TIMING_stop("SOR_kernel", flop_count);
+      }
+      else if (s_type==LS_SSOR)
+      {
+        // 前進と後退の掃引で1反復，間でガイドセルを同期
+        TIMING_start("SOR_kernel");
+        flop_count = 0.0;
+        psor_(X, size, innerFidx, &gc, cf, &ac1, B, &res, &flop_count);
+        TIMING_stop("SOR_kernel", flop_count);
+        flop += flop_count;
+
+        if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+
+        TIMING_start("SOR_kernel");
+        flop_count = 0.0;
+        psor_bwd_(X, size, innerFidx, &gc, cf, &ac1, B, &res, &flop_count);
+        TIMING_stop("SOR_kernel", flop_count);
+      }
       else
       {
         TIMING_start("SOR_kernel");
@@ -121,27 +242,43 @@
       }
       flop += flop_count;
 
-      if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+      if (s_type==LS_PSOR_OVL)
+      {
+        if ( !Comm_S_begin(X, 1, "Comm_Poisson") ) return 0;
+        pending = true;
+      }
+      else
+      {
+        if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+      }
 
 
 
       if ( converge_check ) {
-        if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-
-        res *= res_normal;
-        res = sqrt(res);
-
-        Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+        int itr_res;
+        if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
 
         TIMING_start("BoundaryCondition");
         bc_k_(size, &gc, X, pitch, origin, nID);
         TIMING_stop("BoundaryCondition");
 
-        if ( res < eps ) break;
+        if ( itr_res > 0 ) {
+          Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          if ( res < eps ) break;
+        }
       }
 
     } // Iteration
 
+    if ( pending ) {
+      if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+    }
+
+    // 遅延判定で未完了の残差の集計
+    if ( converge_check ) {
+      if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+    }
+
     return itr;
   }
 
@@ -164,6 +301,14 @@ int CZ::RBSOR(double& res, REAL_TYPE* X, REAL_TYPE* B,
    int itr;
    double flop_count = 0.0;
    int gc = GUIDE;
+   int ex[6], nt=1;
+
+   if (s_type==LS_SOR2SMA && SW_split == 1)
+   {
+     return RBSOR_split(res, X, B, itr_max, flop, converge_check);
+   }
+
+   if (s_type==LS_SOR2SMA_TB) nt = getTBdepth(ex, false);
 
    for (itr=1; itr<=itr_max; itr++)
    {
@@ -194,10 +339,41 @@ int CZ::RBSOR(double& res, REAL_TYPE* X, REAL_TYPE* B,
        for (int color=0; color<2; color++)
        {
          // res_p >> 反復残差の二乗和
-         psor2sma_core_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ip, &color, &ac1, B, &res, vrtmp, &flop_count);
+         if (SW_mtr == 1)
+         {
+           psor2sma_core_mtr_(X, size, innerFidx, &gc, mtx, mty, mtz, &ip, &color, &ac1, B, &res, vrtmp, &flop_count);
+         }
+         else
+         {
+           psor2sma_core_maf_(X, size, innerFidx, &gc, xc, yc, zc, &ip, &color, &ac1, B, &res, vrtmp, &flop_count);
+         }
        }
        TIMING_stop("SOR2SMA_MAF_kernel", flop_count);
      }
+     else if (s_type==LS_SOR2SMA_TB && nt > 1 && itr < itr_max)
+     {
+       // 最大nt反復をまとめて進める
+       int m = itr_max - itr + 1;
+       if ( m > nt ) m = nt;
+
+       TIMING_start("SOR2SMA_kernel");
+       flop_count = 0.0;
+       psor2sma_tb_(X, size, innerFidx, &gc, cf, &ip, &ac1, B, &res, &m, &flop_count);
+       TIMING_stop("SOR2SMA_kernel", flop_count);
+       itr += m-1;
+     }
+     else if (s_type==LS_SOR2SMA_SYM)
+     {
+       // 偶数反復は B -> R の順とし，2反復で R B B R の対称な掃引にする
+       TIMING_start("SOR2SMA_kernel");
+       flop_count = 0.0;
+       for (int c=0; c<2; c++)
+       {
+         int color = (itr % 2 == 0) ? 1-c : c;
+         psor2sma_core_(X, size, innerFidx, &gc, cf, &ip, &color, &ac1, B, &res, &flop_count);
+       }
+       TIMING_stop("SOR2SMA_kernel", flop_count);
+     }
      else
      {
        TIMING_start("SOR2SMA_kernel");
@@ -216,292 +392,2401 @@ int CZ::RBSOR(double& res, REAL_TYPE* X, REAL_TYPE* B,
 
 
      if ( converge_check ) {
-       if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-
-       res *= res_normal;
-       res = sqrt(res);
-       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+       int itr_res;
+       if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
        
        TIMING_start("BoundaryCondition");
        bc_k_(size, &gc, X, pitch, origin, nID);
        TIMING_stop("BoundaryCondition");
 
-       if ( res < eps ) break;
+       if ( itr_res > 0 ) {
+         Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+         if ( res < eps ) break;
+       }
      }
 
    } // Iteration
 
+   // 遅延判定で未完了の残差の集計
+   if ( converge_check ) {
+     if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+   }
+
    return itr;
  }
 
 
  // #################################################################
- REAL_TYPE CZ::Fdot1(REAL_TYPE* x, double& flop)
- {
-   double flop_count=0.0;          /// 浮動小数点演算数
-   REAL_TYPE xy = 0.0;
-   int gc = GUIDE;
-
-   TIMING_start("Dot1");
-   blas_dot1_(&xy, x, size, innerFidx, &gc, &flop_count);
-   TIMING_stop("Dot1", flop_count);
-   flop += flop_count;
-
-   if ( !Comm_SUM_1(&xy, "A_R_Dot") ) Exit(0);
-
-   return xy;
- }
-
- // #################################################################
- REAL_TYPE CZ::Fdot2(REAL_TYPE* x, REAL_TYPE* y, double& flop)
+ // @brief 多色SOR
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in]     itr_max 最大反復数
+ // @param [in,out] flop   浮動小数点演算数
+ // @param [in]     converge_check 収束判定を行う場合true
+ // @note 色は全体領域のインデクスで決めるので，領域分割に依らず同じ掃引順になる
+ //       K方向の区間内は逆行列で厳密に解くブロックSORとなる
+ int CZ::MCSOR(double& res, REAL_TYPE* X, REAL_TYPE* B,
+               const int itr_max, double& flop,
+               bool converge_check)
  {
-   double flop_count=0.0;          /// 浮動小数点演算数
-   REAL_TYPE xy = 0.0;
+   int itr;
+   double flop_count = 0.0;
    int gc = GUIDE;
+   int off[3] = {head[0]-1, head[1]-1, head[2]-1};
 
-   TIMING_start("Dot2");
-   blas_dot2_(&xy, x, y, size, innerFidx, &gc, &flop_count);
-   TIMING_stop("Dot2", flop_count);
-   flop += flop_count;
+   for (itr=1; itr<=itr_max; itr++)
+   {
+     res = 0.0;
 
-   if ( !Comm_SUM_1(&xy, "A_R_Dot") ) Exit(0);
+     TIMING_start("MCSOR_kernel");
+     flop_count = 0.0;
+     for (int color=0; color<mc_nc; color++)
+     {
+       psor_mc_(X, size, innerFidx, &gc, cf, off, &color, &mc_nc, MCT, &ac1, B, &res, &flop_count);
+     }
+     TIMING_stop("MCSOR_kernel", flop_count);
+     flop += flop_count;
 
-   return xy;
- }
+     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
 
- // #################################################################
- void CZ::Preconditioner(REAL_TYPE* xx,
-                         REAL_TYPE* bb,
-                         double& flop,
-                         int s_type)
- {
-   int gc = GUIDE;
-   double res = 0.0;
-   int lc_max = 8;
+     if ( converge_check ) {
+       int itr_res;
+       if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
 
-   switch (s_type)
-   {
-     case LS_JACOBI:
-     case LS_JACOBI_MAF:
-       JACOBI(res, xx, bb, lc_max, flop, s_type, false);
-       break;
+       TIMING_start("BoundaryCondition");
+       bc_k_(size, &gc, X, pitch, origin, nID);
+       TIMING_stop("BoundaryCondition");
 
-     case LS_PSOR:
-     case LS_PSOR_MAF:
-       PSOR(res, xx, bb, lc_max, flop, s_type, false);
-       break;
+       if ( itr_res > 0 ) {
+         Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+         if ( res < eps ) break;
+       }
+     }
 
-     case LS_SOR2SMA:
-     case LS_SOR2SMA_MAF:
-       RBSOR(res, xx, bb, lc_max, flop, s_type, false);
-       break;
-     
-     case LS_PCR:
-     case LS_PCR_MAF:
-       LSOR_PCR(res, xx, bb, lc_max, flop, s_type, false);
-       break;
-     
-     case LS_PCR_EDA:
-     case LS_PCR_EDA_MAF:
-     LSOR_PCR_EDA(res, xx, bb, lc_max, flop, s_type, false);
-     break;
-       
-     case LS_PCR_RB:
-     case LS_PCR_RB_MAF:
-       LSOR_PCR_RB(res, xx, bb, lc_max, flop, s_type, false);
-       break;
-       
-      case LS_PCR_RB_ESA:
-      case LS_PCR_RB_ESA_MAF:
-       LSOR_PCR_RB_ESA(res, xx, bb, lc_max, flop, s_type, false);
-       break;
+   } // Iteration
 
-     default:
-       blas_copy_(xx, bb, size, &gc);
+   // 遅延判定で未完了の残差の集計
+   if ( converge_check ) {
+     if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
    }
+
+   return itr;
  }
 
 
-// #################################################################
-// @brief PBiCGSTAB反復
-// @param [in,out] res    残差
-// @param [in,out] X      解ベクトル
-// @param [in]     B      RHSベクトル
-// @param [in]     flop   浮動小数点演算数
-// @param [in]     s_type ソルバーの指定
- int CZ::PBiCGSTAB(double& res,
-                   REAL_TYPE* X,
-                   REAL_TYPE* B,
-                   double& flop,
-                   int s_type)
+ // #################################################################
+ // @brief 2色SOR 色毎に分けた配列
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in]     itr_max 最大反復数
+ // @param [in,out] flop   浮動小数点演算数
+ // @param [in]     converge_check 収束判定を行う場合true
+ // @note 入口で X, B を色毎の配列に分け，出口で X の内点に戻す
+ //       反復中は内点の最外層だけを X に写して通信し，通信と境界条件で
+ //       更新された外側の層を色毎の配列に読み戻す
+ //       逐次で境界条件を適用しない場合は写す必要がない
+ int CZ::RBSOR_split(double& res, REAL_TYPE* X, REAL_TYPE* B,
+                     const int itr_max, double& flop,
+                     bool converge_check)
  {
    int itr;
    double flop_count = 0.0;
    int gc = GUIDE;
-   res = 0.0;
+   int nh = sp_nh;
+   int d_out = 0;
+   int d_in = 1;
 
-   TIMING_start("Blas_Clear");
-   blas_clear_(pcg_q , size, &gc);
-   TIMING_stop("Blas_Clear");
-
-   
-   TIMING_start("Blas_Residual");
-   flop_count = 0.0;
-   if (s_type==LS_BICGSTAB_MAF)
+   int ip = 0;
+   if ( numProc > 1 )
    {
-     calc_rk_maf_(pcg_r, X, B, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+     ip = (head[0] + head[1] + head[2]+1) % 2;
    }
-   else
-   {
-     blas_calc_rk_(pcg_r, X, B, size, innerFidx, &gc, cf, &flop_count);
-   }
-   TIMING_stop("Blas_Residual", flop_count);
-   flop += flop_count;
-
-   
-   if ( !Comm_S(pcg_r, 1, "Comm_Poisson") ) return 0;
-
-   TIMING_start("Blas_Copy");
-   blas_copy_(pcg_r0, pcg_r, size, &gc);
-   TIMING_stop("Blas_Copy");
 
-   REAL_TYPE rho_old = 1.0;
-   REAL_TYPE alpha = 0.0;
-   REAL_TYPE omega  = 1.0;
-   REAL_TYPE r_omega = -omega;
+   TIMING_start("SOR2SMA_Split_Pack");
+   rb_split_pack_(sp_x[0], sp_x[1], X, size, innerFidx, &gc, &nh, &ip);
+   rb_split_pack_(sp_b[0], sp_b[1], B, size, innerFidx, &gc, &nh, &ip);
+   TIMING_stop("SOR2SMA_Split_Pack");
 
-   for (itr=1; itr<ItrMax; itr++)
+   for (itr=1; itr<=itr_max; itr++)
    {
+     res = 0.0;
+
+     TIMING_start("SOR2SMA_Split_kernel");
      flop_count = 0.0;
-     REAL_TYPE rho = Fdot2(pcg_r, pcg_r0, flop_count);
+     for (int color=0; color<2; color++)
+     {
+       psor2sma_split_(sp_x[color], sp_x[1-color], size, innerFidx, &gc, &nh, cf,
+                       &ip, &color, &ac1, sp_b[color], &res, &flop_count);
+     }
+     TIMING_stop("SOR2SMA_Split_kernel", flop_count);
      flop += flop_count;
 
-     if( fabs(rho) < FLT_MIN )
+     if ( numProc > 1 )
      {
-       itr = 0;
-       break;
+       TIMING_start("SOR2SMA_Split_Pack");
+       rb_split_face_(sp_x[0], sp_x[1], X, size, innerFidx, &gc, &nh, &ip, &d_out);
+       TIMING_stop("SOR2SMA_Split_Pack");
+
+       if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
      }
 
-     if( itr == 1 )
-     {
-       TIMING_start("Blas_Copy");
-       blas_copy_(pcg_p, pcg_r, size, &gc);
-       TIMING_stop("Blas_Copy");
+     int itr_res = 0;
+     if ( converge_check ) {
+       if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
+
+       TIMING_start("BoundaryCondition");
+       bc_k_(size, &gc, X, pitch, origin, nID);
+       TIMING_stop("BoundaryCondition");
      }
-     else
+
+     if ( numProc > 1 || converge_check )
      {
-       REAL_TYPE beta = rho / rho_old * alpha / omega;
+       TIMING_start("SOR2SMA_Split_Pack");
+       rb_split_face_(sp_x[0], sp_x[1], X, size, innerFidx, &gc, &nh, &ip, &d_in);
+       TIMING_stop("SOR2SMA_Split_Pack");
+     }
+
+     if ( itr_res > 0 ) {
+       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+       if ( res < eps ) break;
+     }
+
+   } // Iteration
+
+   // 遅延判定で未完了の残差の集計
+   if ( converge_check ) {
+     if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+   }
+
+   TIMING_start("SOR2SMA_Split_Pack");
+   rb_split_merge_(X, sp_x[0], sp_x[1], size, innerFidx, &gc, &nh, &ip);
+   TIMING_stop("SOR2SMA_Split_Pack");
+
+   return itr;
+ }
+
+
+ // #################################################################
+ // @brief マルチグリッド反復
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in]     itr_max 最大反復数
+ // @param [in,out] flop   浮動小数点演算数
+ // @param [in]     s_type LS_MG (V-cycle) / LS_MG_W (W-cycle)
+ // @param [in]     converge_check 残差計算のon/off
+ // @note 1反復が1サイクル，収束判定は真の残差 |b-Ax|
+ //       前処理として呼ぶ場合はX=0から1サイクルなので線形作用素になる
+ int CZ::MG(double& res, REAL_TYPE* X, REAL_TYPE* B,
+            const int itr_max, double& flop,
+            int s_type,
+            bool converge_check)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   int gamma = (s_type==LS_MG_W) ? 2 : 1;
+
+   for (itr=1; itr<=itr_max; itr++)
+   {
+     MG_cycle(0, X, B, gamma, flop);
+
+     if ( converge_check ) {
+       TIMING_start("Blas_Residual");
+       flop_count = 0.0;
+       blas_calc_rk_(WRK, X, B, size, innerFidx, &gc, cf, &flop_count);
+       TIMING_stop("Blas_Residual", flop_count);
+       flop += flop_count;
+
+       res = Fdot1(WRK, flop);
+       res *= res_normal;
+       res = sqrt(res);
+       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+
+       TIMING_start("BoundaryCondition");
+       bc_k_(size, &gc, X, pitch, origin, nID);
+       TIMING_stop("BoundaryCondition");
+
+       if ( res < eps ) break;
+     }
+
+   } // Iteration
+
+   return itr;
+ }
+
+
+ // #################################################################
+ // @brief マルチグリッドの1サイクル（再帰）
+ // @param [in]     lv     階層 0が細格子
+ // @param [in,out] X      lv階層の解ベクトル（補正量）
+ // @param [in]     B      lv階層のRHSベクトル
+ // @param [in]     gamma  粗格子の再帰回数 1:V-cycle, 2:W-cycle
+ // @param [in,out] flop   浮動小数点演算数
+ // @note 入口でXのガイドセルは同期済みであること，出口でも同期済み
+ void CZ::MG_cycle(const int lv, REAL_TYPE* X, REAL_TYPE* B,
+                   const int gamma, double& flop)
+ {
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   int lc = lv + 1;
+
+   // 最粗格子は平滑化を繰り返して近似的に解く
+   if ( lc == mg_lv )
+   {
+     MG_smooth(lv, X, B, MG_COARSE_ITR, flop);
+     return;
+   }
+
+   MG_smooth(lv, X, B, MG_NU1, flop);
+
+   // 残差を粗格子へ制限
+   TIMING_start("MG_Restrict");
+   flop_count = 0.0;
+   mg_restrict_(mg_sz[lv], mg_idx[lv], &gc, cf, X, B,
+                mg_sz[lc], mg_idx[lc], mg_b[lc], &flop_count);
+   TIMING_stop("MG_Restrict", flop_count);
+   flop += flop_count;
+
+   TIMING_start("Blas_Clear");
+   blas_clear_(mg_x[lc], mg_sz[lc], &gc);
+   TIMING_stop("Blas_Clear");
+
+   for (int g=0; g<gamma; g++)
+   {
+     MG_cycle(lc, mg_x[lc], mg_b[lc], gamma, flop);
+   }
+
+   // 補正量を補間して加算
+   TIMING_start("MG_Prolong");
+   flop_count = 0.0;
+   mg_prolong_(mg_sz[lc], mg_idx[lc], &gc, mg_x[lc],
+               mg_sz[lv], mg_idx[lv], X, &flop_count);
+   TIMING_stop("MG_Prolong", flop_count);
+   flop += flop_count;
+
+   if ( !Comm_S_mg(X, lv, 1, "Comm_Poisson") ) Exit(0);
+
+   MG_smooth(lv, X, B, MG_NU2, flop);
+ }
+
+
+ // #################################################################
+ // @brief マルチグリッドの平滑化 2色Gauss-Seidel
+ // @note 粗格子の物理境界は補正量が境界節点で0となるよう外挿する
+ // @param [in]     lv     階層 0が細格子
+ // @param [in,out] X      lv階層の解ベクトル
+ // @param [in]     B      lv階層のRHSベクトル
+ // @param [in]     nu     反復回数
+ // @param [in,out] flop   浮動小数点演算数
+ void CZ::MG_smooth(const int lv, REAL_TYPE* X, REAL_TYPE* B,
+                    const int nu, double& flop)
+ {
+   double flop_count = 0.0;
+   double res = 0.0;
+   int gc = GUIDE;
+   int ip = mg_ip[lv];
+   REAL_TYPE omg = 1.0;
+
+   for (int it=0; it<nu; it++)
+   {
+     TIMING_start("MG_Smooth");
+     flop_count = 0.0;
+     for (int color=0; color<2; color++)
+     {
+       if ( lv > 0 ) mg_bc_(X, mg_sz[lv], &gc, nID, &mg_s[lv]);
+       psor2sma_core_(X, mg_sz[lv], mg_idx[lv], &gc, cf, &ip, &color, &omg, B, &res, &flop_count);
+     }
+     TIMING_stop("MG_Smooth", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_S_mg(X, lv, 1, "Comm_Poisson") ) Exit(0);
+   }
+
+   // 制限と補間で参照する粗格子の物理境界のガイドセル
+   if ( lv > 0 ) mg_bc_(X, mg_sz[lv], &gc, nID, &mg_s[lv]);
+ }
+
+
+ // #################################################################
+ // @brief Chebyshev反復（Jacobi前処理）
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in]     itr_max 最大反復数
+ // @param [in,out] flop   浮動小数点演算数
+ // @param [in]     converge_check 0のとき、収束判定しない
+ // @note 固有値の範囲 [chb_lo, chb_hi] は setChebyBound() で一度だけ推定する
+ //       反復中は修正量の通信のみで内積を持たないので，前処理では集団通信が発生しない
+ //       反復回数を固定すれば線形かつ対称な前処理になる
+ int CZ::CHEBY(double& res, REAL_TYPE* X, REAL_TYPE* B,
+               const int itr_max, double& flop, bool converge_check)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   REAL_TYPE* d = chb_d;
+   REAL_TYPE* e = chb_e;
+
+   double theta = 0.5 * (chb_hi + chb_lo);
+   double delta = 0.5 * (chb_hi - chb_lo);
+   double sigma = theta / delta;
+   double rho0  = 1.0 / sigma;
+   double di    = -1.0 / (double)cf[6]; // D^{-1}
+
+   // r = b - A x, d = D^{-1} r / theta
+   TIMING_start("Blas_Residual");
+   flop_count = 0.0;
+   blas_calc_rk_(chb_r, X, B, size, innerFidx, &gc, cf, &flop_count);
+   REAL_TYPE c0 = (REAL_TYPE)(di / theta);
+   cheby_scal_(d, chb_r, &c0, size, innerFidx, &gc, &flop_count);
+   TIMING_stop("Blas_Residual", flop_count);
+   flop += flop_count;
+
+   for (itr=1; itr<=itr_max; itr++)
+   {
+     res = 0.0;
+
+     if ( !Comm_S(d, 1, "Comm_Poisson") ) return 0;
+
+     double rho1 = 1.0 / (2.0 * sigma - rho0);
+     REAL_TYPE c1 = (REAL_TYPE)(rho1 * rho0);
+     REAL_TYPE c2 = (REAL_TYPE)(2.0 * rho1 / delta * di);
+
+     TIMING_start("CHEBY_kernel");
+     flop_count = 0.0;
+     cheby_iter_(X, chb_r, d, e, size, innerFidx, &gc, cf, &c1, &c2, &res, &flop_count);
+     TIMING_stop("CHEBY_kernel", flop_count);
+     flop += flop_count;
+
+     rho0 = rho1;
+     REAL_TYPE* t = d;
+     d = e;
+     e = t;
+
+     if ( converge_check ) {
+       if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
+
+       res *= res_normal;
+       res = sqrt(res);
+       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+
+       if ( res < eps ) break;
+     }
+   }
+
+   // Xは反復中に参照しないので最後に同期
+   if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+
+   if ( converge_check ) {
+     TIMING_start("BoundaryCondition");
+     bc_k_(size, &gc, X, pitch, origin, nID);
+     TIMING_stop("BoundaryCondition");
+   }
+
+   return itr;
+ }
+
+
+ // #################################################################
+ // @brief 混合精度の反復改良
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル（上位）
+ // @param [in]     B      RHSベクトル
+ // @param [in,out] flop   浮動小数点演算数
+ // @note 解は X + ir_xl の2語で倍精度相当に保持し，残差 b - A x は倍精度で計算する
+ //       修正方程式 A d = r は単精度のまま pc_type の反復で解く
+ //       定常法は IR_INNER_ITR 回の反復，pbicgstab は相対残差 IR_INNER_EPS まで
+ //       2語とも単精度配列なので，ガイドセルの同期は既存の Comm_S をそのまま使う
+ int CZ::IR(double& res, REAL_TYPE* X, REAL_TYPE* B, double& flop)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+
+   TIMING_start("Blas_Clear");
+   blas_clear_(ir_xl, size, &gc);
+   TIMING_stop("Blas_Clear");
+
+   for (itr=1; itr<=ItrMax; itr++)
+   {
+     // r = b - A (x + xl) を倍精度で
+     res = 0.0;
+     TIMING_start("IR_Residual");
+     flop_count = 0.0;
+     ir_residual_(ir_r, X, ir_xl, B, &res, size, innerFidx, &gc, cf, &flop_count);
+     TIMING_stop("IR_Residual", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
+
+     res *= res_normal;
+     res = sqrt(res);
+     Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+
+     if ( res < eps ) break;
+
+     if ( !Comm_S(ir_r, 1, "Comm_Poisson") ) return 0;
+
+     TIMING_start("Blas_Clear");
+     blas_clear_(ir_d, size, &gc);
+     TIMING_stop("Blas_Clear");
+
+     // 単精度の修正方程式
+     flop_count = 0.0;
+     if ( pc_type == LS_BICGSTAB )
+     {
+       double eps_outer = eps;
+       double res_inner = 0.0;
+       eps = IR_INNER_EPS * res;
+       PBiCGSTAB(res_inner, ir_d, ir_r, flop_count, LS_BICGSTAB);
+       eps = eps_outer;
+     }
+     else
+     {
+       Preconditioner(ir_d, ir_r, flop_count, pc_type, IR_INNER_ITR);
+     }
+     flop += flop_count;
+
+     TIMING_start("IR_Update");
+     flop_count = 0.0;
+     ir_update_(X, ir_xl, ir_d, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("IR_Update", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+     if ( !Comm_S(ir_xl, 1, "Comm_Poisson") ) return 0;
+   }
+
+   return itr;
+ }
+
+
+ // #################################################################
+ // @brief 加速係数を推定しながらSOR系の反復
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in,out] flop   浮動小数点演算数
+ // @note OMEGA_CHUNK回毎の残差の比から漸近収束率 lambda を求める
+ //       omega=1 の2区間目の lambda から Jacobi（ライン系はライン Jacobi）反復の
+ //       スペクトル半径 mu = sqrt(lambda) を得て，omega = 2/(1+sqrt(1-mu^2)) とする
+ //       以降，lambda が omega-1 を上回る間は omega が最適値より小さいので，
+ //       (lambda+omega-1)^2 = lambda omega^2 mu^2 から mu を推定し直して omega を増やす
+ //       omegaを変えた直後の区間は過渡的なので，比を取らない
+ //       領域分割時はランク間で整合順序にならず最適値が小さいので，omega-1 を OMEGA_BACKOFF 倍する
+ //       収束しなくなった場合は omega-1 を OMEGA_BACKOFF 倍に縮め，以降は増やさない
+ int CZ::SOR_auto(double& res, REAL_TYPE* X, REAL_TYPE* B, double& flop)
+ {
+   int itr = 0;
+   int m;
+   double res_old = -1.0;
+   double omg_ok = 1.0;  // 収束を確認したomega
+   bool fixed = false;   // omegaを増やさない
+
+   ac1 = 1.0;
+
+   while ( itr < ItrMax )
+   {
+     int n = (ItrMax-itr < OMEGA_CHUNK) ? ItrMax-itr : OMEGA_CHUNK;
+
+     if ( 0 == (m=Relax(res, X, B, n, flop)) ) return 0;
+
+     if ( m <= n ) // 収束
+     {
+       itr += m;
+       break;
+     }
+     itr += n;
+
+     if ( res_old > 0.0 && n == OMEGA_CHUNK )
+     {
+       double lambda = pow(res / res_old, 1.0/(double)n);
+       double omg = (double)ac1;
+
+       // 収束しない場合は，整合順序でない（領域分割境界など）ためomegaが過大
+       // 収束を確認した値より小さくして，以降は増やさない
+       if ( !(lambda < 1.0) )
+       {
+         omg_ok = 1.0 + OMEGA_BACKOFF * (omg_ok - 1.0);
+         ac1 = (REAL_TYPE)omg_ok;
+         fixed = true;
+         Hostonly_ printf("\tItr = %6d : rate = %e  omega = %f (fixed)\n", itr, lambda, omg_ok);
+         res_old = -1.0;
+         continue;
+       }
+
+       omg_ok = omg;
+
+       if ( !fixed && lambda > (omg - 1.0) * OMEGA_MARGIN )
+       {
+         double mu = (lambda + omg - 1.0) / (omg * sqrt(lambda));
+         if ( mu > 1.0 - FLT_EPSILON ) mu = 1.0 - FLT_EPSILON;
+         double omg_new = 2.0 / (1.0 + sqrt(1.0 - mu*mu));
+         if ( numProc > 1 ) omg_new = 1.0 + OMEGA_BACKOFF * (omg_new - 1.0);
+
+         if ( omg_new > omg )
+         {
+           ac1 = (REAL_TYPE)omg_new;
+           Hostonly_ printf("\tItr = %6d : rate = %e  rho_J = %e  omega = %f\n",
+                            itr, lambda, mu, omg_new);
+           res_old = -1.0;
+           continue;
+         }
+       }
+     }
+
+     res_old = res;
+   }
+
+   Hostonly_ printf("\tomega = %f\n", ac1);
+
+   return itr;
+ }
+
+
+ // #################################################################
+ // @brief SOR系ソルバの反復
+ // @param [in,out] res    残差
+ // @param [in,out] X      解ベクトル
+ // @param [in]     B      RHSベクトル
+ // @param [in]     itr_max 最大反復数
+ // @param [in,out] flop   浮動小数点演算数
+ // @retval 反復数，収束しなければ itr_max+1
+ int CZ::Relax(double& res, REAL_TYPE* X, REAL_TYPE* B,
+               const int itr_max, double& flop)
+ {
+   switch (ls_type)
+   {
+     case LS_PSOR:
+     case LS_PSOR_MAF:
+     case LS_PSOR_OVL:
+       return PSOR(res, X, B, itr_max, flop, ls_type);
+
+     case LS_SOR2SMA:
+     case LS_SOR2SMA_MAF:
+     case LS_SOR2SMA_TB:
+       return RBSOR(res, X, B, itr_max, flop, ls_type);
+
+     case LS_PCR:
+     case LS_PCR_MAF:
+     case LS_PCR_OVL:
+       return LSOR_PCR(res, X, B, itr_max, flop, ls_type);
+
+     case LS_PCR_EDA:
+     case LS_PCR_EDA_MAF:
+       return LSOR_PCR_EDA(res, X, B, itr_max, flop, ls_type);
+
+     case LS_PCR_ESA:
+     case LS_PCR_ESA_MAF:
+       return LSOR_PCR_ESA(res, X, B, itr_max, flop, ls_type);
+
+     case LS_PCR_RB:
+     case LS_PCR_RB_MAF:
+     case LS_PCR_RB_HYB:
+       return LSOR_PCR_RB(res, X, B, itr_max, flop, ls_type);
+
+     case LS_PCR_RB_ESA:
+     case LS_PCR_RB_ESA_MAF:
+       return LSOR_PCR_RB_ESA(res, X, B, itr_max, flop, ls_type);
+
+     default:
+       break;
+   }
+
+   return 0;
+ }
+
+
+ // #################################################################
+ REAL_TYPE CZ::Fdot1(REAL_TYPE* x, double& flop)
+ {
+   double flop_count=0.0;          /// 浮動小数点演算数
+   REAL_TYPE xy = 0.0;
+   int gc = GUIDE;
+
+   TIMING_start("Dot1");
+   blas_dot1_(&xy, x, size, innerFidx, &gc, &flop_count);
+   TIMING_stop("Dot1", flop_count);
+   flop += flop_count;
+
+   if ( !Comm_SUM_1(&xy, "A_R_Dot") ) Exit(0);
+
+   return xy;
+ }
+
+ // #################################################################
+ REAL_TYPE CZ::Fdot2(REAL_TYPE* x, REAL_TYPE* y, double& flop)
+ {
+   double flop_count=0.0;          /// 浮動小数点演算数
+   REAL_TYPE xy = 0.0;
+   int gc = GUIDE;
+
+   TIMING_start("Dot2");
+   blas_dot2_(&xy, x, y, size, innerFidx, &gc, &flop_count);
+   TIMING_stop("Dot2", flop_count);
+   flop += flop_count;
+
+   if ( !Comm_SUM_1(&xy, "A_R_Dot") ) Exit(0);
+
+   return xy;
+ }
+
+ // #################################################################
+ void CZ::Preconditioner(REAL_TYPE* xx,
+                         REAL_TYPE* bb,
+                         double& flop,
+                         int s_type,
+                         const int lc_max)
+ {
+   int gc = GUIDE;
+   double res = 0.0;
+
+   switch (s_type)
+   {
+     case LS_JACOBI:
+     case LS_JACOBI_MAF:
+     case LS_JACOBI_OVL:
+     case LS_JACOBI_TB:
+       JACOBI(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+
+     case LS_PSOR:
+     case LS_PSOR_MAF:
+     case LS_PSOR_OVL:
+     case LS_SSOR:
+       PSOR(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+
+     case LS_SOR2SMA:
+     case LS_SOR2SMA_MAF:
+     case LS_SOR2SMA_TB:
+     case LS_SOR2SMA_SYM:
+       RBSOR(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+
+     case LS_MCSOR:
+       MCSOR(res, xx, bb, lc_max, flop, false);
+       break;
+
+     case LS_MG:
+     case LS_MG_W:
+       MG(res, xx, bb, 1, flop, s_type, false);
+       break;
+
+     case LS_CHEBY:
+       CHEBY(res, xx, bb, lc_max, flop, false);
+       break;
+     
+     case LS_PCR:
+     case LS_PCR_MAF:
+     case LS_PCR_OVL:
+       LSOR_PCR(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+     
+     case LS_PCR_EDA:
+     case LS_PCR_EDA_MAF:
+     LSOR_PCR_EDA(res, xx, bb, lc_max, flop, s_type, false);
+     break;
+       
+     case LS_PCR_RB:
+     case LS_PCR_RB_MAF:
+     case LS_PCR_RB_HYB:
+       LSOR_PCR_RB(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+       
+      case LS_PCR_RB_ESA:
+      case LS_PCR_RB_ESA_MAF:
+       LSOR_PCR_RB_ESA(res, xx, bb, lc_max, flop, s_type, false);
+       break;
+
+     default:
+       blas_copy_(xx, bb, size, &gc);
+   }
+ }
+
+
+// #################################################################
+// @brief PBiCGSTAB反復
+// @param [in,out] res    残差
+// @param [in,out] X      解ベクトル
+// @param [in]     B      RHSベクトル
+// @param [in]     flop   浮動小数点演算数
+// @param [in]     s_type ソルバーの指定
+ int CZ::PBiCGSTAB(double& res,
+                   REAL_TYPE* X,
+                   REAL_TYPE* B,
+                   double& flop,
+                   int s_type)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   res = 0.0;
+
+   TIMING_start("Blas_Clear");
+   blas_clear_(pcg_q , size, &gc);
+   TIMING_stop("Blas_Clear");
+
+   
+   TIMING_start("Blas_Residual");
+   flop_count = 0.0;
+   if (s_type==LS_BICGSTAB_MAF)
+   {
+     if (SW_mtr == 1)
+     {
+       calc_rk_mtr_(pcg_r, X, B, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+     }
+     else
+     {
+       calc_rk_maf_(pcg_r, X, B, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+     }
+   }
+   else
+   {
+     blas_calc_rk_(pcg_r, X, B, size, innerFidx, &gc, cf, &flop_count);
+   }
+   TIMING_stop("Blas_Residual", flop_count);
+   flop += flop_count;
+
+   
+   if ( !Comm_S(pcg_r, 1, "Comm_Poisson") ) return 0;
+
+   TIMING_start("Blas_Copy");
+   blas_copy_(pcg_r0, pcg_r, size, &gc);
+   TIMING_stop("Blas_Copy");
+
+   REAL_TYPE rho_old = 1.0;
+   REAL_TYPE alpha = 0.0;
+   REAL_TYPE omega  = 1.0;
+   REAL_TYPE r_omega = -omega;
+   
+   // (r, r0) 2反復目以降はblas_bicg_3_で残差と同時に求める
+   flop_count = 0.0;
+   REAL_TYPE rho = Fdot2(pcg_r, pcg_r0, flop_count);
+   flop += flop_count;
+
+   for (itr=1; itr<ItrMax; itr++)
+   {
+     if( fabs(rho) < FLT_MIN )
+     {
+       itr = 0;
+       break;
+     }
+
+     if( itr == 1 )
+     {
+       TIMING_start("Blas_Copy");
+       blas_copy_(pcg_p, pcg_r, size, &gc);
+       TIMING_stop("Blas_Copy");
+     }
+     else
+     {
+       REAL_TYPE beta = rho / rho_old * alpha / omega;
+
+       TIMING_start("Blas_BiCG_1");
+       flop_count = 0.0;
+       blas_bicg_1_(pcg_p, pcg_r, pcg_q, &beta, &omega, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("Blas_BiCG_1", flop_count);
+       flop += flop_count;
+     }
+
+     if ( !Comm_S(pcg_p, 1, "Comm_Poisson") ) return 0;
+
+     TIMING_start("Blas_Clear");
+     blas_clear_(pcg_p_ , size, &gc);
+     TIMING_stop("Blas_Clear");
+
+     flop_count = 0.0;
+     Preconditioner(pcg_p_, pcg_p, flop_count, pc_type);
+     flop += flop_count;
+
+     
+     // q = A p_ と (q, r0) を1パスで
+     REAL_TYPE qr0 = 0.0;
+     TIMING_start("Blas_AX_Dot");
+     flop_count = 0.0;
+     if (s_type==LS_BICGSTAB_MAF)
+     {
+       if (SW_mtr == 1)
+       {
+         calc_ax_mtr_(pcg_q, pcg_p_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+       }
+       else
+       {
+         calc_ax_maf_(pcg_q, pcg_p_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+       }
+       blas_dot2_(&qr0, pcg_q, pcg_r0, size, innerFidx, &gc, &flop_count);
+     }
+     else
+     {
+       blas_calc_ax_dot_(pcg_q, pcg_p_, pcg_r0, &qr0, size, innerFidx, &gc, cf, &flop_count);
+     }
+     TIMING_stop("Blas_AX_Dot", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_1(&qr0, "A_R_Dot") ) return 0;
+     alpha = rho / qr0;
+
+     
+     REAL_TYPE r_alpha = -alpha;
+     TIMING_start("Blas_TRIAD");
+     flop_count = 0.0;
+     blas_triad_(pcg_s, pcg_q, pcg_r, &r_alpha, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_TRIAD", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_S(pcg_s, 1, "Comm_Res_Poisson") ) return 0;
+
+     TIMING_start("Blas_Clear");
+     blas_clear_(pcg_s_ , size, &gc);
+     TIMING_stop("Blas_Clear");
+
+     flop_count = 0.0;
+     Preconditioner(pcg_s_, pcg_s, flop_count, pc_type);
+     flop += flop_count;
+
+     
+     // t_ = A s_ と (t_, s), (t_, t_) を1パスで
+     REAL_TYPE ts = 0.0;
+     REAL_TYPE tt = 0.0;
+     TIMING_start("Blas_AX_Dot");
+     flop_count = 0.0;
+     if (s_type==LS_BICGSTAB_MAF)
+     {
+       if (SW_mtr == 1)
+       {
+         calc_ax_mtr_(pcg_t_, pcg_s_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+       }
+       else
+       {
+         calc_ax_maf_(pcg_t_, pcg_s_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+       }
+       blas_dot2_(&ts, pcg_t_, pcg_s, size, innerFidx, &gc, &flop_count);
+       blas_dot1_(&tt, pcg_t_, size, innerFidx, &gc, &flop_count);
+     }
+     else
+     {
+       blas_calc_ax_dot2_(pcg_t_, pcg_s_, pcg_s, &ts, &tt, size, innerFidx, &gc, cf, &flop_count);
+     }
+     TIMING_stop("Blas_AX_Dot", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_2(&ts, &tt, "A_R_Dot") ) return 0;
+     omega = ts / tt;
+     r_omega = -omega;
+
+     // x, rの更新と (r, r), 次反復の(r, r0)を1パスで
+     REAL_TYPE rr  = 0.0;
+     REAL_TYPE rr0 = 0.0;
+     TIMING_start("Blas_BiCG_3");
+     flop_count = 0.0;
+     blas_bicg_3_(X, pcg_r, pcg_p_, pcg_s_, pcg_s, pcg_t_, pcg_r0,
+                  &alpha, &omega, &rr, &rr0,
+                  size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_BiCG_3", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+
+     if ( !Comm_SUM_2(&rr, &rr0, "Comm_Res_Poisson") ) return 0;
+
+     res = rr * res_normal;
+     res = sqrt(res);
+     Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+     
+     TIMING_start("BoundaryCondition");
+     bc_k_(size, &gc, X, pitch, origin, nID);
+     TIMING_stop("BoundaryCondition");
+
+     if ( res < eps ) break;
+
+     rho_old = rho;
+     rho = rr0;
+   } // itr
+
+   return itr;
+ }
+
+
+// #################################################################
+// @brief 前処理付きCG反復
+// @param [in,out] res    残差
+// @param [in,out] X      解ベクトル
+// @param [in]     B      RHSベクトル
+// @param [in]     flop   浮動小数点演算数
+// @note 係数行列は対称（負定値）なので，前処理も対称な ssor, sor2sma_sym, jacobi, mg を想定
+//       beta は Polak-Ribiere 形 -alpha (z, q) / rho_old とし，(z_new, r_old) を
+//       r_old = r_new + alpha q から求めて余分な配列を持たない
+//       対称前処理では通常のCGに一致し，MGのような僅かに非対称な前処理でも破綻しない
+//       作業配列は r, z, p, q の4本
+ int CZ::PCG(double& res,
+             REAL_TYPE* X,
+             REAL_TYPE* B,
+             double& flop)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   res = 0.0;
+
+   TIMING_start("Blas_Residual");
+   flop_count = 0.0;
+   blas_calc_rk_(pcg_r, X, B, size, innerFidx, &gc, cf, &flop_count);
+   TIMING_stop("Blas_Residual", flop_count);
+   flop += flop_count;
+
+   TIMING_start("Blas_Clear");
+   blas_clear_(pcg_z , size, &gc);
+   TIMING_stop("Blas_Clear");
+
+   flop_count = 0.0;
+   Preconditioner(pcg_z, pcg_r, flop_count, pc_type);
+   flop += flop_count;
+
+   flop_count = 0.0;
+   REAL_TYPE rho = Fdot2(pcg_z, pcg_r, flop_count);
+   flop += flop_count;
+
+   REAL_TYPE rho_old = 1.0;
+   REAL_TYPE alpha = 0.0;
+   REAL_TYPE zq = 0.0;
+
+   for (itr=1; itr<ItrMax; itr++)
+   {
+     if( fabs(rho) < FLT_MIN )
+     {
+       itr = 0;
+       break;
+     }
+
+     if( itr == 1 )
+     {
+       TIMING_start("Blas_Copy");
+       blas_copy_(pcg_p, pcg_z, size, &gc);
+       TIMING_stop("Blas_Copy");
+     }
+     else
+     {
+       REAL_TYPE beta = -alpha * zq / rho_old;
+
+       TIMING_start("Blas_CG_1");
+       flop_count = 0.0;
+       blas_cg_1_(pcg_p, pcg_z, &beta, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("Blas_CG_1", flop_count);
+       flop += flop_count;
+     }
+
+     if ( !Comm_S(pcg_p, 1, "Comm_Poisson") ) return 0;
+
+
+     // q = A p と (q, p) を1パスで
+     REAL_TYPE pq = 0.0;
+     TIMING_start("Blas_AX_Dot");
+     flop_count = 0.0;
+     blas_calc_ax_dot_(pcg_q, pcg_p, pcg_p, &pq, size, innerFidx, &gc, cf, &flop_count);
+     TIMING_stop("Blas_AX_Dot", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_1(&pq, "A_R_Dot") ) return 0;
+     alpha = rho / pq;
+
+
+     // x, rの更新と (r, r) を1パスで
+     REAL_TYPE rr = 0.0;
+     TIMING_start("Blas_CG_2");
+     flop_count = 0.0;
+     blas_cg_2_(X, pcg_r, pcg_p, pcg_q, &alpha, &rr, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_CG_2", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_1(&rr, "Comm_Res_Poisson") ) return 0;
+
+     res = rr * res_normal;
+     res = sqrt(res);
+     Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+
+     if ( res < eps ) break;
+
+
+     TIMING_start("Blas_Clear");
+     blas_clear_(pcg_z , size, &gc);
+     TIMING_stop("Blas_Clear");
+
+     flop_count = 0.0;
+     Preconditioner(pcg_z, pcg_r, flop_count, pc_type);
+     flop += flop_count;
+
+     // (z, r), (z, q) を1パスで
+     REAL_TYPE rz = 0.0;
+     zq = 0.0;
+     TIMING_start("Blas_CG_Dot");
+     flop_count = 0.0;
+     blas_cg_dot_(&rz, &zq, pcg_z, pcg_r, pcg_q, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_CG_Dot", flop_count);
+     flop += flop_count;
+
+     if ( !Comm_SUM_2(&rz, &zq, "A_R_Dot") ) return 0;
+
+     rho_old = rho;
+     rho = rz;
+   } // itr
+
+   if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+
+   TIMING_start("BoundaryCondition");
+   bc_k_(size, &gc, X, pitch, origin, nID);
+   TIMING_stop("BoundaryCondition");
+
+   return itr;
+ }
+
+
+// #################################################################
+// @brief パイプライン化PBiCGSTAB反復
+// @param [in,out] res    残差
+// @param [in,out] X      解ベクトル
+// @param [in]     B      RHSベクトル
+// @param [in]     flop   浮動小数点演算数
+// @param [in]     s_type ソルバーの指定
+// @note Cools and Vanroose (2017)の右前処理付きp-BiCGStab
+//       内積を反復あたり2回のAllreduceにまとめ，非同期で前処理とAXに重ねる
+//       前処理は線形（反復回数固定，ゼロ初期値）であること
+ int CZ::PipeBiCGSTAB(double& res,
+                      REAL_TYPE* X,
+                      REAL_TYPE* B,
+                      double& flop,
+                      int s_type)
+ {
+   int itr;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   res = 0.0;
+   
+   // 集約する内積 [0] (r0,r) [1] (r0,w) [2] (r0,s) [3] (r0,z) [4] (r,r)
+   double dt[5];
+   REAL_TYPE xy;
+   
+   // 漸化式で更新するベクトルのガイドセルはゼロのままにしておく
+   TIMING_start("Blas_Clear");
+   blas_clear_(pcg_p , size, &gc);
+   blas_clear_(pcg_p_, size, &gc);
+   blas_clear_(pcg_s , size, &gc);
+   blas_clear_(pcg_s_, size, &gc);
+   blas_clear_(pcg_z , size, &gc);
+   blas_clear_(pcg_z_, size, &gc);
+   blas_clear_(pcg_v , size, &gc);
+   blas_clear_(pcg_w , size, &gc);
+   TIMING_stop("Blas_Clear");
+   
+   
+   // r = b - Ax
+   TIMING_start("Blas_Residual");
+   flop_count = 0.0;
+   if (s_type==LS_PIPEBICGSTAB_MAF)
+   {
+     if (SW_mtr == 1)
+     {
+       calc_rk_mtr_(pcg_r, X, B, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+     }
+     else
+     {
+       calc_rk_maf_(pcg_r, X, B, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+     }
+   }
+   else
+   {
+     blas_calc_rk_(pcg_r, X, B, size, innerFidx, &gc, cf, &flop_count);
+   }
+   TIMING_stop("Blas_Residual", flop_count);
+   flop += flop_count;
+   
+   if ( !Comm_S(pcg_r, 1, "Comm_Poisson") ) return 0;
+   
+   TIMING_start("Blas_Copy");
+   blas_copy_(pcg_r0, pcg_r, size, &gc);
+   TIMING_stop("Blas_Copy");
+   
+   // r^ = M^-1 r, w = A r^
+   TIMING_start("Blas_Clear");
+   blas_clear_(pcg_r_ , size, &gc);
+   TIMING_stop("Blas_Clear");
+   
+   flop_count = 0.0;
+   Preconditioner(pcg_r_, pcg_r, flop_count, pc_type);
+   flop += flop_count;
+   
+   TIMING_start("Blas_AX");
+   flop_count = 0.0;
+   if (s_type==LS_PIPEBICGSTAB_MAF)
+   {
+     if (SW_mtr == 1)
+     {
+       calc_ax_mtr_(pcg_w, pcg_r_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+     }
+     else
+     {
+       calc_ax_maf_(pcg_w, pcg_r_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+     }
+   }
+   else
+   {
+     blas_calc_ax_(pcg_w, pcg_r_, size, innerFidx, &gc, cf, &flop_count);
+   }
+   TIMING_stop("Blas_AX", flop_count);
+   flop += flop_count;
+   
+   // (r0,r0), (r0,w)
+   TIMING_start("Dot2");
+   flop_count = 0.0;
+   blas_dot2_(&xy, pcg_r0, pcg_r, size, innerFidx, &gc, &flop_count); dt[0] = xy;
+   blas_dot2_(&xy, pcg_r0, pcg_w, size, innerFidx, &gc, &flop_count); dt[1] = xy;
+   TIMING_stop("Dot2", flop_count);
+   flop += flop_count;
+   
+   if ( !Comm_SUM_N_begin(dt, 2, "A_R_Dot") ) return 0;
+   
+   // w^ = M^-1 w, t = A w^
+   if ( !Comm_S(pcg_w, 1, "Comm_Poisson") ) return 0;
+   
+   TIMING_start("Blas_Clear");
+   blas_clear_(pcg_w_ , size, &gc);
+   TIMING_stop("Blas_Clear");
+   
+   flop_count = 0.0;
+   Preconditioner(pcg_w_, pcg_w, flop_count, pc_type);
+   flop += flop_count;
+   
+   TIMING_start("Blas_AX");
+   flop_count = 0.0;
+   if (s_type==LS_PIPEBICGSTAB_MAF)
+   {
+     if (SW_mtr == 1)
+     {
+       calc_ax_mtr_(pcg_t, pcg_w_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+     }
+     else
+     {
+       calc_ax_maf_(pcg_t, pcg_w_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+     }
+   }
+   else
+   {
+     blas_calc_ax_(pcg_t, pcg_w_, size, innerFidx, &gc, cf, &flop_count);
+   }
+   TIMING_stop("Blas_AX", flop_count);
+   flop += flop_count;
+   
+   if ( !Comm_SUM_N_end(dt, 2, "A_R_Dot") ) return 0;
+   
+   if( fabs(dt[1]) < FLT_MIN ) return 0;
+   
+   double rho_old = dt[0];
+   REAL_TYPE alpha = dt[0] / dt[1];
+   REAL_TYPE beta  = 0.0;
+   REAL_TYPE omega = 1.0;
+   
+   
+   for (itr=1; itr<ItrMax; itr++)
+   {
+     if( itr == 1 )
+     {
+       TIMING_start("Blas_Copy");
+       blas_copy_(pcg_p , pcg_r , size, &gc);
+       blas_copy_(pcg_p_, pcg_r_, size, &gc);
+       blas_copy_(pcg_s , pcg_w , size, &gc);
+       blas_copy_(pcg_s_, pcg_w_, size, &gc);
+       blas_copy_(pcg_z , pcg_t , size, &gc);
+       TIMING_stop("Blas_Copy");
+     }
+     else
+     {
+       // p = r + beta (p - omega s) ... 更新前のs, s^, zを参照するので順序に注意
+       TIMING_start("Blas_BiCG_1");
+       flop_count = 0.0;
+       blas_bicg_1_(pcg_p , pcg_r , pcg_s , &beta, &omega, size, innerFidx, &gc, &flop_count);
+       blas_bicg_1_(pcg_p_, pcg_r_, pcg_s_, &beta, &omega, size, innerFidx, &gc, &flop_count);
+       blas_bicg_1_(pcg_s , pcg_w , pcg_z , &beta, &omega, size, innerFidx, &gc, &flop_count);
+       blas_bicg_1_(pcg_s_, pcg_w_, pcg_z_, &beta, &omega, size, innerFidx, &gc, &flop_count);
+       blas_bicg_1_(pcg_z , pcg_t , pcg_v , &beta, &omega, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("Blas_BiCG_1", flop_count);
+       flop += flop_count;
+     }
+     
+     // q = r - alpha s, q^ = r^ - alpha s^, y = w - alpha z
+     REAL_TYPE r_alpha = -alpha;
+     TIMING_start("Blas_TRIAD");
+     flop_count = 0.0;
+     blas_triad_(pcg_q , pcg_s , pcg_r , &r_alpha, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_q_, pcg_s_, pcg_r_, &r_alpha, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_y , pcg_z , pcg_w , &r_alpha, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_TRIAD", flop_count);
+     flop += flop_count;
+     
+     // (q,y), (y,y)
+     TIMING_start("Dot2");
+     flop_count = 0.0;
+     blas_dot2_(&xy, pcg_q, pcg_y, size, innerFidx, &gc, &flop_count); dt[0] = xy;
+     blas_dot1_(&xy, pcg_y, size, innerFidx, &gc, &flop_count);        dt[1] = xy;
+     TIMING_stop("Dot2", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_N_begin(dt, 2, "A_R_Dot") ) return 0;
+     
+     // 集約と並行して z^ = M^-1 z, v = A z^
+     if ( !Comm_S(pcg_z, 1, "Comm_Poisson") ) return 0;
+     
+     TIMING_start("Blas_Clear");
+     blas_clear_(pcg_z_ , size, &gc);
+     TIMING_stop("Blas_Clear");
+     
+     flop_count = 0.0;
+     Preconditioner(pcg_z_, pcg_z, flop_count, pc_type);
+     flop += flop_count;
+     
+     TIMING_start("Blas_AX");
+     flop_count = 0.0;
+     if (s_type==LS_PIPEBICGSTAB_MAF)
+     {
+       if (SW_mtr == 1)
+       {
+         calc_ax_mtr_(pcg_v, pcg_z_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+       }
+       else
+       {
+         calc_ax_maf_(pcg_v, pcg_z_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+       }
+     }
+     else
+     {
+       blas_calc_ax_(pcg_v, pcg_z_, size, innerFidx, &gc, cf, &flop_count);
+     }
+     TIMING_stop("Blas_AX", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_N_end(dt, 2, "A_R_Dot") ) return 0;
+     
+     if( fabs(dt[1]) < FLT_MIN )
+     {
+       itr = 0;
+       break;
+     }
+     
+     omega = dt[0] / dt[1];
+     REAL_TYPE r_omega = -omega;
+     
+     // x = x + alpha p^ + omega q^
+     TIMING_start("Blas_BiCG_2");
+     flop_count = 0.0;
+     blas_bicg_2_(X, pcg_p_, pcg_q_, &alpha , &omega, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_BiCG_2", flop_count);
+     flop += flop_count;
+     
+     // r = q - omega y
+     // r^ = q^ - omega (w^ - alpha z^), w = y - omega (t - alpha v)
+     // w^, tは次の前処理とAXで上書きされるので作業域に使う
+     TIMING_start("Blas_TRIAD");
+     flop_count = 0.0;
+     blas_triad_(pcg_r , pcg_y , pcg_q , &r_omega, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_w_, pcg_z_, pcg_w_, &r_alpha, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_r_, pcg_w_, pcg_q_, &r_omega, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_t , pcg_v , pcg_t , &r_alpha, size, innerFidx, &gc, &flop_count);
+     blas_triad_(pcg_w , pcg_t , pcg_y , &r_omega, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("Blas_TRIAD", flop_count);
+     flop += flop_count;
+     
+     // (r0,r), (r0,w), (r0,s), (r0,z), (r,r)
+     TIMING_start("Dot2");
+     flop_count = 0.0;
+     blas_dot2_(&xy, pcg_r0, pcg_r, size, innerFidx, &gc, &flop_count); dt[0] = xy;
+     blas_dot2_(&xy, pcg_r0, pcg_w, size, innerFidx, &gc, &flop_count); dt[1] = xy;
+     blas_dot2_(&xy, pcg_r0, pcg_s, size, innerFidx, &gc, &flop_count); dt[2] = xy;
+     blas_dot2_(&xy, pcg_r0, pcg_z, size, innerFidx, &gc, &flop_count); dt[3] = xy;
+     blas_dot1_(&xy, pcg_r, size, innerFidx, &gc, &flop_count);         dt[4] = xy;
+     TIMING_stop("Dot2", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_N_begin(dt, 5, "A_R_Dot") ) return 0;
+     
+     // 集約と並行して w^ = M^-1 w, t = A w^
+     if ( !Comm_S(pcg_w, 1, "Comm_Poisson") ) return 0;
+     
+     TIMING_start("Blas_Clear");
+     blas_clear_(pcg_w_ , size, &gc);
+     TIMING_stop("Blas_Clear");
+     
+     flop_count = 0.0;
+     Preconditioner(pcg_w_, pcg_w, flop_count, pc_type);
+     flop += flop_count;
+     
+     TIMING_start("Blas_AX");
+     flop_count = 0.0;
+     if (s_type==LS_PIPEBICGSTAB_MAF)
+     {
+       if (SW_mtr == 1)
+       {
+         calc_ax_mtr_(pcg_t, pcg_w_, size, innerFidx, &gc, mtx, mty, mtz, pvt, &flop_count);
+       }
+       else
+       {
+         calc_ax_maf_(pcg_t, pcg_w_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
+       }
+     }
+     else
+     {
+       blas_calc_ax_(pcg_t, pcg_w_, size, innerFidx, &gc, cf, &flop_count);
+     }
+     TIMING_stop("Blas_AX", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_N_end(dt, 5, "A_R_Dot") ) return 0;
+     
+     res = sqrt( dt[4] * res_normal );
+     Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+     
+     if ( res < eps ) break;
+     
+     if( fabs(rho_old) < FLT_MIN || fabs(omega) < FLT_MIN )
+     {
+       itr = 0;
+       break;
+     }
+     
+     beta = (alpha / omega) * (dt[0] / rho_old);
+     
+     double den = dt[1] + beta * dt[2] - beta * omega * dt[3];
+     
+     if( fabs(den) < FLT_MIN )
+     {
+       itr = 0;
+       break;
+     }
+     
+     alpha = dt[0] / den;
+     rho_old = dt[0];
+   } // itr
+   
+   
+   // 解ベクトルのガイドセルは最後にまとめて更新
+   if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+   
+   TIMING_start("BoundaryCondition");
+   bc_k_(size, &gc, X, pitch, origin, nID);
+   TIMING_stop("BoundaryCondition");
+   
+   return itr;
+ }
+
+
+// #################################################################
+// @brief s-step BiCGSTABの基底変換行列 w = T v
+// @param [in]  s   反復数
+// @param [in]  sg  基底のスケール
+// @param [in]  th  シフト
+// @param [in]  v   係数ベクトル (4s+1)
+// @param [out] w   A Y v = Y w となる係数ベクトル
+// @note A y_j = sg y_{j+1} + th_j y_j，各ブロックの最後の列は次数が足りないのでゼロ
+static void ca_tmul(const int s, const double sg, const double* th, const double* v, double* w)
+{
+  const int ir = 2*s+1;
+
+  for (int i=0; i<4*s+1; i++) w[i] = 0.0;
+
+  for (int j=0; j<2*s; j++)
+  {
+    w[j]   += th[j] * v[j];
+    w[j+1] += sg    * v[j];
+  }
+
+  for (int j=0; j<2*s-1; j++)
+  {
+    w[ir+j]   += th[j] * v[ir+j];
+    w[ir+j+1] += sg    * v[ir+j];
+  }
+}
+
+
+// #################################################################
+// @brief Gram行列 G による内積 a^T G b
+static double ca_gdot(const int n, const double* G, const double* a, const double* b)
+{
+  double s = 0.0;
+
+  for (int m=0; m<n; m++)
+  {
+    double t = 0.0;
+    for (int l=0; l<n; l++) t += G[m*n+l] * b[l];
+    s += a[m] * t;
+  }
+
+  return s;
+}
+
+
+// #################################################################
+// @brief 係数ベクトル a の表すベクトルの桁落ちの度合い sum |a_l| |y_l| / |Y a|
+static double ca_cancel(const int n, const double* G, const double* a, const double aa)
+{
+  double s = 0.0;
+
+  for (int l=0; l<n; l++) s += fabs(a[l]) * sqrt(G[l*n+l]);
+
+  return (aa > 0.0) ? s / sqrt(aa) : DBL_MAX;
+}
+
+
+// #################################################################
+// @brief s-step（通信削減型）BiCGSTAB反復
+// @param [in,out] res    残差
+// @param [in,out] X      解ベクトル
+// @param [in]     B      RHSベクトル
+// @param [in,out] flop   浮動小数点演算数
+// @note Carson et al. (2013)のCA-BiCGSTAB，前処理なし
+//       外側反復毎に p, r から基底 Y = [P (2s+1本), R (2s本)] を作り，
+//       Gram行列 G = Y^T Y と g = Y^T r0 を1回のAllreduceで集計する
+//       内側の s 反復は Y 上の係数ベクトルで進めるので，大域通信は不要
+//       基底の行列ベクトル積は，1軸のみ分割の場合はガイドセル2層分を冗長計算して2回毎に通信する
+//       係数の桁落ちが CA_CANCEL_TOL を超える精度を失う場合は，外側反復を s 回より前で打ち切って基底を作り直す
+//       残差ノルムは r'^T G r' から求める．CZ_CA_RR 回毎に r = b - Ax で置き換えて誤差の蓄積を抑える
+ int CZ::CA_BiCGSTAB(double& res,
+                     REAL_TYPE* X,
+                     REAL_TYPE* B,
+                     double& flop)
+ {
+   int itr = 0;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   res = 0.0;
+   
+   const int s  = ca_s;
+   int nb = 4*s+1;   // 基底の本数
+   int ip = 0;       // Pの先頭列
+   int ir = 2*s+1;   // Rの先頭列
+   int ng = nb*(nb+1)/2;
+   size_t nx = Size_S3D(size);
+   
+   REAL_TYPE* pv = ca_y + ip*nx;
+   REAL_TYPE* rv = ca_y + ir*nx;
+   
+   // 集約する内積 G の上三角と g
+   double dt[(4*CA_S_MAX+1)*(4*CA_S_MAX+2)/2 + 4*CA_S_MAX+1];
+   double G[(4*CA_S_MAX+1)*(4*CA_S_MAX+1)];
+   double* g = dt + ng;
+   
+   // 係数ベクトル
+   double cp[4*CA_S_MAX+1], cr[4*CA_S_MAX+1], cx[4*CA_S_MAX+1];
+   double tp[4*CA_S_MAX+1], cq[4*CA_S_MAX+1], tq[4*CA_S_MAX+1];
+   
+   // 桁落ちの許容比 基底の格納精度と倍精度のGram行列の丸め誤差 (比の2乗に比例) の両方を抑える
+   double eps_y = (sizeof(REAL_TYPE) == sizeof(float)) ? FLT_EPSILON : DBL_EPSILON;
+   double cancel_max = CA_CANCEL_TOL / eps_y;
+   if ( cancel_max > sqrt(CA_CANCEL_TOL / DBL_EPSILON) ) cancel_max = sqrt(CA_CANCEL_TOL / DBL_EPSILON);
+   
+   // 冗長計算するガイドセルの層数
+   int ex[6];
+   int nt = getTBdepth(ex, true);
+   if ( nt > GUIDE ) nt = GUIDE;
+   int cg = 1;
+   for (int l=0; l<6; l++) if ( ex[l] ) cg = nt;
+   
+   
+   // r = b - Ax, r0 = p = r
+   TIMING_start("Blas_Residual");
+   flop_count = 0.0;
+   blas_calc_rk_(rv, X, B, size, innerFidx, &gc, cf, &flop_count);
+   TIMING_stop("Blas_Residual", flop_count);
+   flop += flop_count;
+   
+   TIMING_start("Blas_Copy");
+   blas_copy_(ca_rt, rv, size, &gc);
+   blas_copy_(pv, rv, size, &gc);
+   TIMING_stop("Blas_Copy");
+   
+   
+   int k;
+   
+   for (k=0; itr<ItrMax; k++)
+   {
+     // 基底 P = [p, T1 p, ..., T2s p], R = [r, T1 r, ..., T2s-1 r]
+     // 初回は p = r なので R を作らずに P だけで表す（G が特異になり係数が発散するのを避ける）
+     for (int c=0; c<((k == 0) ? 1 : 2); c++)
+     {
+       int c0 = (c == 0) ? ip : ir;
+       int nl = (c == 0) ? 2*s+1 : 2*s;
+       
+       for (int j=1; j<nl; j++)
+       {
+         REAL_TYPE* v  = ca_y + (c0+j-1)*nx;
+         REAL_TYPE* vn = ca_y + (c0+j)*nx;
+         int t = (j-1) % nt;
+         
+         if ( t == 0 ) {
+           if ( !Comm_S(v, cg, "Comm_Poisson") ) return 0;
+         }
+         
+         // 同期済みの層から1層ずつ狭める
+         int e = nt - 1 - t;
+         int ix[6];
+         for (int l=0; l<3; l++) {
+           ix[2*l]   = innerFidx[2*l]   - ex[2*l]   * e;
+           ix[2*l+1] = innerFidx[2*l+1] + ex[2*l+1] * e;
+         }
+         
+         REAL_TYPE a = 1.0 / ca_sg;
+         REAL_TYPE b = -ca_th[j-1] / ca_sg;
+         
+         TIMING_start("CA_Basis");
+         flop_count = 0.0;
+         ca_basis_(vn, v, size, ix, &gc, cf, &a, &b, &flop_count);
+         TIMING_stop("CA_Basis", flop_count);
+         flop += flop_count;
+       }
+     }
+     
+     
+     // G = Y^T Y, g = Y^T r0
+     TIMING_start("CA_Gram");
+     flop_count = 0.0;
+     ca_gram_(dt, g, ca_y, ca_rt, &nb, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("CA_Gram", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_N_begin(dt, ng+nb, "A_R_Dot") ) return 0;
+     if ( !Comm_SUM_N_end(dt, ng+nb, "A_R_Dot") ) return 0;
+     
+     int n = 0;
+     for (int m=0; m<nb; m++) {
+       for (int l=0; l<=m; l++) {
+         G[m*nb+l] = G[l*nb+m] = dt[n++];
+       }
+     }
+     
+     
+     // 係数ベクトル上の s 反復
+     for (int l=0; l<nb; l++) cp[l] = cr[l] = cx[l] = 0.0;
+     cp[ip] = 1.0;
+     cr[(k == 0) ? ip : ir] = 1.0;
+     
+     double rho = 0.0;
+     for (int l=0; l<nb; l++) rho += g[l] * cr[l];
+     
+     bool converged = false;
+     
+     for (int j=0; j<s; j++)
+     {
+       ca_tmul(s, ca_sg, ca_th, cp, tp);
+       
+       double den = 0.0;
+       for (int l=0; l<nb; l++) den += g[l] * tp[l];
+       
+       if ( fabs(den) < FLT_MIN || fabs(rho) < FLT_MIN )
+       {
+         if ( j == 0 ) return 0;
+         break;
+       }
+       
+       double alpha = rho / den;
+       
+       for (int l=0; l<nb; l++) cq[l] = cr[l] - alpha * tp[l];
+       
+       ca_tmul(s, ca_sg, ca_th, cq, tq);
+       
+       // 基底の条件が悪く内積の丸め誤差が大きい場合は，この外側反復をj反復で打ち切る
+       double tt = ca_gdot(nb, G, tq, tq);
+       if ( j > 0 && ca_cancel(nb, G, tq, tt) > cancel_max ) break;
+       if ( tt < FLT_MIN ) return 0;
+       
+       double omega = ca_gdot(nb, G, cq, tq) / tt;
+       
+       for (int l=0; l<nb; l++)
+       {
+         cx[l] += alpha * cp[l] + omega * cq[l];
+         cr[l]  = cq[l] - omega * tq[l];
+       }
+       
+       double rho_new = 0.0;
+       for (int l=0; l<nb; l++) rho_new += g[l] * cr[l];
+       
+       double beta = rho_new / rho * alpha / omega;
+       
+       for (int l=0; l<nb; l++) cp[l] = cr[l] + beta * (cp[l] - omega * tp[l]);
+       
+       rho = rho_new;
+       itr++;
+       
+       double rr = ca_gdot(nb, G, cr, cr);
+       if ( rr < 0.0 ) rr = 0.0;
+       
+       res = sqrt(rr * res_normal);
+       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+       
+       if ( res < eps ) converged = true;
+       if ( converged || itr >= ItrMax ) break;
+     }
+     
+     
+     // x += Y x', p = Y p', r = Y r'
+     TIMING_start("CA_Update");
+     flop_count = 0.0;
+     ca_update_(X, ca_y, cx, cp, cr, &nb, &ip, &ir, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("CA_Update", flop_count);
+     flop += flop_count;
+     
+     if ( converged ) { k++; break; }
+     
+     // 残差の置き換え
+     if ( ca_rr > 0 && (k+1) % ca_rr == 0 )
+     {
+       if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+       
+       TIMING_start("Blas_Residual");
+       flop_count = 0.0;
+       blas_calc_rk_(rv, X, B, size, innerFidx, &gc, cf, &flop_count);
+       TIMING_stop("Blas_Residual", flop_count);
+       flop += flop_count;
+     }
+   } // k
+   
+   Hostonly_ printf("\tAllreduce of Gram = %d (%.2f iterations each)\n", k, (double)itr/(double)k);
+   
+   
+   // 解ベクトルのガイドセルは最後にまとめて更新
+   if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+   
+   TIMING_start("BoundaryCondition");
+   bc_k_(size, &gc, X, pitch, origin, nID);
+   TIMING_stop("BoundaryCondition");
+   
+   return itr;
+ }
+
+
+// #################################################################
+// @brief 前処理付きFlexible GMRES(m)反復
+// @param [in,out] res    残差
+// @param [in,out] X      解ベクトル
+// @param [in]     B      RHSベクトル
+// @param [in,out] flop   浮動小数点演算数
+// @note Saad (1993)のFGMRES，右前処理 z_j = M_j^{-1} v_j を Z に保持し x += Z y で更新する
+//       前処理が反復毎に変わってよいので，固定反復の定常法や内側のKrylov法を使える
+//       pbicgstab は相対残差 GMRES_INNER_EPS まで解く（内側は前処理なし）
+//       直交化は古典Gram-Schmidtの2回反復（CGS2），各回の内積を1回のAllreduceで集計する
+//       2回目の内積で (w, w) も求め，ノルムの計算にAllreduceを追加しない
+//       残差ノルムはGivens回転の値を使い，リスタート時に r = b - Ax を陽に計算する
+ int CZ::FGMRES(double& res,
+                REAL_TYPE* X,
+                REAL_TYPE* B,
+                double& flop)
+ {
+   int itr = 0;
+   double flop_count = 0.0;
+   int gc = GUIDE;
+   res = 0.0;
+   
+   const int m  = gm_m;
+   const int ld = GMRES_M_MAX+1;
+   size_t nx = Size_S3D(size);
+   
+   // Hessenberg行列（列順），Givens回転，右辺
+   double H[(GMRES_M_MAX+1)*GMRES_M_MAX];
+   double h[GMRES_M_MAX+2], h2[GMRES_M_MAX+2];
+   double cs[GMRES_M_MAX], sn[GMRES_M_MAX];
+   double g[GMRES_M_MAX+1], y[GMRES_M_MAX];
+   double one = 1.0;
+   int n0 = 0;
+   
+   bool converged = false;
+   
+   while ( itr < ItrMax )
+   {
+     REAL_TYPE* v0 = gm_v;
+     
+     // v0 = (b - Ax) / |b - Ax|
+     TIMING_start("Blas_Residual");
+     flop_count = 0.0;
+     blas_calc_rk_(v0, X, B, size, innerFidx, &gc, cf, &flop_count);
+     TIMING_stop("Blas_Residual", flop_count);
+     flop += flop_count;
+     
+     TIMING_start("GMRES_Dot");
+     flop_count = 0.0;
+     gmres_mdot_(h, gm_v, v0, &n0, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("GMRES_Dot", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_SUM_1(&h[0], "A_R_Dot") ) return 0;
+     
+     double beta = sqrt(h[0]);
+     res = beta * sqrt(res_normal);
+     
+     if ( itr > 0 && res < eps ) break;
+     if ( beta < FLT_MIN ) return 0;
+     
+     double a = 1.0 / beta;
+     TIMING_start("GMRES_AXPY");
+     flop_count = 0.0;
+     gmres_maxpy_(v0, gm_v, h, &a, &n0, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("GMRES_AXPY", flop_count);
+     flop += flop_count;
+     
+     g[0] = beta;
+     
+     int j;
+     
+     for (j=0; j<m && itr<ItrMax; j++)
+     {
+       REAL_TYPE* v = gm_v + j*nx;
+       REAL_TYPE* w = gm_v + (j+1)*nx;
+       REAL_TYPE* z = gm_z + j*nx;
+       int n  = j+1;
+       
+       if ( !Comm_S(v, 1, "Comm_Poisson") ) return 0;
+       
+       TIMING_start("Blas_Clear");
+       blas_clear_(z, size, &gc);
+       TIMING_stop("Blas_Clear");
+       
+       // z = M_j^{-1} v
+       flop_count = 0.0;
+       if ( pc_type == LS_BICGSTAB )
+       {
+         double eps_outer = eps;
+         double res_inner = 0.0;
+         eps = GMRES_INNER_EPS * sqrt(res_normal);
+         PBiCGSTAB(res_inner, z, v, flop_count, LS_BICGSTAB);
+         eps = eps_outer;
+         
+         // PBiCGSTABは境界条件を与えて終わるので，内点以外をゼロに戻す
+         TIMING_start("Blas_Copy");
+         blas_clear_(w, size, &gc);
+         blas_copy_idx_(w, z, size, innerFidx, &gc);
+         blas_copy_(z, w, size, &gc);
+         TIMING_stop("Blas_Copy");
+         
+         if ( !Comm_S(z, 1, "Comm_Poisson") ) return 0;
+       }
+       else
+       {
+         Preconditioner(z, v, flop_count, pc_type);
+       }
+       flop += flop_count;
+       
+       // w = A z
+       TIMING_start("Blas_AX");
+       flop_count = 0.0;
+       blas_calc_ax_(w, z, size, innerFidx, &gc, cf, &flop_count);
+       TIMING_stop("Blas_AX", flop_count);
+       flop += flop_count;
+       
+       // CGS2 1回目 h = V^T w, w = w - V h
+       TIMING_start("GMRES_Dot");
+       flop_count = 0.0;
+       gmres_mdot_(h, gm_v, w, &n, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("GMRES_Dot", flop_count);
+       flop += flop_count;
+       
+       if ( !Comm_SUM_N_begin(h, n+1, "A_R_Dot") ) return 0;
+       if ( !Comm_SUM_N_end(h, n+1, "A_R_Dot") ) return 0;
+       
+       TIMING_start("GMRES_AXPY");
+       flop_count = 0.0;
+       gmres_maxpy_(w, gm_v, h, &one, &n, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("GMRES_AXPY", flop_count);
+       flop += flop_count;
+       
+       // CGS2 2回目 h2 = V^T w と (w, w)
+       TIMING_start("GMRES_Dot");
+       flop_count = 0.0;
+       gmres_mdot_(h2, gm_v, w, &n, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("GMRES_Dot", flop_count);
+       flop += flop_count;
+       
+       if ( !Comm_SUM_N_begin(h2, n+1, "A_R_Dot") ) return 0;
+       if ( !Comm_SUM_N_end(h2, n+1, "A_R_Dot") ) return 0;
+       
+       // 射影後のノルム |w - V h2|^2 = (w, w) - |h2|^2
+       double hn = h2[n];
+       for (int l=0; l<n; l++) hn -= h2[l] * h2[l];
+       hn = (hn > 0.0) ? sqrt(hn) : 0.0;
+       
+       a = (hn > 0.0) ? 1.0 / hn : 0.0;
+       TIMING_start("GMRES_AXPY");
+       flop_count = 0.0;
+       gmres_maxpy_(w, gm_v, h2, &a, &n, size, innerFidx, &gc, &flop_count);
+       TIMING_stop("GMRES_AXPY", flop_count);
+       flop += flop_count;
+       
+       double* hj = H + j*ld;
+       for (int l=0; l<n; l++) hj[l] = h[l] + h2[l];
+       hj[n] = hn;
+       
+       // これまでのGivens回転を適用し，新しい回転で hj[n] を消去
+       for (int l=0; l<j; l++)
+       {
+         double t = cs[l] * hj[l] + sn[l] * hj[l+1];
+         hj[l+1]  = -sn[l] * hj[l] + cs[l] * hj[l+1];
+         hj[l]    = t;
+       }
+       
+       double d = sqrt(hj[j]*hj[j] + hn*hn);
+       if ( d < DBL_MIN ) return 0;
+       
+       cs[j] = hj[j] / d;
+       sn[j] = hn / d;
+       hj[j] = d;
+       hj[n] = 0.0;
+       g[n]  = -sn[j] * g[j];
+       g[j]  =  cs[j] * g[j];
+       
+       itr++;
+       
+       res = fabs(g[n]) * sqrt(res_normal);
+       Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
+       
+       if ( res < eps ) converged = true;
+       
+       // 部分空間に厳密解を含む（幸運な破綻）
+       if ( converged || hn == 0.0 ) { j++; break; }
+     } // j
+     
+     
+     // H y = g を後退代入，maxpyで足し込むため符号を反転して -y を保持
+     for (int l=j-1; l>=0; l--)
+     {
+       double t = g[l];
+       for (int k=l+1; k<j; k++) t += H[k*ld+l] * y[k];
+       y[l] = -t / H[l*ld+l];
+     }
+     
+     // x += Z y
+     TIMING_start("GMRES_AXPY");
+     flop_count = 0.0;
+     gmres_maxpy_(X, gm_z, y, &one, &j, size, innerFidx, &gc, &flop_count);
+     TIMING_stop("GMRES_AXPY", flop_count);
+     flop += flop_count;
+     
+     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+     
+     if ( converged ) break;
+   }
+   
+   TIMING_start("BoundaryCondition");
+   bc_k_(size, &gc, X, pitch, origin, nID);
+   TIMING_stop("BoundaryCondition");
+   
+   return itr;
+ }
+
+
+// #################################################################
+// @brief 対称半正定値の小さな連立方程式 G a = g
+// @param [in]     n  次元
+// @param [in,out] G  係数行列（消去で壊れる）
+// @param [in,out] g  右辺（消去で壊れる）
+// @param [out]    a  解
+// @note ピボットが元の対角の WARM_DROP_TOL 倍以下の基底は従属とみなし，係数をゼロにする
+static void ws_solve(const int n, double* G, double* g, double* a)
+{
+  double tol[WARM_K_MAX];
+  bool drop[WARM_K_MAX];
+  
+  for (int l=0; l<n; l++)
+  {
+    tol[l]  = G[l*n+l] * WARM_DROP_TOL;
+    drop[l] = false;
+  }
+  
+  for (int k=0; k<n; k++)
+  {
+    if ( !(G[k*n+k] > tol[k]) ) { drop[k] = true; continue; }
+    
+    for (int i=k+1; i<n; i++)
+    {
+      double f = G[i*n+k] / G[k*n+k];
+      for (int j=k; j<n; j++) G[i*n+j] -= f * G[k*n+j];
+      g[i] -= f * g[k];
+    }
+  }
+  
+  for (int k=n-1; k>=0; k--)
+  {
+    a[k] = 0.0;
+    if ( drop[k] ) continue;
+    
+    double t = g[k];
+    for (int j=k+1; j<n; j++) t -= G[k*n+j] * a[j];
+    a[k] = t / G[k*n+k];
+  }
+}
+
+
+// #################################################################
+// @brief 繰り返し求解の初期値
+// @param [out]    X      初期値（境界条件とガイドセルを含む）
+// @param [in]     B      RHSベクトル
+// @param [in,out] flop   浮動小数点演算数
+// @note 直近の n (<=K) 本の解 x_0, x_1, ... (x_0が最新) から推定する
+//       ws_type=1 等間隔の多項式外挿 x = sum (-1)^a C(n, a+1) x_a（n=1は前回の解）
+//       ws_type=2 x = x_0 + sum_{a>0} c_a (x_a - x_0) の残差 |b - Ax| を最小にする c_a
+//                 A(x_a - x_0) = r_0 - r_a なので，過去の解の残差から1回のAllreduceで正規方程式を作る
+//       係数の和は1なので境界値は保たれるが，丸め誤差を避けるため最後に境界条件を与え直す
+//       過去の解がない場合と ws_type=0 はゼロから始める
+bool CZ::InitialGuess(REAL_TYPE* X, REAL_TYPE* B, double& flop)
+{
+  double flop_count = 0.0;
+  int gc = GUIDE;
+  size_t nx = Size_S3D(size);
+  
+  int n = (ws_cnt < ws_k) ? ws_cnt : ws_k;
+  if ( ws_type == 0 ) n = 0;
+  
+  // 古い順の位置 slot[a] とリングバッファ上の係数 h
+  int slot[WARM_K_MAX];
+  double h[WARM_K_MAX];
+  
+  for (int l=0; l<WARM_K_MAX; l++) h[l] = 0.0;
+  for (int a=0; a<n; a++) slot[a] = (ws_cnt-1-a) % ws_k;
+  
+  if ( ws_type == 1 )
+  {
+    double c = 1.0; // 二項係数 C(n, a+1)
+    for (int a=0; a<n; a++)
+    {
+      c *= (double)(n-a) / (double)(a+1);
+      h[slot[a]] = (a % 2 == 0) ? c : -c;
+    }
+  }
+  else if ( ws_type == 2 && n > 0 )
+  {
+    int nb = n-1;
+    double dt[WARM_K_MAX*(WARM_K_MAX+1)/2 + WARM_K_MAX];
+    double G[WARM_K_MAX*WARM_K_MAX];
+    double c[WARM_K_MAX];
+    int ng = nb*(nb+1)/2;
+    double* g = dt + ng;
+    
+    // ws_r の先頭に r_0，以降に A(x_a - x_0) = r_0 - r_a を並べる
+    REAL_TYPE* r0 = ws_r;
+    REAL_TYPE m1 = -1.0;
+    
+    TIMING_start("Blas_Residual");
+    flop_count = 0.0;
+    for (int a=0; a<n; a++)
+    {
+      blas_calc_rk_(ws_r + a*nx, ws_x + slot[a]*nx, B, size, innerFidx, &gc, cf, &flop_count);
+    }
+    TIMING_stop("Blas_Residual", flop_count);
+    flop += flop_count;
+    
+    TIMING_start("Blas_TRIAD");
+    flop_count = 0.0;
+    for (int a=1; a<n; a++)
+    {
+      blas_triad_(ws_r + a*nx, ws_r + a*nx, r0, &m1, size, innerFidx, &gc, &flop_count);
+    }
+    TIMING_stop("Blas_TRIAD", flop_count);
+    flop += flop_count;
+    
+    for (int l=0; l<nb; l++) c[l] = 0.0;
+    
+    if ( nb > 0 )
+    {
+      TIMING_start("CA_Gram");
+      flop_count = 0.0;
+      ca_gram_(dt, g, ws_r + nx, r0, &nb, size, innerFidx, &gc, &flop_count);
+      TIMING_stop("CA_Gram", flop_count);
+      flop += flop_count;
+      
+      if ( !Comm_SUM_N_begin(dt, ng+nb, "A_R_Dot") ) return false;
+      if ( !Comm_SUM_N_end(dt, ng+nb, "A_R_Dot") ) return false;
+      
+      int k = 0;
+      for (int m=0; m<nb; m++) {
+        for (int l=0; l<=m; l++) {
+          G[m*nb+l] = G[l*nb+m] = dt[k++];
+        }
+      }
+      
+      ws_solve(nb, G, g, c);
+    }
+    
+    h[slot[0]] = 1.0;
+    for (int a=1; a<n; a++)
+    {
+      h[slot[a]]  = c[a-1];
+      h[slot[0]] -= c[a-1];
+    }
+  }
+  
+  TIMING_start("Blas_Clear");
+  blas_clear_(X, size, &gc);
+  TIMING_stop("Blas_Clear");
+  
+  // x = sum h_l x_l, maxpyで足し込むため符号を反転する
+  if ( n > 0 )
+  {
+    int nk = (ws_cnt < ws_k) ? ws_cnt : ws_k;
+    double one = 1.0;
+    for (int l=0; l<nk; l++) h[l] = -h[l];
+    
+    TIMING_start("GMRES_AXPY");
+    flop_count = 0.0;
+    gmres_maxpy_(X, ws_x, h, &one, &nk, size, innerFidx, &gc, &flop_count);
+    TIMING_stop("GMRES_AXPY", flop_count);
+    flop += flop_count;
+  }
+  
+  TIMING_start("BoundaryCondition");
+  bc_k_(size, &gc, X, pitch, origin, nID);
+  TIMING_stop("BoundaryCondition");
+  
+  if ( !Comm_S(X, 1, "Comm_Poisson") ) return false;
+  
+  return true;
+}
+
+
+// #################################################################
+// @brief 求めた解を初期値の推定用に保持
+// @param [in] X  解ベクトル（ガイドセルは同期済み）
+// @note K本を超えると最も古い解を上書きする
+void CZ::storeSolution(REAL_TYPE* X)
+{
+  int gc = GUIDE;
+  size_t nx = Size_S3D(size);
+  
+  if ( ws_type == 0 ) return;
+  
+  TIMING_start("Blas_Copy");
+  blas_copy_(ws_x + (ws_cnt % ws_k)*nx, X, size, &gc);
+  TIMING_stop("Blas_Copy");
+  
+  ws_cnt++;
+}
+
+
+// #################################################################
+// @brief 複数のRHSを一括で解く
+// @param [out]    res    RHS毎の残差
+// @param [in,out] X      解ベクトルの配列（初期値，境界条件とガイドセルを含む）
+// @param [in]     B      RHSベクトルの配列
+// @param [in]     nr     RHSの本数 (<=bt_n)
+// @param [in,out] flop   浮動小数点演算数
+// @retval 反復数，エラーの場合は0
+// @note RHSの番号を最内にした配列へ詰め替え，係数とステンシルの参照，袖通信，
+//       内積のAllreduceを nr 本で共有する．反復数は最も遅いRHSで決まる
+//       sor2sma と pbicgstab（前処理 sor2sma またはなし）に対応する
+int CZ::SolveBatch(double* res, REAL_TYPE** X, REAL_TYPE** B, const int nr, double& flop)
+{
+  int itr=0;
+  int gc = GUIDE;
+  int n = nr;
+  size_t nb = Size_S3D(size) * (size_t)nr;
+  REAL_TYPE* xb = bt_w;
+  REAL_TYPE* bb = bt_w + nb;
+
+  TIMING_start("Batch_Pack");
+  for (int m=0; m<nr; m++)
+  {
+    batch_pack_(xb, X[m], &n, &m, size, &gc);
+    batch_pack_(bb, B[m], &n, &m, size, &gc);
+  }
+  TIMING_stop("Batch_Pack");
+
+  switch (ls_type)
+  {
+    case LS_SOR2SMA:
+      if ( 0 == (itr=RBSOR_batch(res, xb, bb, nr, ItrMax, flop)) ) return 0;
+      break;
+
+    case LS_BICGSTAB:
+      if ( 0 == (itr=PBiCGSTAB_batch(res, xb, bb, nr, flop)) ) return 0;
+      break;
+
+    default:
+      Hostonly_ printf("\tBatch solve is not available for %s.\n", printMethod(ls_type).c_str());
+      return 0;
+  }
+
+  TIMING_start("Batch_Pack");
+  for (int m=0; m<nr; m++)
+  {
+    batch_unpack_(X[m], xb, &n, &m, size, &gc);
+  }
+  TIMING_stop("Batch_Pack");
+
+  return itr;
+}
+
+
+// #################################################################
+// @brief 一括求解の2色SOR
+// @param [out]    res    RHS毎の残差
+// @param [in,out] X      解ベクトル X(nr, k, i, j)
+// @param [in]     B      RHSベクトル B(nr, k, i, j)
+// @param [in]     nr     RHSの本数
+// @param [in]     itr_max 最大反復数
+// @param [in,out] flop   浮動小数点演算数
+// @param [in]     converge_check 0のとき、収束判定しない
+// @note 1色分の掃引で nr 本を同時に更新し，袖通信は1面1メッセージ
+//       収束判定は全てのRHSの残差がepsを下回ったとき
+int CZ::RBSOR_batch(double* res, REAL_TYPE* X, REAL_TYPE* B, const int nr,
+                    const int itr_max, double& flop,
+                    bool converge_check)
+{
+  int itr;
+  double flop_count = 0.0;
+  int gc = GUIDE;
+  int n = nr;
+
+  int ip = 0;
+  if ( numProc > 1 )
+  {
+    ip = (head[0] + head[1] + head[2]+1) % 2;
+  }
+
+  for (itr=1; itr<=itr_max; itr++)
+  {
+    for (int m=0; m<nr; m++) res[m] = 0.0;
+
+    TIMING_start("Batch_SOR2SMA_kernel");
+    flop_count = 0.0;
+    for (int color=0; color<2; color++)
+    {
+      batch_sor2sma_(X, size, innerFidx, &gc, cf, &ip, &color, &ac1, B, &n, res, &flop_count);
+    }
+    TIMING_stop("Batch_SOR2SMA_kernel", flop_count);
+    flop += flop_count;
+
+    if ( !Comm_S_batch(X, nr, 1, "Comm_Batch") ) return 0;
+
+    if ( converge_check ) {
+      if ( !Comm_SUM_N_begin(res, nr, "Comm_Res_Poisson") ) return 0;
+      if ( !Comm_SUM_N_end(res, nr, "Comm_Res_Poisson") ) return 0;
+
+      double res_max = 0.0;
+      for (int m=0; m<nr; m++)
+      {
+        res[m] = sqrt(res[m] * res_normal);
+        if ( res[m] > res_max ) res_max = res[m];
+      }
+      Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res_max);
+
+      if ( res_max < eps ) break;
+    }
+
+  } // Iteration
+
+  return itr;
+}
+
+
+// #################################################################
+// @brief 一括求解の前処理
+// @param [out]    xx     解ベクトル（ゼロで初期化済み）
+// @param [in]     bb     RHSベクトル
+// @param [in]     nr     RHSの本数
+// @param [in,out] flop   浮動小数点演算数
+// @note pc_type が sor2sma のとき RBSOR_batch を8反復，それ以外は前処理なし
+void CZ::Preconditioner_batch(REAL_TYPE* xx, REAL_TYPE* bb, const int nr, double& flop)
+{
+  int gc = GUIDE;
+  int n = nr;
+  double res[BATCH_MAX];
+
+  if ( pc_type == LS_SOR2SMA )
+  {
+    RBSOR_batch(res, xx, bb, nr, 8, flop, false);
+  }
+  else
+  {
+    batch_copy_(xx, bb, &n, size, &gc);
+  }
+}
+
+
+// #################################################################
+// @brief 一括求解のPBiCGSTAB反復
+// @param [out]    res    RHS毎の残差
+// @param [in,out] X      解ベクトル X(nr, k, i, j)
+// @param [in]     B      RHSベクトル B(nr, k, i, j)
+// @param [in]     nr     RHSの本数
+// @param [in,out] flop   浮動小数点演算数
+// @note alpha, omega, beta はRHS毎に持ち，内積は nr 本分を1回のAllreduceで集計する
+//       収束したRHSは alpha = omega = beta = 0 として x, r を凍結し，残りの反復を続ける
+int CZ::PBiCGSTAB_batch(double* res, REAL_TYPE* X, REAL_TYPE* B, const int nr, double& flop)
+{
+  int itr;
+  double flop_count = 0.0;
+  int gc = GUIDE;
+  int n = nr;
+  size_t nb = Size_S3D(size) * (size_t)nr;
+
+  REAL_TYPE* p  = bt_w + nb*2;
+  REAL_TYPE* p_ = bt_w + nb*3;
+  REAL_TYPE* r  = bt_w + nb*4;
+  REAL_TYPE* r0 = bt_w + nb*5;
+  REAL_TYPE* q  = bt_w + nb*6;
+  REAL_TYPE* s  = bt_w + nb*7;
+  REAL_TYPE* s_ = bt_w + nb*8;
+  REAL_TYPE* t_ = bt_w + nb*9;
+
+  double rho[BATCH_MAX], rho_old[BATCH_MAX];
+  double alpha[BATCH_MAX], r_alpha[BATCH_MAX];
+  double omega[BATCH_MAX], beta[BATCH_MAX];
+  double qr0[BATCH_MAX];
+  double tst[2*BATCH_MAX]; // (t_, s), (t_, t_)
+  double rrr[2*BATCH_MAX]; // (r, r), (r, r0)
+  bool conv[BATCH_MAX];
+
+  TIMING_start("Blas_Clear");
+  batch_clear_(q, &n, size, &gc);
+  TIMING_stop("Blas_Clear");
+
+  TIMING_start("Blas_Residual");
+  flop_count = 0.0;
+  batch_calc_rk_(r, X, B, &n, size, innerFidx, &gc, cf, &flop_count);
+  TIMING_stop("Blas_Residual", flop_count);
+  flop += flop_count;
+
+  if ( !Comm_S_batch(r, nr, 1, "Comm_Batch") ) return 0;
+
+  TIMING_start("Blas_Copy");
+  batch_copy_(r0, r, &n, size, &gc);
+  TIMING_stop("Blas_Copy");
+
+  TIMING_start("Dot2");
+  flop_count = 0.0;
+  batch_dot2_(rho, r, r0, &n, size, innerFidx, &gc, &flop_count);
+  TIMING_stop("Dot2", flop_count);
+  flop += flop_count;
+
+  if ( !Comm_SUM_N_begin(rho, nr, "A_R_Dot") ) return 0;
+  if ( !Comm_SUM_N_end(rho, nr, "A_R_Dot") ) return 0;
+
+  for (int m=0; m<nr; m++)
+  {
+    rho_old[m] = 1.0;
+    alpha[m] = 0.0;
+    omega[m] = 1.0;
+    conv[m] = false;
+  }
 
-       TIMING_start("Blas_BiCG_1");
-       flop_count = 0.0;
-       blas_bicg_1_(pcg_p, pcg_r, pcg_q, &beta, &omega, size, innerFidx, &gc, &flop_count);
-       TIMING_stop("Blas_BiCG_1", flop_count);
-       flop += flop_count;
-     }
+  for (itr=1; itr<ItrMax; itr++)
+  {
+    for (int m=0; m<nr; m++)
+    {
+      if ( !conv[m] && fabs(rho[m]) < FLT_MIN ) return 0;
+    }
 
-     if ( !Comm_S(pcg_p, 1, "Comm_Poisson") ) return 0;
+    if( itr == 1 )
+    {
+      TIMING_start("Blas_Copy");
+      batch_copy_(p, r, &n, size, &gc);
+      TIMING_stop("Blas_Copy");
+    }
+    else
+    {
+      for (int m=0; m<nr; m++)
+      {
+        beta[m] = conv[m] ? 0.0 : rho[m] / rho_old[m] * alpha[m] / omega[m];
+      }
 
-     TIMING_start("Blas_Clear");
-     blas_clear_(pcg_p_ , size, &gc);
-     TIMING_stop("Blas_Clear");
+      TIMING_start("Blas_BiCG_1");
+      flop_count = 0.0;
+      batch_bicg_1_(p, r, q, beta, omega, &n, size, innerFidx, &gc, &flop_count);
+      TIMING_stop("Blas_BiCG_1", flop_count);
+      flop += flop_count;
+    }
 
-     flop_count = 0.0;
-     Preconditioner(pcg_p_, pcg_p, flop_count, pc_type);
-     flop += flop_count;
+    if ( !Comm_S_batch(p, nr, 1, "Comm_Batch") ) return 0;
 
-     
-     TIMING_start("Blas_AX");
-     flop_count = 0.0;
-     if (s_type==LS_BICGSTAB_MAF)
-     {
-       calc_ax_maf_(pcg_q, pcg_p_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
-     }
-     else
-     {
-       blas_calc_ax_(pcg_q, pcg_p_, size, innerFidx, &gc, cf, &flop_count);
-     }
-     TIMING_stop("Blas_AX", flop_count);
-     flop += flop_count;
+    TIMING_start("Blas_Clear");
+    batch_clear_(p_, &n, size, &gc);
+    TIMING_stop("Blas_Clear");
 
-     flop_count = 0.0;
-     alpha = rho / Fdot2(pcg_q, pcg_r0, flop_count);
-     flop += flop_count;
+    Preconditioner_batch(p_, p, nr, flop);
 
-     
-     REAL_TYPE r_alpha = -alpha;
-     TIMING_start("Blas_TRIAD");
-     flop_count = 0.0;
-     blas_triad_(pcg_s, pcg_q, pcg_r, &r_alpha, size, innerFidx, &gc, &flop_count);
-     TIMING_stop("Blas_TRIAD", flop_count);
-     flop += flop_count;
+    // q = A p_ と (q, r0) を1パスで
+    TIMING_start("Blas_AX_Dot");
+    flop_count = 0.0;
+    batch_calc_ax_dot_(q, p_, r0, qr0, &n, size, innerFidx, &gc, cf, &flop_count);
+    TIMING_stop("Blas_AX_Dot", flop_count);
+    flop += flop_count;
 
-     if ( !Comm_S(pcg_s, 1, "Comm_Res_Poisson") ) return 0;
+    if ( !Comm_SUM_N_begin(qr0, nr, "A_R_Dot") ) return 0;
+    if ( !Comm_SUM_N_end(qr0, nr, "A_R_Dot") ) return 0;
 
-     TIMING_start("Blas_Clear");
-     blas_clear_(pcg_s_ , size, &gc);
-     TIMING_stop("Blas_Clear");
+    for (int m=0; m<nr; m++)
+    {
+      alpha[m] = conv[m] ? 0.0 : rho[m] / qr0[m];
+      r_alpha[m] = -alpha[m];
+    }
 
-     flop_count = 0.0;
-     Preconditioner(pcg_s_, pcg_s, flop_count, pc_type);
-     flop += flop_count;
+    TIMING_start("Blas_TRIAD");
+    flop_count = 0.0;
+    batch_triad_(s, q, r, r_alpha, &n, size, innerFidx, &gc, &flop_count);
+    TIMING_stop("Blas_TRIAD", flop_count);
+    flop += flop_count;
 
-     
-     TIMING_start("Blas_AX");
-     flop_count = 0.0;
-     if (s_type==LS_BICGSTAB_MAF)
-     {
-       calc_ax_maf_(pcg_t_, pcg_s_, size, innerFidx, &gc, xc, yc, zc, pvt, &flop_count);
-     }
-     else
-     {
-       blas_calc_ax_(pcg_t_, pcg_s_, size, innerFidx, &gc, cf, &flop_count);
-     }
-     TIMING_stop("Blas_AX", flop_count);
-     flop += flop_count;
+    if ( !Comm_S_batch(s, nr, 1, "Comm_Batch") ) return 0;
 
-     
-     flop_count = 0.0;
-     omega = Fdot2(pcg_t_, pcg_s, flop_count) / Fdot1(pcg_t_, flop_count);
-     r_omega = -omega;
-     flop += flop_count;
+    TIMING_start("Blas_Clear");
+    batch_clear_(s_, &n, size, &gc);
+    TIMING_stop("Blas_Clear");
 
-     TIMING_start("Blas_BiCG_2");
-     flop_count = 0.0;
-     blas_bicg_2_(X, pcg_p_, pcg_s_, &alpha , &omega, size, innerFidx, &gc, &flop_count);
-     TIMING_stop("Blas_BiCG_2", flop_count);
-     flop += flop_count;
+    Preconditioner_batch(s_, s, nr, flop);
 
-     TIMING_start("Blas_TRIAD");
-     flop_count = 0.0;
-     blas_triad_(pcg_r, pcg_t_, pcg_s, &r_omega, size, innerFidx, &gc, &flop_count);
-     TIMING_stop("Blas_TRIAD", flop_count);
-     flop += flop_count;
+    // t_ = A s_ と (t_, s), (t_, t_) を1パスで
+    TIMING_start("Blas_AX_Dot");
+    flop_count = 0.0;
+    batch_calc_ax_dot2_(t_, s_, s, tst, tst+nr, &n, size, innerFidx, &gc, cf, &flop_count);
+    TIMING_stop("Blas_AX_Dot", flop_count);
+    flop += flop_count;
 
-     flop_count = 0.0;
-     res = Fdot1(pcg_r, flop_count);
-     flop += flop_count;
-     
+    if ( !Comm_SUM_N_begin(tst, 2*nr, "A_R_Dot") ) return 0;
+    if ( !Comm_SUM_N_end(tst, 2*nr, "A_R_Dot") ) return 0;
 
+    for (int m=0; m<nr; m++)
+    {
+      omega[m] = conv[m] ? 0.0 : tst[m] / tst[nr+m];
+    }
 
-     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+    // x, rの更新と (r, r), 次反復の(r, r0)を1パスで
+    TIMING_start("Blas_BiCG_3");
+    flop_count = 0.0;
+    batch_bicg_3_(X, r, p_, s_, s, t_, r0, alpha, omega, rrr, rrr+nr,
+                  &n, size, innerFidx, &gc, &flop_count);
+    TIMING_stop("Blas_BiCG_3", flop_count);
+    flop += flop_count;
 
-     if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
+    if ( !Comm_S_batch(X, nr, 1, "Comm_Batch") ) return 0;
 
-     res *= res_normal;
-     res = sqrt(res);
-     Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res);
-     
-     TIMING_start("BoundaryCondition");
-     bc_k_(size, &gc, X, pitch, origin, nID);
-     TIMING_stop("BoundaryCondition");
+    if ( !Comm_SUM_N_begin(rrr, 2*nr, "Comm_Res_Poisson") ) return 0;
+    if ( !Comm_SUM_N_end(rrr, 2*nr, "Comm_Res_Poisson") ) return 0;
 
-     if ( res < eps ) break;
+    double res_max = 0.0;
+    for (int m=0; m<nr; m++)
+    {
+      res[m] = sqrt(rrr[m] * res_normal);
+      if ( res[m] < eps ) conv[m] = true;
+      if ( res[m] > res_max ) res_max = res[m];
+    }
+    Hostonly_ fprintf(fph, "%6d, %13.6e\n", itr, res_max);
 
-     rho_old = rho;
-   } // itr
+    if ( res_max < eps ) break;
 
-   return itr;
- }
+    for (int m=0; m<nr; m++)
+    {
+      rho_old[m] = rho[m];
+      rho[m] = rrr[nr+m];
+    }
+  } // itr
+
+  return itr;
+}
 
 
 
@@ -545,37 +2830,59 @@ int CZ::LSOR_PCR_RB(double& res, REAL_TYPE* X, REAL_TYPE* B,
     
 
     
-    // 2色のマルチカラー(Red&Black)のセットアップ
-    int ip=0;
-    if ( numProc > 1 )
-    {
-      ip = (head[0] + head[1] + head[2]+1) % 2;
-    }
-    else
-    {
-      ip = 0;
-    }
-    
     if (s_type==LS_PCR_RB_MAF)
     {
       PUSH_RANGE("pcr_rb_maf", 7);
       TIMING_start("PCR_RB_MAF");
       for (int color=0; color<2; color++)
       {
-        pcr_rb_maf_(size, innerFidx, &gc, &pn, &ip, &color, X, MSK, B, xc, yc, zc,
+        pcr_rb_maf_(size, innerFidx, &gc, &pn, &rbl_num[color], RBL + 2*rbl_num[0]*color,
+                    X, MSK, B, xc, yc, zc,
                     WA, WC, WD, WAA, WCC, WDD,
                     &ac1, &res, vrtmp, &flop_count);
       }
       TIMING_stop("PCR_RB_MAF", flop_count);
       POP_RANGE;
     }
+    else if (pcr_np > 1)
+    {
+      // K方向に分割されたラインは縮約系で連成して解く
+      if ( !PCR_RB_dist(X, B, pn, res, flop_count) ) return 0;
+    }
+    else if (s_type==LS_PCR_RB_HYB)
+    {
+      TIMING_start("PCR_RB_HYB");
+      for (int color=0; color<2; color++)
+      {
+        pcr_rb_hyb_(size, innerFidx, &gc, &pn, &hyb_q, &hyb_nt,
+                    &rbl_num[color], RBL + 2*rbl_num[0]*color,
+                    X, MSK, B,
+                    FE, FA, FC, TW, TA, TC,
+                    &ac1, &res, &flop_count);
+      }
+      TIMING_stop("PCR_RB_HYB", flop_count);
+    }
+    else if (pcr_lanes > 0)
+    {
+      // 隣接するpcr_lanes本のラインをSIMDレーン方向に並べて同時に解く
+      TIMING_start("PCR_RB_Lanes");
+      for (int color=0; color<2; color++)
+      {
+        pcr_rb_lanes_(size, innerFidx, &gc, &pn, &rbl_num[color], RBL + 2*rbl_num[0]*color,
+                      &pcr_lanes, X, MSK, B,
+                      FE, FA, FC, F2,
+                      &ac1, &res, &flop_count);
+      }
+      TIMING_stop("PCR_RB_Lanes", flop_count);
+    }
     else
     {
       TIMING_start("PCR_RB");
       for (int color=0; color<2; color++)
       {
-        pcr_rb_(size, innerFidx, &gc, &pn, &ip, &color, X, MSK, B, 
-                WA, WC, WD, WAA, WCC, WDD,
+        pcr_rb_(size, innerFidx, &gc, &pn, &rbl_num[color], RBL + 2*rbl_num[0]*color,
+                X, MSK, B,
+                FE, FA, FC, F2, WD, WDD,
                 &ac1, &res, &flop_count);
       }
       TIMING_stop("PCR_RB", flop_count);
@@ -586,24 +2893,29 @@ int CZ::LSOR_PCR_RB(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
 
@@ -644,6 +2956,9 @@ int CZ::LSOR_PCR_RB_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
   ss = pow(2, pn-2);
   int kk = ked - kst+ 2*ss + 1;
   
+  // 係数キャッシュ用ライン配列の袖
+  int sp = pow(2, pn-1);
+  
 #ifdef __NEC__
   for (int i=0; i<kk; i++)
   {
@@ -670,23 +2985,12 @@ int CZ::LSOR_PCR_RB_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     
 
     
-    // 2色のマルチカラー(Red&Black)のセットアップ
-    int ip=0;
-    if ( numProc > 1 )
-    {
-      ip = (head[0] + head[1] + head[2]+1) % 2;
-    }
-    else
-    {
-      ip = 0;
-    }
-    
     if (s_type==LS_PCR_RB_ESA_MAF)
     {
       TIMING_start("PCR_RB_MAF");
       for (int color=0; color<2; color++)
       {
-        pcr_rb_esa_maf_(size, innerFidx, &gc, &pn, &ip, &color, &ss,
+        pcr_rb_esa_maf_(size, innerFidx, &gc, &pn, &rbl_num[color], RBL + 2*rbl_num[0]*color, &ss,
                         X, MSK, B, xc, yc, zc,
                     SA, SC, SD, WAA, WCC, WDD,
                     &ac1, &res, vrtmp, &flop_count);
@@ -698,9 +3002,9 @@ int CZ::LSOR_PCR_RB_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
       TIMING_start("PCR_RB");
       for (int color=0; color<2; color++)
       {
-        pcr_rb_esa_(size, innerFidx, &gc, &pn, &ip, &color, &ss,
+        pcr_rb_esa_(size, innerFidx, &gc, &pn, &rbl_num[color], RBL + 2*rbl_num[0]*color, &sp,
                     X, MSK, B,
-                SA, SC, SD, WAA, WCC, WDD,
+                FE, FA, FC, F4, FD, FD1,
                 &ac1, &res, &flop_count);
       }
       TIMING_stop("PCR_RB", flop_count);
@@ -711,28 +3015,158 @@ int CZ::LSOR_PCR_RB_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
 
 
+/* #################################################################
+ * @brief K方向に分割されたラインのPCR 2色オーダリングの1掃引
+ * @param [in,out] X      解ベクトル
+ * @param [in]     B      RHSベクトル
+ * @param [in]     pn     PCRの段数
+ * @param [in,out] res    反復残差の二乗和
+ * @param [in,out] flop   浮動小数点演算数
+ * @note 色毎に 局所解 -> 縮約系 -> 重ね合わせと緩和 の順に進めるので，
+ *       K方向の分割数によらず分割なしの2色ラインSORと同じ反復になる
+ */
+bool CZ::PCR_RB_dist(REAL_TYPE* X, REAL_TYPE* B, int pn, double& res, double& flop)
+{
+  double flop_count = 0.0;
+  int gc = GUIDE;
+  int ex[2];
+
+  ex[0] = ( nID[K_minus] >= 0 ) ? 1 : 0;
+  ex[1] = ( nID[K_plus]  >= 0 ) ? 1 : 0;
+
+  for (int color=0; color<2; color++)
+  {
+    int nl = rbl_num[color];
+    int* lst = RBL + 2*rbl_num[0]*color;
+
+    TIMING_start("PCR_RB");
+    flop_count = 0.0;
+    pcr_rb_y_(size, innerFidx, &gc, &pn, &nl, lst,
+              X, MSK, B,
+              FE, FA, FC, F2, ex, WRK, PYE, &flop_count);
+    TIMING_stop("PCR_RB", flop_count);
+    flop += flop_count;
+
+    if ( !PCR_interface(nl, flop) ) return false;
+
+    TIMING_start("PCR_RB");
+    flop_count = 0.0;
+    pcr_rb_relax_(size, innerFidx, &gc, &nl, lst,
+                  X, MSK, WRK, FU, FV, PXE,
+                  &ac1, &res, &flop_count);
+    TIMING_stop("PCR_RB", flop_count);
+    flop += flop_count;
+  }
+
+  return true;
+}
+
+
+/* #################################################################
+ * @brief K方向に分割されたラインの縮約系を解き，隣接ランク側の境界値を求める
+ * @param [in]     nl     ライン数
+ * @param [in,out] flop   浮動小数点演算数
+ * @note PYE(2,nl) をK方向の全ランクで集め，各ランクで冗長に解いて PXE(2,nl) を得る
+ *       係数は setPCRdist() で前進消去済み
+ */
+bool CZ::PCR_interface(const int nl, double& flop)
+{
+  int np = pcr_np;
+  int kr = pcr_kr;
+  double* cf_r = pcr_cf;
+
+  TIMING_start("Comm_PCR_K");
+#ifndef DISABLE_MPI
+#ifdef _REAL_IS_DOUBLE_
+  MPI_Datatype d_type = MPI_DOUBLE;
+#else
+  MPI_Datatype d_type = MPI_FLOAT;
+#endif
+  if ( MPI_SUCCESS != MPI_Allgather(PYE, 2*nl, d_type,
+                                    PYA, 2*nl, d_type,
+                                    comm_k) ) return false;
+#endif
+  TIMING_stop("Comm_PCR_K", (double)(2*nl*np*sizeof(REAL_TYPE)));
+
+  TIMING_start("PCR_Interface");
+
+#pragma omp parallel
+  {
+  double* h0 = new double[np];
+  double* h1 = new double[np];
+
+#pragma omp for schedule(static)
+  for (int l=0; l<nl; l++)
+  {
+    double hp = 0.0;
+
+    // 前進消去 h_q = Mi_q (y_q + A_q h_{q-1})
+    for (int q=0; q<np; q++)
+    {
+      const double* c = cf_r + 6*q;
+      double t0 = (double)PYA[2*(q*nl+l)  ] + c[0] * hp;
+      double t1 = (double)PYA[2*(q*nl+l)+1] + c[1] * hp;
+      h0[q] = c[2] * t0;
+      h1[q] = c[3] * t0 + t1;
+      hp = h1[q];
+    }
+
+    // 後退代入 z_q = e_q F_{q+1} + h_q
+    double fn = 0.0;
+    double xl = 0.0;
+    double xr = 0.0;
+
+    for (int q=np-1; q>=kr-1 && q>=0; q--)
+    {
+      const double* c = cf_r + 6*q;
+      double f = c[4] * fn + h0[q];
+      if ( q == kr+1 ) xr = f;
+      if ( q == kr-1 ) xl = c[5] * fn + h1[q];
+      fn = f;
+    }
+
+    PXE[2*l  ] = (REAL_TYPE)xl;
+    PXE[2*l+1] = (REAL_TYPE)xr;
+  }
+
+  delete [] h0;
+  delete [] h1;
+  } // omp parallel
+
+  TIMING_stop("PCR_Interface", (double)(nl*np*9));
+  flop += (double)(nl*np*9);
+
+  return true;
+}
+
+
 /* #################################################################
  * @brief Line SOR PCR
  * @param [in,out] res    残差
@@ -764,6 +3198,12 @@ int CZ::LSOR_PCR(double& res, REAL_TYPE* X, REAL_TYPE* B,
     exit(0);
   }
   
+  int core[6], shell[6][6], n_shell=0;
+  bool pending = false;
+  
+  // ラインはk方向に分割しない
+  if (s_type==LS_PCR_OVL) n_shell = split_inner_index(core, shell, true);
+  
   
   for (itr=1; itr<=itr_max; itr++)
   {
@@ -772,7 +3212,17 @@ int CZ::LSOR_PCR(double& res, REAL_TYPE* X, REAL_TYPE* B,
     
 
     
-    if (s_type==LS_PCR_MAF)
+    if (pcr_np > 1 && s_type != LS_PCR_MAF)
+    {
+      // K方向に分割されたラインは縮約系で連成して解く
+      if ( pending ) {
+        if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+        pending = false;
+      }
+      
+      if ( !PCR_RB_dist(X, B, pn, res, flop_count) ) return 0;
+    }
+    else if (s_type==LS_PCR_MAF)
     {
       TIMING_start("PCR_MAF");
       pcr_maf_(size, innerFidx, &gc, &pn, X, MSK, B, xc, yc, zc,
@@ -780,38 +3230,79 @@ int CZ::LSOR_PCR(double& res, REAL_TYPE* X, REAL_TYPE* B,
                  &ac1, &res, vrtmp, &flop_count);
       TIMING_stop("PCR_MAF", flop_count);
     }
+    else if (s_type==LS_PCR_OVL)
+    {
+      // 中心部のラインはガイドセルの通信中に計算
+      TIMING_start("PCR");
+      pcr_(size, core, &gc, &pn, X, MSK, B,
+                FE, FA, FC, F4, WD, WDD,
+                &ac1, &res, &flop_count);
+      TIMING_stop("PCR", flop_count);
+      flop += flop_count;
+      
+      if ( pending ) {
+        if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+        pending = false;
+      }
+      
+      TIMING_start("PCR");
+      flop_count = 0.0;
+      for (int l=0; l<n_shell; l++) {
+        pcr_(size, shell[l], &gc, &pn, X, MSK, B,
+                  FE, FA, FC, F4, WD, WDD,
+                  &ac1, &res, &flop_count);
+      }
+      TIMING_stop("PCR", flop_count);
+    }
     else
     {
       TIMING_start("PCR");
       pcr_(size, innerFidx, &gc, &pn, X, MSK, B,
-                WA, WC, WD, WAA, WCC, WDD,
+                FE, FA, FC, F4, WD, WDD,
                 &ac1, &res, &flop_count);
       TIMING_stop("PCR", flop_count);
     }
     flop += flop_count;
 
     
-    if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+    if (s_type==LS_PCR_OVL)
+    {
+      if ( !Comm_S_begin(X, 1, "Comm_Poisson") ) return 0;
+      pending = true;
+    }
+    else
+    {
+      if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
+    }
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  if ( pending ) {
+    if ( !Comm_S_end(X, 1, "Comm_Poisson") ) return 0;
+  }
+  
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
 
@@ -876,24 +3367,29 @@ int CZ::LSOR_PCR_EDA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
 
@@ -934,6 +3430,9 @@ int CZ::LSOR_PCR_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
   ss = pow(2, pn-2);
   int kk = ked - kst+ 2*ss + 1;
   
+  // 係数キャッシュ用ライン配列の袖
+  int sp = pow(2, pn-1);
+  
 #ifdef __NEC__
   for (int i=0; i<kk; i++)
   {
@@ -972,8 +3471,8 @@ int CZ::LSOR_PCR_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     else
     {
       TIMING_start("PCR");
-      pcr_esa_(size, innerFidx, &gc, &pn, &ss,
-               X, MSK, B, SA, SC, SD, WA, WC, WD,
+      pcr_esa_(size, innerFidx, &gc, &pn, &sp,
+               X, MSK, B, FE, FA, FC, F4, FD, FD1,
                &ac1, &res, &flop_count);
       TIMING_stop("PCR", flop_count);
     }
@@ -983,24 +3482,29 @@ int CZ::LSOR_PCR_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
 
@@ -1031,6 +3535,9 @@ int CZ::LSOR_PCR_J_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
   ss = pow(2, pn-2);
   int kk = ked - kst+ 2*ss + 1;
   
+  // 係数キャッシュ用ライン配列の袖
+  int sp = pow(2, pn-1);
+  
 #ifdef __NEC__
   for (int i=0; i<kk; i++)
   {
@@ -1058,9 +3565,9 @@ int CZ::LSOR_PCR_J_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if (s_type==LS_PCR_J_ESA)
     {
       TIMING_start("PCR_J");
-      pcr_j_esa_(size, innerFidx, &gc, &pn, &ss,
+      pcr_j_esa_(size, innerFidx, &gc, &pn, &sp,
                   X, MSK, B,
-                  SA, SC, SD, WA, WC, WD, SRC, WRK,
+                  FE, FA, FC, F2, FD, FD1, SRC, WRK,
                   &ac1, &res, &flop_count);
       TIMING_stop("PCR_J", flop_count);
     }
@@ -1073,23 +3580,28 @@ int CZ::LSOR_PCR_J_ESA(double& res, REAL_TYPE* X, REAL_TYPE* B,
     if ( !Comm_S(X, 1, "Comm_Poisson") ) return 0;
     
     if ( converge_check ) {
-      if ( !Comm_SUM_1(&res, "Comm_Res_Poisson") ) return 0;
-      
-      res *= res_normal;
-      res = sqrt(res);
-      Hostonly_ {
-        fprintf(fph, "%6d, %13.6e\n", itr, res);
-        fflush(fph);
-      }
+      int itr_res;
+      if ( !Comm_Res(res, itr, itr_res, "Comm_Res_Poisson") ) return 0;
       
       TIMING_start("BoundaryCondition");
       bc_k_(size, &gc, X, pitch, origin, nID);
       TIMING_stop("BoundaryCondition");
       
-      if ( res < eps ) break;
+      if ( itr_res > 0 ) {
+        Hostonly_ {
+          fprintf(fph, "%6d, %13.6e\n", itr_res, res);
+          fflush(fph);
+        }
+        if ( res < eps ) break;
+      }
     }
     
   } // Iteration
   
+  // 遅延判定で未完了の残差の集計
+  if ( converge_check ) {
+    if ( !Comm_Res_flush(res, "Comm_Res_Poisson") ) return 0;
+  }
+  
   return itr;
 }
@@ -38,6 +38,88 @@ bool CZ::Comm_S(REAL_TYPE* sa, int gc, const string label)
 }
 
 
+// #################################################################
+/*
+ * @brief マルチグリッドの各階層のスカラー配列の同期
+ * @param [in,out] sa     Scalar array
+ * @param [in]     lv     階層 0が細格子
+ * @param [in]     gc     通信するガイドセル幅
+ * @param [in]     label  PMlibラベル
+ * @retval true/false
+ * @note 粗格子は階層毎のBrickCommで通信する
+ */
+bool CZ::Comm_S_mg(REAL_TYPE* sa, const int lv, int gc, const string label)
+{
+  if ( numProc == 1 ) return true;
+  if ( lv == 0 ) return Comm_S(sa, gc, label);
+
+  bool flag = true;
+  if (!label.empty()) TIMING_start(label);
+
+#ifndef DISABLE_MPI
+  if ( !CMg[lv].Comm_S_node(sa, gc, req) ) flag=false;
+  if ( !CMg[lv].Comm_S_wait_node(sa, gc, req) ) flag=false;
+#endif
+
+  if (!label.empty()) TIMING_stop(label);
+
+  return (flag)?true:false;
+}
+
+
+// #################################################################
+/*
+ * @brief スカラー配列の同期の開始
+ * @param [in,out] sa     Scalar array
+ * @param [in]     gc     通信するガイドセル幅
+ * @param [in]     label  PMlibラベル
+ * @retval true/false
+ * @note 送信データはここでパックされるので，完了待ちまでの間に内点を更新してよい
+ *       ガイドセルは Comm_S_end() まで参照しないこと
+ */
+bool CZ::Comm_S_begin(REAL_TYPE* sa, int gc, const string label)
+{
+  if ( numProc == 1 ) return true;
+
+  bool flag = true;
+  if (!label.empty()) TIMING_start(label);
+
+#ifndef DISABLE_MPI
+  if ( !CM.Comm_S_node(sa, gc, req) ) flag=false;
+#endif
+
+  if (!label.empty()) TIMING_stop(label);
+
+  return (flag)?true:false;
+}
+
+
+// #################################################################
+/*
+ * @brief スカラー配列の同期の完了待ち
+ * @param [in,out] sa     Scalar array
+ * @param [in]     gc     通信するガイドセル幅
+ * @param [in]     label  PMlibラベル
+ * @retval true/false
+ * @note Comm_S_begin()と対で呼ぶ
+ */
+bool CZ::Comm_S_end(REAL_TYPE* sa, int gc, const string label)
+{
+  if ( numProc == 1 ) return true;
+
+  bool flag = true;
+  if (!label.empty()) TIMING_start(label);
+
+#ifndef DISABLE_MPI
+  if ( !CM.Comm_S_wait_node(sa, gc, req) ) flag=false;
+#endif
+
+  if (!label.empty()) TIMING_stop(label, comm_size);
+
+  return (flag)?true:false;
+}
+
+
 // #################################################################
 /*
  * @brief ベクトル配列の同期
@@ -64,6 +146,108 @@ bool CZ::Comm_V(REAL_TYPE* va, int gc, const string label)
 }
 
 
+// #################################################################
+/*
+ * @brief 一括求解の配列の同期
+ * @param [in,out] sa     RHSの番号を最内にした配列 sa(nr, k, i, j)
+ * @param [in]     nr     RHSの本数
+ * @param [in]     gc     通信するガイドセル幅
+ * @param [in]     label  PMlibラベル
+ * @retval true/false
+ * @note BrickCommはスカラーと3成分ベクトルのみを扱うので，nr本分を1面1メッセージに
+ *       パックして隣接ランクと直接交換する．対応はComm_S()のnodeモードと同じで，
+ *       plus側へ sz-l，minus側へ 2+l の節点を送り，それぞれ 1-l, sz+1+l に受ける
+ */
+bool CZ::Comm_S_batch(REAL_TYPE* sa, const int nr, int gc, const string label)
+{
+  if ( numProc == 1 ) return true;
+
+  bool flag = true;
+  if (!label.empty()) TIMING_start(label);
+
+#ifndef DISABLE_MPI
+#ifdef _REAL_IS_DOUBLE_
+  MPI_Datatype d_type = MPI_DOUBLE;
+#else
+  MPI_Datatype d_type = MPI_FLOAT;
+#endif
+
+  int ext[3];
+  Size_S3D(size, ext);
+  size_t nk = (size_t)ext[0];
+  size_t ni = (size_t)ext[1];
+  size_t bn = (size_t)bt_face * (size_t)GUIDE * (size_t)nr;
+
+  REAL_TYPE* s_m = bt_buf;
+  REAL_TYPE* s_p = bt_buf + bn;
+  REAL_TYPE* r_m = bt_buf + bn*2;
+  REAL_TYPE* r_p = bt_buf + bn*3;
+
+  for (int d=0; d<3; d++)
+  {
+    int t1 = (d+1)%3;
+    int t2 = (d+2)%3;
+    int n1 = size[t1];
+    int n2 = size[t2];
+    int cnt = n1 * n2 * gc * nr;
+    int pm = ( nID[2*d]   >= 0 ) ? nID[2*d]   : MPI_PROC_NULL;
+    int pp = ( nID[2*d+1] >= 0 ) ? nID[2*d+1] : MPI_PROC_NULL;
+    int c[3];
+
+    if ( MPI_SUCCESS != MPI_Irecv(r_m, cnt, d_type, pm, 10+d, MPI_COMM_WORLD, &req[0]) ) flag=false;
+    if ( MPI_SUCCESS != MPI_Irecv(r_p, cnt, d_type, pp, 20+d, MPI_COMM_WORLD, &req[1]) ) flag=false;
+
+    size_t ms=0;
+    for (int l=0; l<gc; l++) {
+      for (int b=1; b<=n2; b++) {
+        for (int q=1; q<=n1; q++) {
+          c[t1] = q;
+          c[t2] = b;
+          c[d] = size[d] - l;
+          size_t lp = ( (size_t)(c[2]+GUIDE-1) + nk*( (size_t)(c[0]+GUIDE-1) + ni*(size_t)(c[1]+GUIDE-1) ) ) * nr;
+          c[d] = 2 + l;
+          size_t lm = ( (size_t)(c[2]+GUIDE-1) + nk*( (size_t)(c[0]+GUIDE-1) + ni*(size_t)(c[1]+GUIDE-1) ) ) * nr;
+          for (int m=0; m<nr; m++) {
+            s_p[ms+m] = sa[lp+m];
+            s_m[ms+m] = sa[lm+m];
+          }
+          ms += nr;
+        }
+      }
+    }
+
+    if ( MPI_SUCCESS != MPI_Isend(s_p, cnt, d_type, pp, 10+d, MPI_COMM_WORLD, &req[2]) ) flag=false;
+    if ( MPI_SUCCESS != MPI_Isend(s_m, cnt, d_type, pm, 20+d, MPI_COMM_WORLD, &req[3]) ) flag=false;
+
+    if ( MPI_SUCCESS != MPI_Waitall(4, req, MPI_STATUSES_IGNORE) ) flag=false;
+
+    ms=0;
+    for (int l=0; l<gc; l++) {
+      for (int b=1; b<=n2; b++) {
+        for (int q=1; q<=n1; q++) {
+          c[t1] = q;
+          c[t2] = b;
+          c[d] = 1 - l;
+          size_t lm = ( (size_t)(c[2]+GUIDE-1) + nk*( (size_t)(c[0]+GUIDE-1) + ni*(size_t)(c[1]+GUIDE-1) ) ) * nr;
+          c[d] = size[d] + 1 + l;
+          size_t lp = ( (size_t)(c[2]+GUIDE-1) + nk*( (size_t)(c[0]+GUIDE-1) + ni*(size_t)(c[1]+GUIDE-1) ) ) * nr;
+          for (int m=0; m<nr; m++) {
+            if ( pm != MPI_PROC_NULL ) sa[lm+m] = r_m[ms+m];
+            if ( pp != MPI_PROC_NULL ) sa[lp+m] = r_p[ms+m];
+          }
+          ms += nr;
+        }
+      }
+    }
+  }
+#endif
+
+  if (!label.empty()) TIMING_stop(label, comm_size*(double)nr);
+
+  return (flag)?true:false;
+}
+
+
 // #################################################################
 /*
  * @brief int型1変数のAllreduce
@@ -324,3 +508,149 @@ bool CZ::Comm_SUM_2(float* var1, float* var2, const string label)
 #endif
 }
 
+
+
+// #################################################################
+/*
+ * @brief double型n変数の非同期Allreduceの開始
+ * @param [in,out] var     対象変数の配列 (結果は同じ配列に戻る)
+ * @param [in]     n       変数の個数
+ * @param [in]     label   PMlibラベル
+ * @retval true/false
+ * @note Comm_SUM_N_end()までvarを参照・変更しないこと
+ */
+bool CZ::Comm_SUM_N_begin(double* var, const int n, const string label)
+{
+  if ( numProc == 1 ) return true;
+  
+  bool flag = true;
+  
+#ifndef DISABLE_MPI
+  if (!label.empty()) TIMING_start(label);
+  if ( MPI_SUCCESS != MPI_Iallreduce(MPI_IN_PLACE,
+                                     var,
+                                     n,
+                                     MPI_DOUBLE,
+                                     MPI_SUM,
+                                     MPI_COMM_WORLD,
+                                     &req_sum) ) flag=false;
+  if (!label.empty()) TIMING_stop(label);
+#endif
+  
+  return (flag)?true:false;
+}
+
+
+// #################################################################
+/*
+ * @brief double型n変数の非同期Allreduceの完了待ち
+ * @param [in,out] var     対象変数の配列
+ * @param [in]     n       変数の個数
+ * @param [in]     label   PMlibラベル
+ * @retval true/false
+ * @note Comm_SUM_N_begin()と対で呼ぶ
+ */
+bool CZ::Comm_SUM_N_end(double* var, const int n, const string label)
+{
+  if ( numProc == 1 ) return true;
+  
+  bool flag = true;
+  
+#ifndef DISABLE_MPI
+  if (!label.empty()) TIMING_start(label);
+  if ( MPI_SUCCESS != MPI_Wait(&req_sum, MPI_STATUS_IGNORE) ) flag=false;
+  if (!label.empty()) TIMING_stop(label, 2.0*n*numProc*sizeof(double));
+#endif
+  
+  return (flag)?true:false;
+}
+
+
+// #################################################################
+/*
+ * @brief 収束判定用の残差のAllreduce（遅延判定）
+ * @param [in,out] res      入力は自ランクの残差の二乗和，出力は確定した残差ノルム
+ * @param [in]     itr      現在の反復数
+ * @param [out]    itr_res  resが確定した反復数，未確定の場合は-1
+ * @param [in]     label    PMlibラベル
+ * @retval true/false
+ * @note res_lag=0 では従来通り同期的に集計し，itr_res=itr となる
+ *       res_lag>0 では非同期Allreduceを開始し，res_lag反復前に開始した集計を
+ *       完了待ちする．集計の待ち時間は間の反復と重なり，判定は最大res_lag反復遅れる
+ */
+bool CZ::Comm_Res(double& res, const int itr, int& itr_res, const string label)
+{
+  itr_res = -1;
+  
+  if ( res_lag == 0 || numProc == 1 )
+  {
+    if ( !Comm_SUM_1(&res, label) ) return false;
+    res = sqrt(res * res_normal);
+    itr_res = itr;
+    return true;
+  }
+  
+  bool flag = true;
+  
+#ifndef DISABLE_MPI
+  int s = itr % (res_lag+1);   // 今回の集計
+  int o = (s+1) % (res_lag+1); // res_lag反復前の集計
+  
+  lag_res[s] = res;
+  lag_itr[s] = itr;
+  
+  if (!label.empty()) TIMING_start(label);
+  if ( MPI_SUCCESS != MPI_Iallreduce(MPI_IN_PLACE,
+                                     &lag_res[s],
+                                     1,
+                                     MPI_DOUBLE,
+                                     MPI_SUM,
+                                     MPI_COMM_WORLD,
+                                     &lag_req[s]) ) flag=false;
+  
+  if ( lag_req[o] != MPI_REQUEST_NULL )
+  {
+    if ( MPI_SUCCESS != MPI_Wait(&lag_req[o], MPI_STATUS_IGNORE) ) flag=false;
+    res = sqrt(lag_res[o] * res_normal);
+    itr_res = lag_itr[o];
+  }
+  if (!label.empty()) TIMING_stop(label, 2.0*numProc*sizeof(double));
+#endif
+  
+  return (flag)?true:false;
+}
+
+
+// #################################################################
+/*
+ * @brief 遅延判定で未完了の残差の集計を完了させる
+ * @param [in,out] res      最後に開始した集計の残差ノルム
+ * @param [in]     label    PMlibラベル
+ * @retval true/false
+ * @note 反復ループの後に呼ぶ．未完了の集計が無ければresは変更しない
+ */
+bool CZ::Comm_Res_flush(double& res, const string label)
+{
+  if ( res_lag == 0 || numProc == 1 ) return true;
+  
+  bool flag = true;
+  
+#ifndef DISABLE_MPI
+  int last = -1;
+  
+  if (!label.empty()) TIMING_start(label);
+  for (int i=0; i<=res_lag; i++)
+  {
+    if ( lag_req[i] == MPI_REQUEST_NULL ) continue;
+    
+    if ( MPI_SUCCESS != MPI_Wait(&lag_req[i], MPI_STATUS_IGNORE) ) flag=false;
+    
+    if ( last < 0 || lag_itr[i] > lag_itr[last] ) last = i;
+  }
+  if (!label.empty()) TIMING_stop(label);
+  
+  if ( last >= 0 ) res = sqrt(lag_res[last] * res_normal);
+#endif
+  
+  return (flag)?true:false;
+}
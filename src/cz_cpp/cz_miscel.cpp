@@ -51,6 +51,806 @@ double CZ::range_inner_index()
   return sum;
 }
 
+
+// #################################################################
+/* @brief 通信と計算のオーバーラップ用に内点を中心部と境界部に分割
+ * @param [out] core  中心部のインデクス範囲
+ * @param [out] shell 境界部のインデクス範囲（最大6領域）
+ * @param [in]  line  trueのとき，k方向のラインを分割しない（ラインソルバ用）
+ * @retval 境界部の領域数
+ * @note 中心部はガイドセルを参照しない．隣接ランクが無い面は分割しない
+ *       ラインソルバでk方向に隣接ランクがある場合は，全体を境界部とする
+ */
+int CZ::split_inner_index(int* core, int shell[][6], bool line)
+{
+  int r[6];
+  int n = 0;
+
+  for (int i=0; i<6; i++) r[i] = innerFidx[i];
+
+  if ( line && (nID[K_minus] >= 0 || nID[K_plus] >= 0) )
+  {
+    for (int i=0; i<6; i++) shell[0][i] = r[i];
+    for (int i=0; i<6; i++) core[i] = r[i];
+    core[I_plus] = core[I_minus] - 1; // 空
+    return 1;
+  }
+
+  // K, J, Iの順に1層ずつ剥がす
+  int dir_st = (line) ? 1 : 2;
+
+  for (int d=dir_st; d>=0; d--)
+  {
+    int fm = 2*d;   // minus面
+    int fp = 2*d+1; // plus面
+
+    if ( nID[fm] >= 0 )
+    {
+      for (int i=0; i<6; i++) shell[n][i] = r[i];
+      shell[n][fp] = r[fm];
+      n++;
+      r[fm]++;
+    }
+
+    if ( nID[fp] >= 0 )
+    {
+      for (int i=0; i<6; i++) shell[n][i] = r[i];
+      shell[n][fm] = r[fp];
+      n++;
+      r[fp]--;
+    }
+  }
+
+  for (int i=0; i<6; i++) core[i] = r[i];
+
+  return n;
+}
+
+
+// #################################################################
+/* @brief ソルバに応じた領域分割モード
+ * @retval 0-IJK分割, 1-IJ分割
+ * @note K方向のラインソルバを含む場合はK方向を分割しないIJ分割とする
+ *       ラインを分割すると縮約系の解法と通信が加わるため
+ *       IJ分割ではライン長は一定なので，候補はCBrickの通信面積の評価で選ぶ
+ */
+int CZ::getDivisionMode()
+{
+  int t[2] = {ls_type, pc_type};
+  
+  for (int i=0; i<2; i++)
+  {
+    switch (t[i])
+    {
+      case LS_PCR:
+      case LS_PCR_EDA:
+      case LS_PCR_ESA:
+      case LS_PCR_RB:
+      case LS_PCR_RB_HYB:
+      case LS_PCR_RB_ESA:
+      case LS_PCR_J_ESA:
+      case LS_PCR_MAF:
+      case LS_PCR_EDA_MAF:
+      case LS_PCR_ESA_MAF:
+      case LS_PCR_RB_MAF:
+      case LS_PCR_RB_ESA_MAF:
+      case LS_PCR_OVL:
+        return 1;
+        
+      default:
+        break;
+    }
+  }
+  
+  return 0;
+}
+
+
+// #################################################################
+/* @brief 加速係数の自動推定に対応するSOR系ソルバか
+ * @param [in] s_type ソルバーの指定
+ * @note 収束率と最適加速係数の関係は2色順序付けを含む整合順序の（ライン）SORで成り立つ
+ *       Jacobi系と対称SORは対象外
+ */
+bool CZ::isSOR(const int s_type)
+{
+  switch (s_type)
+  {
+    case LS_PSOR:
+    case LS_PSOR_MAF:
+    case LS_PSOR_OVL:
+    case LS_SOR2SMA:
+    case LS_SOR2SMA_MAF:
+    case LS_SOR2SMA_TB:
+    case LS_PCR:
+    case LS_PCR_MAF:
+    case LS_PCR_OVL:
+    case LS_PCR_EDA:
+    case LS_PCR_EDA_MAF:
+    case LS_PCR_ESA:
+    case LS_PCR_ESA_MAF:
+    case LS_PCR_RB:
+    case LS_PCR_RB_MAF:
+    case LS_PCR_RB_HYB:
+    case LS_PCR_RB_ESA:
+    case LS_PCR_RB_ESA_MAF:
+      return true;
+      
+    default:
+      break;
+  }
+  
+  return false;
+}
+
+
+// #################################################################
+/* @brief 2色オーダリングの色毎のライン(i,j)リストを作成
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note 色はグローバルインデクスの偶奇 mod(i+j+head[0]+head[1], 2) で決める
+ *       逐次では mod(i+j,2) と同じ
+ *       リストは Fortranのインデクスで j外側, i内側の順に並べる
+ */
+bool CZ::setRBLine(double& L_mem)
+{
+  int t[2] = {ls_type, pc_type};
+  bool flag = false;
+  
+  for (int i=0; i<2; i++)
+  {
+    if ( t[i] == LS_PCR_RB         ||
+         t[i] == LS_PCR_RB_HYB     ||
+         t[i] == LS_PCR_RB_ESA     ||
+         t[i] == LS_PCR_RB_MAF     ||
+         t[i] == LS_PCR_RB_ESA_MAF ) flag = true;
+
+    // K方向に分割されたPCRは2色オーダリングで掃引する
+    if ( G_div[2] > 1 && (t[i] == LS_PCR || t[i] == LS_PCR_OVL) ) flag = true;
+  }
+  if ( !flag ) return true;
+  
+  int ist = innerFidx[I_minus];
+  int ied = innerFidx[I_plus];
+  int jst = innerFidx[J_minus];
+  int jed = innerFidx[J_plus];
+  int nl  = (ied-ist+1) * (jed-jst+1);
+  int ofst = (head[0] + head[1]) % 2;
+  int var_type = 0;
+  
+  if( (RBL = czAllocR(2*nl, var_type)) == NULL ) return false;
+  L_mem += (double)( 2*nl ) * (double)sizeof(int);
+  
+  rbl_num[0] = rbl_num[1] = 0;
+  
+  for (int j=jst; j<=jed; j++) {
+    for (int i=ist; i<=ied; i++) {
+      if ( (i+j+ofst)%2 == 0 ) rbl_num[0]++;
+    }
+  }
+  rbl_num[1] = nl - rbl_num[0];
+  
+  int* r0 = RBL;
+  int* r1 = RBL + 2*rbl_num[0];
+  
+  for (int j=jst; j<=jed; j++) {
+    for (int i=ist; i<=ied; i++) {
+      if ( (i+j+ofst)%2 == 0 ) {
+        *r0++ = i;
+        *r0++ = j;
+      }
+      else {
+        *r1++ = i;
+        *r1++ = j;
+      }
+    }
+  }
+  
+  return true;
+}
+
+// #################################################################
+/* @brief K方向に分割されたラインソルバの縮約系を準備
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note 各ランクのライン解は x = y + xL*u + xR*v と書ける
+ *       y : 隣接ランク側の境界値を0とした局所解
+ *       u, v : minus側, plus側の境界値1に対する応答（全ラインで共通）
+ *       xL, xR は隣のランクのライン端の値なので，K方向の全ランクの
+ *       ライン両端 (F, L) を未知数とする2x2ブロック三重対角系になる
+ *       z_r - A_r z_{r-1} - C_r z_{r+1} = y_r,  z_r = (F_r, L_r)
+ *       A_r, C_r はそれぞれ1列のみ非零なので，ブロックThomas法の係数は
+ *       ランク毎のスカラー6個に縮約できる
+ */
+bool CZ::setPCRdist(double& L_mem)
+{
+  int t[2] = {ls_type, pc_type};
+  bool flag = false;
+
+  for (int i=0; i<2; i++)
+  {
+    if ( t[i] == LS_PCR     ||
+         t[i] == LS_PCR_OVL ||
+         t[i] == LS_PCR_RB  ||
+         t[i] == LS_PCR_RB_HYB ) flag = true;
+  }
+  if ( !flag || G_div[2] == 1 ) return true;
+
+#ifndef DISABLE_MPI
+  // 同じ(I,J)位置のランクをK方向の順に並べる
+  int color = (head[0]-1) * G_size[1] + (head[1]-1);
+  if ( MPI_SUCCESS != MPI_Comm_split(MPI_COMM_WORLD, color, head[2], &comm_k) ) return false;
+  MPI_Comm_size(comm_k, &pcr_np);
+  MPI_Comm_rank(comm_k, &pcr_kr);
+#endif
+
+  int kst = innerFidx[K_minus];
+  int ked = innerFidx[K_plus];
+  int n = ked - kst + 1;
+  int nl = ( rbl_num[0] > rbl_num[1] ) ? rbl_num[0] : rbl_num[1];
+  REAL_TYPE var_type = 0;
+
+  if( (FU  = czAllocR(n, var_type)) == NULL ) return false;
+  if( (FV  = czAllocR(n, var_type)) == NULL ) return false;
+  if( (PYE = czAllocR(2*nl, var_type)) == NULL ) return false;
+  if( (PXE = czAllocR(2*nl, var_type)) == NULL ) return false;
+  if( (PYA = czAllocR(2*nl*pcr_np, var_type)) == NULL ) return false;
+  L_mem += (double)( 2*n + 4*nl + 2*nl*pcr_np ) * (double)sizeof(REAL_TYPE);
+
+  // 応答 u, v を倍精度のThomas法で求める  x_k - r(x_{k-1}+x_{k+1}) = r e_{kst|ked}
+  double r = 1.0/6.0;
+  double* w = new double[n];
+  double* g = new double[n];
+  double* u = new double[n];
+  double* v = new double[n];
+
+  for (int s=0; s<2; s++)
+  {
+    double* x = (s==0) ? u : v;
+    for (int k=0; k<n; k++) x[k] = 0.0;
+    x[(s==0) ? 0 : n-1] = r;
+
+    w[0] = -r;
+    g[0] = x[0];
+    for (int k=1; k<n; k++)
+    {
+      double m = 1.0 + r * w[k-1];
+      w[k] = -r / m;
+      g[k] = ( x[k] + r * g[k-1] ) / m;
+    }
+    x[n-1] = g[n-1];
+    for (int k=n-2; k>=0; k--) x[k] = g[k] - w[k] * x[k+1];
+  }
+
+  // 物理境界側は応答なし
+  if ( nID[K_minus] < 0 ) for (int k=0; k<n; k++) u[k] = 0.0;
+  if ( nID[K_plus]  < 0 ) for (int k=0; k<n; k++) v[k] = 0.0;
+
+  for (int k=0; k<n; k++)
+  {
+    FU[k] = (REAL_TYPE)u[k];
+    FV[k] = (REAL_TYPE)v[k];
+  }
+
+  double uv[4] = {u[0], u[n-1], v[0], v[n-1]};
+  double* uva = new double[4*pcr_np];
+
+#ifndef DISABLE_MPI
+  if ( MPI_SUCCESS != MPI_Allgather(uv, 4, MPI_DOUBLE, uva, 4, MPI_DOUBLE, comm_k) ) return false;
+#else
+  for (int i=0; i<4; i++) uva[i] = uv[i];
+#endif
+
+  // ブロックThomas法の前進消去の係数
+  double d_type = 0.0;
+  if( (pcr_cf = czAllocR(6*pcr_np, d_type)) == NULL ) return false;
+
+  double ep1 = 0.0;
+  for (int q=0; q<pcr_np; q++)
+  {
+    double uF = uva[4*q];
+    double uL = uva[4*q+1];
+    double vF = uva[4*q+2];
+    double vL = uva[4*q+3];
+    double m00 = 1.0 - uF * ep1;
+    double* c = pcr_cf + 6*q;
+    c[0] = uF;
+    c[1] = uL;
+    c[2] = 1.0 / m00;
+    c[3] = uL * ep1 / m00;
+    c[4] = c[2] * vF;
+    c[5] = c[3] * vF + vL;
+    ep1 = c[5];
+  }
+
+  delete [] w;
+  delete [] g;
+  delete [] u;
+  delete [] v;
+  delete [] uva;
+
+  Hostonly_ printf("PCR : K direction is divided into %d ranks\n", pcr_np);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 時間ブロッキングで1ブロックに進める反復数
+ * @param [out] ex     各面の拡張フラグ（隣接ランクがあれば1）
+ * @param [in]  extend trueのとき，隣接ランクの面はガイドセル内を冗長計算して拡張する
+ * @retval 反復数 1のときは時間ブロッキングしない
+ * @note 冗長計算にはnt層のガイドセルが必要なので nt <= GUIDE
+ *       面通信のみで稜のガイドセルは同期されないので，分割軸が2つ以上あれば拡張できない
+ *       extend=falseのカーネル（2色SOR）はガイドセルを固定して進めるので隣接ランクが無い場合に限る
+ */
+int CZ::getTBdepth(int* ex, bool extend)
+{
+  int n_axis = 0;
+  int n_face = 0;
+
+  for (int d=0; d<3; d++)
+  {
+    ex[2*d]   = ( nID[2*d]   >= 0 ) ? 1 : 0;
+    ex[2*d+1] = ( nID[2*d+1] >= 0 ) ? 1 : 0;
+    if ( ex[2*d] || ex[2*d+1] ) n_axis++;
+    n_face += ex[2*d] + ex[2*d+1];
+  }
+
+  if ( n_face == 0 ) return tb_depth;
+
+  if ( !extend || n_axis > 1 ) return 1;
+
+  return ( tb_depth < GUIDE ) ? tb_depth : GUIDE;
+}
+
+
+// #################################################################
+/* @brief 時間ブロッキング用のリングバッファを確保
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note Jacobiの中間段 (tb_depth-1)段 x 3面
+ */
+bool CZ::setTBbuffer(double& L_mem)
+{
+  if ( ls_type != LS_JACOBI_TB && pc_type != LS_JACOBI_TB ) return true;
+  if ( tb_depth < 2 ) return true;
+
+  size_t nx = (size_t)(size[2]+2*GUIDE) * (size_t)(size[0]+2*GUIDE)
+            * 3 * (size_t)(tb_depth-1);
+  REAL_TYPE var_type = 0;
+
+  if( (TBW = czAllocR((int)nx, var_type)) == NULL ) return false;
+  L_mem += (double)nx * (double)sizeof(REAL_TYPE);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief マルチグリッドの階層を構築し，粗格子の配列を確保
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note 粗格子は細格子の2x2x2セルを束ね，内点は細格子と同じく[2, n+1]に置く
+ *       全ランクの各方向の内点数が偶数で，粗格子に2点以上残る間だけ粗くする
+ *       ランク間の集約はしないので，最粗格子の点数は分割数に比例する
+ */
+bool CZ::setMGlevel(double& L_mem)
+{
+  if ( ls_type != LS_MG && ls_type != LS_MG_W &&
+       pc_type != LS_MG && pc_type != LS_MG_W ) return true;
+
+  int n[3], hd[3];
+  REAL_TYPE var_type = 0;
+
+  for (int d=0; d<3; d++)
+  {
+    n[d]  = innerFidx[2*d+1] - innerFidx[2*d] + 1;
+    hd[d] = head[d];
+    mg_sz[0][d] = size[d];
+    mg_idx[0][2*d]   = innerFidx[2*d];
+    mg_idx[0][2*d+1] = innerFidx[2*d+1];
+  }
+  mg_ip[0] = (hd[0] + hd[1] + hd[2] + 1) % 2;
+  mg_s[0]  = 0.0;
+  mg_lv = 1;
+
+  // 境界節点から最外セル中心までの距離 dst と格子幅 h（細格子の格子幅単位）
+  double dst = 1.0;
+  double h   = 1.0;
+
+  while ( mg_lv < MG_LEVEL_MAX )
+  {
+    int flag = 0;
+    for (int d=0; d<3; d++)
+    {
+      if ( n[d] % 2 != 0 || n[d] < 4 ) flag = 1;
+    }
+    if ( !Comm_SUM_1(&flag) ) return false;
+    if ( flag > 0 ) break;
+
+    int l = mg_lv;
+
+    // ノード共有の分割では隣接ランクの基点が奇数なので，粗格子の基点は (hd-1)/2+1
+    for (int d=0; d<3; d++)
+    {
+      n[d] /= 2;
+      hd[d] = (hd[d] - 1) / 2 + 1;
+      mg_sz[l][d] = n[d] + 1 + ( (nID[2*d+1] < 0) ? 1 : 0 );
+      mg_idx[l][2*d]   = 2;
+      mg_idx[l][2*d+1] = n[d] + 1;
+    }
+    mg_ip[l] = (hd[0] + hd[1] + hd[2] + 1) % 2;
+
+    dst += 0.5 * h;
+    h   *= 2.0;
+    mg_s[l] = (REAL_TYPE)( (h - dst) / dst );
+
+    if( (mg_x[l] = czAllocR_S3D(mg_sz[l], var_type)) == NULL ) return false;
+    if( (mg_b[l] = czAllocR_S3D(mg_sz[l], var_type)) == NULL ) return false;
+
+    L_mem += (double)Size_S3D(mg_sz[l]) * 2.0 * (double)sizeof(REAL_TYPE);
+
+#ifndef DISABLE_MPI
+    if ( numProc > 1 )
+    {
+      if ( !CMg[l].setBrickComm(mg_sz[l], GUIDE, MPI_COMM_WORLD, nID, "node") ) return false;
+      if ( !CMg[l].init(1) ) return false;
+    }
+#endif
+
+    mg_lv++;
+  }
+
+  Hostonly_ printf("MG levels = %d  coarsest = %d %d %d\n",
+                   mg_lv, n[0], n[1], n[2]);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief Chebyshev反復の作業配列を確保
+ * @param [in,out] L_mem ローカルメモリサイズ
+ */
+bool CZ::setCheby(double& L_mem)
+{
+  if ( ls_type != LS_CHEBY && pc_type != LS_CHEBY ) return true;
+
+  REAL_TYPE var_type=0;
+
+  if( (chb_r = czAllocR_S3D(size, var_type)) == NULL ) return false;
+  if( (chb_d = czAllocR_S3D(size, var_type)) == NULL ) return false;
+  if( (chb_e = czAllocR_S3D(size, var_type)) == NULL ) return false;
+
+  L_mem += (double)Size_S3D(size) * 3.0 * (double)sizeof(REAL_TYPE);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 対称三重対角行列のk番目に小さい固有値（Sturm列による二分法）
+ * @param [in] m  次数
+ * @param [in] a  対角成分
+ * @param [in] b  副対角成分 b[0..m-2]
+ * @param [in] k  1からm
+ */
+static double tridiag_eigen(const int m, const double* a, const double* b, const int k)
+{
+  // Gershgorinの円板で範囲を抑える
+  double lo = a[0], hi = a[0];
+
+  for (int i=0; i<m; i++)
+  {
+    double r = 0.0;
+    if ( i > 0 )   r += fabs(b[i-1]);
+    if ( i < m-1 ) r += fabs(b[i]);
+    if ( a[i] - r < lo ) lo = a[i] - r;
+    if ( a[i] + r > hi ) hi = a[i] + r;
+  }
+
+  for (int n=0; n<100; n++)
+  {
+    double x = 0.5 * (lo + hi);
+
+    // xより小さい固有値の数
+    int c = 0;
+    double q = 1.0;
+    for (int i=0; i<m; i++)
+    {
+      double bb = (i > 0) ? b[i-1]*b[i-1] : 0.0;
+      q = a[i] - x - ( (i > 0) ? bb / q : 0.0 );
+      if ( q == 0.0 ) q = -DBL_MIN;
+      if ( q < 0.0 ) c++;
+    }
+
+    if ( c >= k ) hi = x;
+    else          lo = x;
+  }
+
+  return 0.5 * (lo + hi);
+}
+
+
+// #################################################################
+/* @brief Chebyshev反復の固有値の範囲をLanczos法で推定
+ * @note Jacobi前処理 D^{-1}A = -A/dd は定数係数で対称なので，Aに対してLanczos法を
+ *       CHEBY_LANCZOS回適用し，三重対角行列の両端の固有値から範囲を求める
+ *       最小固有値は過大に見積もられるが，範囲より小さい固有値の成分も減衰するので
+ *       収束が遅くなるだけで発散しない．最大固有値はCHEBY_SAFE倍して安全側にとる
+ *       セットアップで一度だけ呼ぶので，反復中の内積と集団通信は不要になる
+ */
+bool CZ::setChebyBound()
+{
+  if ( ls_type != LS_CHEBY && pc_type != LS_CHEBY ) return true;
+
+  int gc = GUIDE;
+  double flop = 0.0;
+  double al[CHEBY_LANCZOS], be[CHEBY_LANCZOS];
+  REAL_TYPE* v  = chb_r;
+  REAL_TYPE* vp = chb_d;
+  REAL_TYPE* w  = chb_e;
+
+  // 初期ベクトル
+  REAL_TYPE nrm = 0.0;
+  cheby_seed_(w, size, innerFidx, &gc, head);
+  blas_dot1_(&nrm, w, size, innerFidx, &gc, &flop);
+  if ( !Comm_SUM_1(&nrm) ) return false;
+
+  REAL_TYPE s = 1.0 / sqrt(nrm);
+  cheby_scal_(v, w, &s, size, innerFidx, &gc, &flop);
+
+  REAL_TYPE beta = 0.0;
+  int m = 0;
+
+  for (int j=0; j<CHEBY_LANCZOS; j++)
+  {
+    if ( !Comm_S(v, 1) ) return false;
+
+    // w = A v と (w, v)
+    REAL_TYPE alpha = 0.0;
+    blas_calc_ax_dot_(w, v, v, &alpha, size, innerFidx, &gc, cf, &flop);
+    if ( !Comm_SUM_1(&alpha) ) return false;
+
+    REAL_TYPE ww = 0.0;
+    cheby_lanczos_(w, v, vp, &alpha, &beta, &ww, size, innerFidx, &gc, &flop);
+    if ( !Comm_SUM_1(&ww) ) return false;
+
+    al[m++] = alpha;
+    beta = sqrt(ww);
+
+    if ( beta < FLT_MIN ) break; // 不変部分空間
+
+    be[j] = beta;
+    s = 1.0 / beta;
+    cheby_scal_(vp, w, &s, size, innerFidx, &gc, &flop);
+
+    REAL_TYPE* t = v;
+    v  = vp;
+    vp = t;
+  }
+
+  // Aの固有値は負
+  double e_min = tridiag_eigen(m, al, be, 1);
+  double e_max = tridiag_eigen(m, al, be, m);
+
+  chb_lo = -e_max / cf[6];
+  chb_hi = -e_min / cf[6] * CHEBY_SAFE;
+
+  Hostonly_ printf("Chebyshev bounds = [%e, %e] (Lanczos %d steps)\n", chb_lo, chb_hi, m);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief s-step BiCGSTABの基底とシフト
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note 基底 [P (2s+1本), R (2s本)] は1パスでGram行列を作るため連続領域に確保する
+ *       Newton基底のシフトは，Gershgorinの区間 [-2dd, 0] のChebyshev点 2s 個をLeja順に並べたもの
+ *       スケールは区間の容量 dd/2 とし，基底の大きさを s によらず O(1) に保つ
+ *       単項式基底はスペクトル半径の上限 2dd でスケールする
+ */
+bool CZ::setCAbasis(double& L_mem)
+{
+  if ( ls_type != LS_CA_BICGSTAB ) return true;
+
+  REAL_TYPE var_type=0;
+  int nb = 4*ca_s+1;
+  size_t nx = Size_S3D(size);
+
+  if( (ca_y  = czAllocR((int)(nx*nb), var_type)) == NULL ) return false;
+  if( (ca_rt = czAllocR_S3D(size, var_type)) == NULL ) return false;
+
+  L_mem += (double)nx * (double)(nb+1) * (double)sizeof(REAL_TYPE);
+
+  int m = 2*ca_s;
+  double c = -cf[6]; // 区間の中心
+  double d =  cf[6]; // 区間の半幅
+
+  if ( ca_basis == 0 )
+  {
+    ca_sg = 2.0 * d;
+    for (int k=0; k<m; k++) ca_th[k] = 0.0;
+    return true;
+  }
+
+  ca_sg = 0.5 * d;
+
+  double z[2*CA_S_MAX];
+  bool used[2*CA_S_MAX];
+
+  for (int k=0; k<m; k++)
+  {
+    z[k] = c + d * cos( (2.0*k+1.0) * M_PI / (2.0*m) );
+    used[k] = false;
+  }
+
+  // Leja順 0に最も近い点から始め，既に選んだ点からの距離の積が最大の点を順に選ぶ
+  // 残差多項式は0で1なので，最初の係数が O(1) に収まり桁落ちが小さい
+  for (int n=0; n<m; n++)
+  {
+    int kk = -1;
+    double q_max = -1.0;
+
+    for (int k=0; k<m; k++)
+    {
+      if ( used[k] ) continue;
+
+      double q = 1.0 / fabs(z[k]);
+      if ( n > 0 )
+      {
+        q = 1.0;
+        for (int l=0; l<n; l++) q *= fabs(z[k] - ca_th[l]);
+      }
+      if ( q > q_max ) { q_max = q; kk = k; }
+    }
+
+    ca_th[n] = z[kk];
+    used[kk] = true;
+  }
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief FGMRES(m)の基底
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note V (m+1本) と Z (m本) は1パスで内積と線形結合を求めるため，それぞれ連続領域に確保する
+ */
+bool CZ::setGMRES(double& L_mem)
+{
+  if ( ls_type != LS_FGMRES ) return true;
+
+  REAL_TYPE var_type=0;
+  size_t nx = Size_S3D(size);
+
+  if( (gm_v = czAllocR((int)(nx*(gm_m+1)), var_type)) == NULL ) return false;
+  if( (gm_z = czAllocR((int)(nx*gm_m), var_type)) == NULL ) return false;
+
+  L_mem += (double)nx * (double)(2*gm_m+1) * (double)sizeof(REAL_TYPE);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 繰り返し求解の初期値の推定に使う過去の解
+ * @param [in,out] L_mem ローカルメモリサイズ
+ * @note 過去の解と射影に使う残差は，1パスで線形結合とGram行列を求めるため連続領域に確保する
+ */
+bool CZ::setWarmStart(double& L_mem)
+{
+  REAL_TYPE var_type=0;
+  size_t nx = Size_S3D(size);
+
+  if ( ws_steps > 1 )
+  {
+    if( (ws_b = czAllocR_S3D(size, var_type)) == NULL ) return false;
+    L_mem += (double)nx * (double)sizeof(REAL_TYPE);
+  }
+
+  if ( ws_type == 0 ) return true;
+
+  if( (ws_x = czAllocR((int)(nx*ws_k), var_type)) == NULL ) return false;
+  L_mem += (double)nx * (double)ws_k * (double)sizeof(REAL_TYPE);
+
+  if ( ws_type == 2 )
+  {
+    if( (ws_r = czAllocR((int)(nx*ws_k), var_type)) == NULL ) return false;
+    L_mem += (double)nx * (double)ws_k * (double)sizeof(REAL_TYPE);
+  }
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 一括求解のRHS，解ベクトルと作業配列
+ * @param [in,out] L_mem  メモリ量
+ * @note [0]は P, RHS をそのまま使い，[1]以降を確保する
+ *       作業配列は x, b と BiCGstabの8本で，RHSの番号を最内に bt_n 本分を並べる
+ */
+bool CZ::setBatch(double& L_mem)
+{
+  REAL_TYPE var_type=0;
+  size_t nx = Size_S3D(size);
+
+  if ( bt_n == 1 ) return true;
+
+  bt_x[0] = P;
+  bt_b[0] = RHS;
+
+  for (int m=1; m<bt_n; m++)
+  {
+    if( (bt_x[m] = czAllocR_S3D(size, var_type)) == NULL ) return false;
+    if( (bt_b[m] = czAllocR_S3D(size, var_type)) == NULL ) return false;
+  }
+  L_mem += (double)nx * (double)(bt_n-1) * 2.0 * (double)sizeof(REAL_TYPE);
+
+  int nw = (ls_type == LS_BICGSTAB) ? 10 : 2;
+  if( (bt_w = czAllocR((int)(nx*bt_n*nw), var_type)) == NULL ) return false;
+  L_mem += (double)nx * (double)bt_n * (double)nw * (double)sizeof(REAL_TYPE);
+
+  if ( numProc > 1 )
+  {
+    bt_face = size[0] * size[1];
+    if ( size[1] * size[2] > bt_face ) bt_face = size[1] * size[2];
+    if ( size[2] * size[0] > bt_face ) bt_face = size[2] * size[0];
+
+    size_t nb = (size_t)bt_face * (size_t)GUIDE * (size_t)bt_n * 4;
+    if( (bt_buf = czAllocR((int)nb, var_type)) == NULL ) return false;
+    L_mem += (double)nb * (double)sizeof(REAL_TYPE);
+  }
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 色毎に分けたsor2smaの解ベクトルとRHS
+ * @param [in,out] L_mem  メモリ量
+ * @note K方向を色毎に詰めるので，各配列の大きさは自然順の約半分
+ */
+bool CZ::setColorSplit(double& L_mem)
+{
+  REAL_TYPE var_type=0;
+
+  if ( SW_split == 0 ) return true;
+
+  sp_nh = (size[2] + 2*GUIDE + 1) / 2;
+  size_t nx = (size_t)sp_nh * (size_t)(size[0]+2*GUIDE) * (size_t)(size[1]+2*GUIDE);
+
+  for (int c=0; c<2; c++)
+  {
+    if( (sp_x[c] = czAllocR((int)nx, var_type)) == NULL ) return false;
+    if( (sp_b[c] = czAllocR((int)nx, var_type)) == NULL ) return false;
+  }
+  L_mem += (double)nx * 4.0 * (double)sizeof(REAL_TYPE);
+
+  return true;
+}
+
+
+// #################################################################
+/* @brief 多色SORの区間ブロックの逆行列
+ * @param [in,out] L_mem  メモリ量
+ * @note 係数は定数なので，区間長 1..MC_STRIP の逆行列を一度だけ計算しておく
+ */
+bool CZ::setMCSOR(double& L_mem)
+{
+  REAL_TYPE var_type=0;
+
+  if ( ls_type != LS_MCSOR && pc_type != LS_MCSOR ) return true;
+
+  int w = MC_STRIP;
+  if( (MCT = czAllocR(w*w*w, var_type)) == NULL ) return false;
+  L_mem += (double)(w*w*w) * (double)sizeof(REAL_TYPE);
+
+  psor_mc_factorize_(cf, MCT);
+
+  return true;
+}
+
+
 // #################################################################
 /* @brief メモリ消費情報を表示
  * @param [in]     fp    ファイルポインタ
@@ -188,12 +988,20 @@ using namespace pm_lib;
   set_label("Blas_Residual",       PerfMonitor::CALC);
   set_label("Blas_BiCG_1",         PerfMonitor::CALC);
   set_label("Blas_BiCG_2",         PerfMonitor::CALC);
+  set_label("Blas_BiCG_3",         PerfMonitor::CALC);
+  set_label("Blas_CG_1",           PerfMonitor::CALC);
+  set_label("Blas_CG_2",           PerfMonitor::CALC);
+  set_label("Blas_CG_Dot",         PerfMonitor::CALC);
   set_label("Blas_AX",             PerfMonitor::CALC);
+  set_label("Blas_AX_Dot",         PerfMonitor::CALC);
   set_label("Blas_TRIAD",          PerfMonitor::CALC);
 
   set_label("JACOBI_kernel",    PerfMonitor::CALC, true);
   set_label("SOR_kernel",       PerfMonitor::CALC, true);
   set_label("SOR2SMA_kernel",   PerfMonitor::CALC, true);
+  set_label("SOR2SMA_Split_kernel", PerfMonitor::CALC, true);
+  set_label("SOR2SMA_Split_Pack",   PerfMonitor::CALC, true);
+  set_label("MCSOR_kernel",     PerfMonitor::CALC, true);
   set_label("LSOR2SMA_kernel",  PerfMonitor::CALC, true);
   set_label("LSOR_MS_kernel",   PerfMonitor::CALC, true);
   set_label("TDMA_kernel",      PerfMonitor::CALC, true);
@@ -242,11 +1050,30 @@ using namespace pm_lib;
   set_label("PCR",         PerfMonitor::CALC, true);
   set_label("PCR_MAF",     PerfMonitor::CALC, true);
   set_label("PCR_RB",         PerfMonitor::CALC, true);
+  set_label("PCR_RB_Lanes",   PerfMonitor::CALC, true);
+  set_label("PCR_RB_HYB",     PerfMonitor::CALC, true);
   set_label("PCR_RB_MAF",     PerfMonitor::CALC, true);
   set_label("PCR_J",         PerfMonitor::CALC, true);
+  set_label("PCR_Interface", PerfMonitor::CALC, true);
+
+  set_label("MG_Smooth",        PerfMonitor::CALC, true);
+  set_label("MG_Restrict",      PerfMonitor::CALC, true);
+  set_label("MG_Prolong",       PerfMonitor::CALC, true);
+  set_label("CHEBY_kernel",     PerfMonitor::CALC, true);
+  set_label("IR_Residual",      PerfMonitor::CALC, true);
+  set_label("IR_Update",        PerfMonitor::CALC, true);
+  set_label("CA_Basis",         PerfMonitor::CALC, true);
+  set_label("CA_Gram",          PerfMonitor::CALC, true);
+  set_label("CA_Update",        PerfMonitor::CALC, true);
+  set_label("GMRES_Dot",        PerfMonitor::CALC, true);
+  set_label("GMRES_AXPY",       PerfMonitor::CALC, true);
+  set_label("Batch_Pack",       PerfMonitor::CALC, true);
+  set_label("Batch_SOR2SMA_kernel", PerfMonitor::CALC, true);
 
   set_label("Comm_Poisson",     PerfMonitor::COMM);
   set_label("Comm_Res_Poisson", PerfMonitor::COMM);
+  set_label("Comm_PCR_K",       PerfMonitor::COMM);
+  set_label("Comm_Batch",       PerfMonitor::COMM);
 
   set_label("BoundaryCondition",PerfMonitor::CALC);
   set_label("VRtmp_Init",    PerfMonitor::CALC, true);
@@ -256,7 +1083,18 @@ using namespace pm_lib;
   set_label("JACOBI",           PerfMonitor::CALC, false);
   set_label("PSOR",             PerfMonitor::CALC, false);
   set_label("SOR2SMA",          PerfMonitor::CALC, false);
+  set_label("MCSOR",            PerfMonitor::CALC, false);
   set_label("PBiCGSTAB",        PerfMonitor::CALC, false);
+  set_label("PipeBiCGSTAB",     PerfMonitor::CALC, false);
+  set_label("CA_BiCGSTAB",      PerfMonitor::CALC, false);
+  set_label("FGMRES",           PerfMonitor::CALC, false);
+  set_label("Warm_Start",       PerfMonitor::CALC, false);
+  set_label("Batch_Solve",      PerfMonitor::CALC, false);
+  set_label("PCG",              PerfMonitor::CALC, false);
+  set_label("MG",               PerfMonitor::CALC, false);
+  set_label("CHEBY",            PerfMonitor::CALC, false);
+  set_label("IR",               PerfMonitor::CALC, false);
+  set_label("SOR_Auto",         PerfMonitor::CALC, false);
   set_label("LSOR",             PerfMonitor::CALC, false);
   set_label("LJCB",             PerfMonitor::CALC, false);
 }
@@ -0,0 +1,708 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+! 複数RHSの一括求解
+! 配列はRHSの番号 m を最内にした p(m,k,i,j) で，格子点毎の係数やステンシルの参照を nr 本で共有する
+
+
+!> ********************************************************************
+!! @brief スカラー配列を一括配列の m 番目へコピー
+!! @param [out]    xb   一括配列
+!! @param [in]     x    スカラー配列
+!! @param [in]     nr   RHSの本数
+!! @param [in]     m    書き込む番号 (0:nr-1)
+!! @param [in]     sz   配列長
+!! @param [in]     g    ガイドセル
+!<
+subroutine batch_pack (xb, x, nr, m, sz, g)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, nr, m
+integer, dimension(3)                                      ::  sz
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  xb
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+do j = 1-g, sz(2)+g
+do i = 1-g, sz(1)+g
+do k = 1-g, sz(3)+g
+  xb(m+1,k,i,j) = x(k,i,j)
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_pack
+
+
+!> ********************************************************************
+!! @brief 一括配列の m 番目をスカラー配列へコピー
+!! @param [out]    x    スカラー配列
+!! @param [in]     xb   一括配列
+!! @param [in]     nr   RHSの本数
+!! @param [in]     m    読み出す番号 (0:nr-1)
+!! @param [in]     sz   配列長
+!! @param [in]     g    ガイドセル
+!<
+subroutine batch_unpack (x, xb, nr, m, sz, g)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, nr, m
+integer, dimension(3)                                      ::  sz
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  xb
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+do j = 1-g, sz(2)+g
+do i = 1-g, sz(1)+g
+do k = 1-g, sz(3)+g
+  x(k,i,j) = xb(m+1,k,i,j)
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_unpack
+
+
+!> ********************************************************************
+!! @brief 一括配列のゼロクリア
+!! @param [out]    x    一括配列
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     g    ガイドセル
+!<
+subroutine batch_clear (x, nr, sz, g)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, nr, m
+integer, dimension(3)                                      ::  sz
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+do j = 1-g, sz(2)+g
+do i = 1-g, sz(1)+g
+do k = 1-g, sz(3)+g
+do m = 1, nr
+  x(m,k,i,j) = 0.0
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_clear
+
+
+!> ********************************************************************
+!! @brief 一括配列のコピー
+!! @param [out]    y    コピー先
+!! @param [in]     x    ソース
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     g    ガイドセル
+!<
+subroutine batch_copy (y, x, nr, sz, g)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, nr, m
+integer, dimension(3)                                      ::  sz
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, y
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+do j = 1-g, sz(2)+g
+do i = 1-g, sz(1)+g
+do k = 1-g, sz(3)+g
+do m = 1, nr
+  y(m,k,i,j) = x(m,k,i,j)
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_copy
+
+
+!> ********************************************************************
+!! @brief 2色オーダリングSORの1色分
+!! @param [in,out] p    解ベクトル
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     cf   係数
+!! @param [in]     ofst 開始点オフセット
+!! @param [in]     color グループ番号
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [in]     nr   RHSの本数
+!! @param [in,out] res  RHS毎の反復残差の二乗和
+!! @param [in,out] flop flop count
+!<
+subroutine batch_sor2sma (p, sz, idx, g, cf, ofst, color, omg, b, nr, res, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+double precision                                           ::  flop
+double precision, dimension(nr)                            ::  res, res1
+real                                                       ::  omg, dd, ss, dp, pp
+real                                                       ::  c1, c2, c3, c4, c5, c6
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+integer                                                    ::  kp, color, ofst
+real, dimension(7)                                         ::  cf
+
+kp = ofst+color
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+res1 = 0.0d0
+
+flop = flop + 18.0d0*0.5d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(pp, ss, dp, m) REDUCTION(+:res1)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(pp, ss, dp, m) REDUCTION(+:res1)
+#endif
+do j=jst,jed
+do i=ist,ied
+do k=kst+mod(i+j+kp,2), ked, 2
+!dir$ simd
+do m = 1, nr
+  pp = p(m,k,i,j)
+  ss = c1 * p(m,k  , i+1,j  ) &
+     + c2 * p(m,k  , i-1,j  ) &
+     + c3 * p(m,k  , i  ,j+1) &
+     + c4 * p(m,k  , i  ,j-1) &
+     + c5 * p(m,k+1, i  ,j  ) &
+     + c6 * p(m,k-1, i  ,j  )
+  dp = ( (ss - b(m,k,i,j))/dd - pp ) * omg
+  p(m,k,i,j) = pp + dp
+  res1(m) = res1(m) + dble(dp*dp)
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+res = res + res1
+
+return
+end subroutine batch_sor2sma
+
+
+!> ********************************************************************
+!! @brief 残差ベクトル r = b - A p
+!! @param [out]    r    残差ベクトル
+!! @param [in]     p    解ベクトル
+!! @param [in]     b    定数項
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine batch_calc_rk (r, p, b, nr, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real                                                       ::  dd, ss, c1, c2, c3, c4, c5, c6
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  r, p, b
+double precision                                           ::  flop
+real, dimension(7)                                         ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 14.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, m)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, m)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  ss = c1 * p(m,k  , i+1,j  ) &
+     + c2 * p(m,k  , i-1,j  ) &
+     + c3 * p(m,k  , i  ,j+1) &
+     + c4 * p(m,k  , i  ,j-1) &
+     + c5 * p(m,k+1, i  ,j  ) &
+     + c6 * p(m,k-1, i  ,j  )
+  r(m,k,i,j) = b(m,k,i,j) - (ss - dd * p(m,k,i,j))
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_calc_rk
+
+
+!> ********************************************************************
+!! @brief ap = A p と (ap, r0)
+!! @param [out]    ap   ベクトル
+!! @param [in]     p    ベクトル
+!! @param [in]     r0   ベクトル
+!! @param [out]    rr   RHS毎の内積
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine batch_calc_ax_dot (ap, p, r0, rr, nr, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real                                                       ::  dd, ss, q, c1, c2, c3, c4, c5, c6
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, r0
+double precision, dimension(nr)                            ::  rr
+double precision                                           ::  flop
+real, dimension(7)                                         ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+rr = 0.0d0
+
+flop = flop + 15.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, q, m) REDUCTION(+:rr)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, q, m) REDUCTION(+:rr)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  ss = c1 * p(m,k  , i+1,j  ) &
+     + c2 * p(m,k  , i-1,j  ) &
+     + c3 * p(m,k  , i  ,j+1) &
+     + c4 * p(m,k  , i  ,j-1) &
+     + c5 * p(m,k+1, i  ,j  ) &
+     + c6 * p(m,k-1, i  ,j  )
+  q = ss - dd * p(m,k,i,j)
+  ap(m,k,i,j) = q
+  rr(m) = rr(m) + dble(q * r0(m,k,i,j))
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_calc_ax_dot
+
+
+!> ********************************************************************
+!! @brief ap = A p と (ap, s), (ap, ap)
+!! @param [out]    ap   ベクトル
+!! @param [in]     p    ベクトル
+!! @param [in]     s    ベクトル
+!! @param [out]    as   RHS毎の内積 (ap, s)
+!! @param [out]    aa   RHS毎の内積 (ap, ap)
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine batch_calc_ax_dot2 (ap, p, s, as, aa, nr, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real                                                       ::  dd, ss, q, c1, c2, c3, c4, c5, c6
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, s
+double precision, dimension(nr)                            ::  as, aa
+double precision                                           ::  flop
+real, dimension(7)                                         ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+as = 0.0d0
+aa = 0.0d0
+
+flop = flop + 17.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, q, m) REDUCTION(+:as, aa)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, q, m) REDUCTION(+:as, aa)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  ss = c1 * p(m,k  , i+1,j  ) &
+     + c2 * p(m,k  , i-1,j  ) &
+     + c3 * p(m,k  , i  ,j+1) &
+     + c4 * p(m,k  , i  ,j-1) &
+     + c5 * p(m,k+1, i  ,j  ) &
+     + c6 * p(m,k-1, i  ,j  )
+  q = ss - dd * p(m,k,i,j)
+  ap(m,k,i,j) = q
+  as(m) = as(m) + dble(q * s(m,k,i,j))
+  aa(m) = aa(m) + dble(q * q)
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_calc_ax_dot2
+
+
+!> ********************************************************************
+!! @brief RHS毎の内積 (p, q)
+!! @param [out]    r    内積
+!! @param [in]     p    ベクトル
+!! @param [in]     q    ベクトル
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop flop count
+!<
+subroutine batch_dot2 (r, p, q, nr, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, q
+double precision, dimension(nr)                            ::  r
+double precision                                           ::  flop
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+r = 0.0d0
+
+flop = flop + 2.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(m) REDUCTION(+:r)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(m) REDUCTION(+:r)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  r(m) = r(m) + dble(p(m,k,i,j) * q(m,k,i,j))
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_dot2
+
+
+!> ********************************************************************
+!! @brief BiCGstabの探索方向 p = r + beta * (p - omg * q)
+!! @param [in,out] p    ベクトル
+!! @param [in]     r    ベクトル
+!! @param [in]     q    ベクトル
+!! @param [in]     beta RHS毎の係数
+!! @param [in]     omg  RHS毎の係数
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine batch_bicg_1 (p, r, q, beta, omg, nr, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, r, q
+double precision, dimension(nr)                            ::  beta, omg
+real, dimension(nr)                                        ::  b, w
+double precision                                           ::  flop
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+b = real(beta)
+w = real(omg)
+
+flop = flop + 4.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(m)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(m)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  p(m,k,i,j) = r(m,k,i,j) + b(m) * ( p(m,k,i,j) - w(m) * q(m,k,i,j) )
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_bicg_1
+
+
+!> ********************************************************************
+!! @brief AXPYZ z = a * x + y
+!! @param [out]    z    ベクトル
+!! @param [in]     x    ベクトル
+!! @param [in]     y    ベクトル
+!! @param [in]     a    RHS毎の係数
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine batch_triad (z, x, y, a, nr, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, y, z
+double precision, dimension(nr)                            ::  a
+real, dimension(nr)                                        ::  c
+double precision                                           ::  flop
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c = real(a)
+
+flop = flop + 2.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(m)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(m)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  z(m,k,i,j) = c(m) * x(m,k,i,j) + y(m,k,i,j)
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_triad
+
+
+!> ********************************************************************
+!! @brief BiCGstabの解と残差の更新，残差の内積の融合
+!! @param [in,out] x    解ベクトル x = x + a * p_ + b * s_
+!! @param [out]    r    残差ベクトル r = s - b * t
+!! @param [in]     p_   ベクトル
+!! @param [in]     s_   ベクトル
+!! @param [in]     s    ベクトル
+!! @param [in]     t    ベクトル
+!! @param [in]     r0   初期残差ベクトル
+!! @param [in]     a    RHS毎の係数 alpha
+!! @param [in]     b    RHS毎の係数 omega
+!! @param [out]    rr   RHS毎の内積 (r, r)
+!! @param [out]    rr0  RHS毎の内積 (r, r0)
+!! @param [in]     nr   RHSの本数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine batch_bicg_3 (x, r, p_, s_, s, t, r0, a, b, rr, rr0, nr, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                    ::  i, j, k, g, m, nr
+integer                                                    ::  ist, jst, kst
+integer                                                    ::  ied, jed, ked
+integer, dimension(3)                                      ::  sz
+integer, dimension(0:5)                                    ::  idx
+real, dimension(nr, 1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, r, p_, s_, s, t, r0
+double precision, dimension(nr)                            ::  a, b, rr, rr0
+real, dimension(nr)                                        ::  ca, cb
+real                                                       ::  q
+double precision                                           ::  flop
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+ca = real(a)
+cb = real(b)
+
+rr  = 0.0d0
+rr0 = 0.0d0
+
+flop = flop + 10.0d0*dble(nr) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(q, m) REDUCTION(+:rr, rr0)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(q, m) REDUCTION(+:rr, rr0)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+!dir$ simd
+do m = 1, nr
+  x(m,k,i,j) = ca(m) * p_(m,k,i,j) + cb(m) * s_(m,k,i,j) + x(m,k,i,j)
+  q = s(m,k,i,j) - cb(m) * t(m,k,i,j)
+  r(m,k,i,j) = q
+  rr(m)  = rr(m)  + dble(q * q)
+  rr0(m) = rr0(m) + dble(q * r0(m,k,i,j))
+end do
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine batch_bicg_3
@@ -22,13 +22,14 @@
 !! @param [in]     g  ガイドセル
 !<
 subroutine imask_k(x, sz, idx, g)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
 !dir$ assume_aligned x:64
 
 ix = sz(1)
@@ -110,10 +111,11 @@ end subroutine imask_k
 !! @param [in]     g  ガイドセル
 !<
 subroutine blas_clear(x, sz, g)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer, dimension(3)                                  ::  sz
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
 !dir$ assume_aligned x:64
 
 ix = sz(1)
@@ -157,10 +159,11 @@ end subroutine blas_clear
 !! @param [in]     g  ガイドセル
 !<
 subroutine blas_copy(y, x, sz, g)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer, dimension(3)                                  ::  sz
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  y, x
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  y, x
 !dir$ assume_aligned x:64, y:64
 ix = sz(1)
 jx = sz(2)
@@ -203,10 +206,11 @@ end subroutine blas_copy
 !! @param [in]     g  ガイドセル
 !<
 subroutine blas_copy_in(y, x, sz, g)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer, dimension(3)                                  ::  sz
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  y, x
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  y, x
 !dir$ assume_aligned x:64, y:64
 
 ix = sz(1)
@@ -241,6 +245,60 @@ end do
 return
 end subroutine blas_copy_in
 
+
+!> ********************************************************************
+!! @brief インデクス範囲のコピー
+!! @param [out]    y   コピー先
+!! @param [in]     x   ソース
+!! @param [in]     sz  配列長
+!! @param [in]     idx インデクス範囲
+!! @param [in]     g   ガイドセル
+!<
+subroutine blas_copy_idx(y, x, sz, idx, g)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  y, x
+!dir$ assume_aligned x:64, y:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(3)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+#endif
+#endif
+do j=jst,jed
+do i=ist,ied
+do k=kst,ked
+y(k,i,j) = x(k,i,j)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine blas_copy_idx
+
 !> ********************************************************************
 !! @brief AXPYZ
 !! @param [out]    z    ベクトル
@@ -253,13 +311,14 @@ end subroutine blas_copy_in
 !! @param [in,out] flop 浮動小数点演算数
 !<
 subroutine blas_triad(z, x, y, a, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, y, z
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, y, z
 double precision                                       ::  flop
 real                                                   ::  a
 !dir$ assume_aligned x:64, y:64, z:64
@@ -318,13 +377,14 @@ end subroutine blas_triad
 !! @param [out] flop flop count
 !<
 subroutine blas_dot1(r, p, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p
 double precision                                       ::  flop
 real                                                   ::  q, r
 !dir$ assume_aligned p:64
@@ -384,13 +444,14 @@ end subroutine blas_dot1
 !! @param [in,out] flop flop count
 !<
 subroutine blas_dot2(r, p, q, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, q
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, q
 double precision                                       ::  flop
 real                                                   ::  r
 !dir$ assume_aligned p:64, q:64
@@ -450,13 +511,14 @@ end subroutine blas_dot2
 !! @param [in,out] flop 浮動小数点演算数
 !<
 subroutine blas_bicg_1(p, r, q, beta, omg, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, r, q
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, r, q
 double precision                                       ::  flop
 real                                                   ::  beta, omg
 !dir$ assume_aligned p:64, q:64, r:64
@@ -515,13 +577,14 @@ end subroutine blas_bicg_1
 !! @param [in]     flop 浮動小数点演算数
 !<
 subroutine blas_bicg_2(z, x, y, a, b, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, y, z
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, y, z
 double precision                                       ::  flop
 real                                                   ::  a, b
 !dir$ assume_aligned x:64, y:64, z:64
@@ -567,27 +630,35 @@ end subroutine blas_bicg_2
 
 
 !> ********************************************************************
-!! @brief AX
-!! @param [out] ap   AX
-!! @param [in]  p    解ベクトル
-!! @param [in]  sz   配列長
-!! @param [in]  idx  インデクス範囲
-!! @param [in]  g    ガイドセル
-!! @param [in]  cf   係数
-!! @param [in,out] flop flop count
+!! @brief BiCGstabの解と残差の更新，残差の内積の融合
+!! @param [in,out] x    解ベクトル x = x + a * p_ + b * s_
+!! @param [out]    r    残差ベクトル r = s - b * t
+!! @param [in]     p_   ベクトル
+!! @param [in]     s_   ベクトル
+!! @param [in]     s    ベクトル
+!! @param [in]     t    ベクトル
+!! @param [in]     r0   初期残差ベクトル
+!! @param [in]     a    係数 alpha
+!! @param [in]     b    係数 omega
+!! @param [out]    rr   内積 (r, r)
+!! @param [out]    rr0  内積 (r, r0)
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
 !<
-subroutine blas_calc_ax(ap, p, sz, idx, g, cf, flop)
+subroutine blas_bicg_3(x, r, p_, s_, s, t, r0, a, b, rr, rr0, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  ap, p
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, r, p_, s_, s, t, r0
 double precision                                       ::  flop
-real, dimension(7)                                     ::  cf
-!dir$ assume_aligned ap:64, p:64
+real                                                   ::  a, b, rr, rr0, q
+!dir$ assume_aligned x:64, r:64, p_:64, s_:64, s:64, t:64, r0:64
 
 ist = idx(0)
 ied = idx(1)
@@ -596,40 +667,32 @@ jed = idx(3)
 kst = idx(4)
 ked = idx(5)
 
-c1 = cf(1)
-c2 = cf(2)
-c3 = cf(3)
-c4 = cf(4)
-c5 = cf(5)
-c6 = cf(6)
-dd = cf(7)
+rr  = 0.0
+rr0 = 0.0
 
-flop = flop + 13.0d0   &
+flop = flop + 10.0d0   &
      * dble(ied-ist+1) &
      * dble(jed-jst+1) &
      * dble(ked-kst+1)
 
-
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(3) private(ss)
+!$acc loop independent collapse(3) private(q) reduction(+:rr, rr0)
 #else
 #ifdef __NEC__
-!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss)
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(q) REDUCTION(+:rr, rr0)
 #else
-!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss)
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(q) REDUCTION(+:rr, rr0)
 #endif
 #endif
 do j = jst, jed
 do i = ist, ied
 do k = kst, ked
-  ss = c1 * p(k  , i+1,j  ) &
-     + c2 * p(k  , i-1,j  ) &
-     + c3 * p(k  , i  ,j+1) &
-     + c4 * p(k  , i  ,j-1) &
-     + c5 * p(k+1, i  ,j  ) &
-     + c6 * p(k-1, i  ,j  )
-  ap(k, i, j) = (ss - dd * p(k, i, j))
+  x(k,i,j) = a * p_(k,i,j) + b * s_(k,i,j) + x(k,i,j)
+  q = s(k,i,j) - b * t(k,i,j)
+  r(k,i,j) = q
+  rr  = rr  + q * q
+  rr0 = rr0 + q * r0(k,i,j)
 end do
 end do
 end do
@@ -641,32 +704,31 @@ end do
 
 
 return
-end subroutine blas_calc_ax
+end subroutine blas_bicg_3
 
 
 !> ********************************************************************
-!! @brief 残差ベクトルの計算
-!! @param [out]    r    残差ベクトル
-!! @param [in]     p    解ベクトル
-!! @param [in]     b    定数項
+!! @brief CGの探索方向の更新 p = z + beta * p
+!! @param [in,out] p    探索方向ベクトル
+!! @param [in]     z    前処理後の残差ベクトル
+!! @param [in]     beta 係数
 !! @param [in]     sz   配列長
 !! @param [in]     idx  インデクス範囲
 !! @param [in]     g    ガイドセル
-!! @param [in]     cf   係数
-!! @param [in,out] flop flop count
+!! @param [in,out] flop 浮動小数点演算数
 !<
-subroutine blas_calc_rk(r, p, b, sz, idx, g, cf, flop)
+subroutine blas_cg_1(p, z, beta, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
-integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  r, p, b
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, z
 double precision                                       ::  flop
-real, dimension(7)                                     ::  cf
-!dir$ assume_aligned r:64, p:64, b:64
+real                                                   ::  beta
+!dir$ assume_aligned p:64, z:64
 
 ist = idx(0)
 ied = idx(1)
@@ -675,15 +737,7 @@ jed = idx(3)
 kst = idx(4)
 ked = idx(5)
 
-c1 = cf(1)
-c2 = cf(2)
-c3 = cf(3)
-c4 = cf(4)
-c5 = cf(5)
-c6 = cf(6)
-dd = cf(7)
-
-flop = flop + 14.0d0   &
+flop = flop + 2.0d0    &
      * dble(ied-ist+1) &
      * dble(jed-jst+1) &
      * dble(ked-kst+1)
@@ -691,24 +745,18 @@ flop = flop + 14.0d0   &
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(3) private(ss)
+!$acc loop independent collapse(3)
 #else
 #ifdef __NEC__
-!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss)
+!$OMP PARALLEL DO SCHEDULE(static)
 #else
-!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss)
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
 #endif
 #endif
 do j = jst, jed
 do i = ist, ied
 do k = kst, ked
-  ss = c1 * p(k  , i+1,j  ) &
-     + c2 * p(k  , i-1,j  ) &
-     + c3 * p(k  , i  ,j+1) &
-     + c4 * p(k  , i  ,j-1) &
-     + c5 * p(k+1, i  ,j  ) &
-     + c6 * p(k-1, i  ,j  )
-  r(k, i, j) = (b(k, i, j) - (ss - dd * p(k, i, j)))
+  p(k,i,j) = z(k,i,j) + beta * p(k,i,j)
 end do
 end do
 end do
@@ -720,37 +768,34 @@ end do
 
 
 return
-end subroutine blas_calc_rk
+end subroutine blas_cg_1
 
 
 !> ********************************************************************
-!! @brief 残差ベクトルの計算
-!! @param [out]    r    残差ベクトル
-!! @param [in]     p    解ベクトル
-!! @param [in]     b    定数項
+!! @brief CGの解と残差の更新，残差の内積の融合
+!! @param [in,out] x    解ベクトル x = x + a * p
+!! @param [in,out] r    残差ベクトル r = r - a * q
+!! @param [in]     p    探索方向ベクトル
+!! @param [in]     q    ベクトル q = A p
+!! @param [in]     a    係数 alpha
+!! @param [out]    rr   内積 (r, r)
 !! @param [in]     sz   配列長
 !! @param [in]     idx  インデクス範囲
 !! @param [in]     g    ガイドセル
-!! @param [in]     X,Y,Z  座標
-!! @param [in]     pvt  行の最大係数
-!! @param [in,out] flop flop count
+!! @param [in,out] flop 浮動小数点演算数
 !<
-subroutine calc_rk_maf(r, p, b, sz, idx, g, X, Y, Z, pvt, flop)
+subroutine blas_cg_2(x, r, p, q, a, rr, sz, idx, g, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
-integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-real                                                   ::  GX, EY, TZ, YJA, YJAI
-real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
-real                                                   ::  C1, C2, C3, C7, C8, C9
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  r, p, b, pvt
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, r, p, q
 double precision                                       ::  flop
-real, dimension(-1:sz(1)+2)                            ::  X
-real, dimension(-1:sz(2)+2)                            ::  Y
-real, dimension(-1:sz(3)+2)                            ::  Z
-!dir$ assume_aligned r:64, p:64, b:64, X:64, Y:64, Z:64, pvt:64
+real                                                   ::  a, rr, s
+!dir$ assume_aligned x:64, r:64, p:64, q:64
 
 ist = idx(0)
 ied = idx(1)
@@ -759,66 +804,103 @@ jed = idx(3)
 kst = idx(4)
 ked = idx(5)
 
-flop = flop + 63.0d0   &
+rr = 0.0
+
+flop = flop + 6.0d0    &
      * dble(ied-ist+1) &
      * dble(jed-jst+1) &
      * dble(ked-kst+1)
 
-
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(3)
+!$acc loop independent collapse(3) private(s) reduction(+:rr)
 #else
 #ifdef __NEC__
-!$OMP PARALLEL DO &
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(s) REDUCTION(+:rr)
 #else
-!$OMP PARALLEL DO Collapse(2) &
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s) REDUCTION(+:rr)
 #endif
-!$OMP PRIVATE(XG, YE, ZT, XGG, YEE, ZTT) &
-!$OMP PRIVATE(GX, EY, TZ, YJA, YJAI) &
-!$OMP PRIVATE(C1, C2, C3, C7, C8, C9)
 #endif
 do j = jst, jed
 do i = ist, ied
 do k = kst, ked
+  x(k,i,j) = x(k,i,j) + a * p(k,i,j)
+  s = r(k,i,j) - a * q(k,i,j)
+  r(k,i,j) = s
+  rr = rr + s * s
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
 
-XG = 0.5 * (X(i+1) - X(i-1))
-YE = 0.5 * (Y(j+1) - Y(j-1))
-ZT = 0.5 * (Z(k+1) - Z(k-1)) ! 6
 
-XGG= X(i+1) - 2.0*X(i) + X(i-1)
-YEE= Y(j+1) - 2.0*Y(j) + Y(j-1)
-ZTT= Z(k+1) - 2.0*Z(k) + Z(k-1) ! 9
+return
+end subroutine blas_cg_2
 
-! Jacobian
-YJA  = XG * YE * ZT
-YJAI = 1.0 / YJA    ! 3
 
-! 1st order
-GX =  YE * ZT * YJAI
-EY =  XG * ZT * YJAI
-TZ =  XG * YE * YJAI ! 6
+!> ********************************************************************
+!! @brief CGの2つの内積 (z, r), (z, q) を1パスで
+!! @param [out]    rz   内積 (z, r)
+!! @param [out]    zq   内積 (z, q)
+!! @param [in]     z    前処理後の残差ベクトル
+!! @param [in]     r    残差ベクトル
+!! @param [in]     q    ベクトル
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine blas_cg_dot(rz, zq, z, r, q, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  z, r, q
+double precision                                       ::  flop
+real                                                   ::  rz, zq, s
+!dir$ assume_aligned z:64, r:64, q:64
 
-! Laplacian
-C1 =  GX * GX
-C2 =  EY * EY
-C3 =  TZ * TZ
-C7 = -XGG * C1 * GX
-C8 = -YEE * C2 * EY
-C9 = -ZTT * C3 * TZ ! 9
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
 
-r(k,i,j) = ( b(k,i,j)                           &
-         + 2.0 * (C1 + C2 + C3) * P(k,i,j)      &
-         - (C1 + 0.5 * C7) * P(k  , i+1, j  )   &
-         - (C1 - 0.5 * C7) * P(k  , i-1, j  )   &
-         - (C2 + 0.5 * C8) * P(k  , i  , j+1)   &
-         - (C2 - 0.5 * C8) * P(k  , i  , j-1)   &
-         - (C3 + 0.5 * C9) * P(k+1, i  , j  )   &
-         - (C3 - 0.5 * C9) * P(k-1, i  , j  ) ) &
-         * pvt(k,i,j) ! 30
-enddo
-enddo
-enddo
+rz = 0.0
+zq = 0.0
+
+flop = flop + 4.0d0    &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(s) reduction(+:rz, zq)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(s) REDUCTION(+:rz, zq)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s) REDUCTION(+:rz, zq)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  s = z(k,i,j)
+  rz = rz + s * r(k,i,j)
+  zq = zq + s * q(k,i,j)
+end do
+end do
+end do
 #ifdef _OPENACC
 !$acc end kernels
 #else
@@ -826,9 +908,8 @@ enddo
 #endif
 
 
-
 return
-end subroutine calc_rk_maf
+end subroutine blas_cg_dot
 
 
 !> ********************************************************************
@@ -838,25 +919,22 @@ end subroutine calc_rk_maf
 !! @param [in]  sz   配列長
 !! @param [in]  idx  インデクス範囲
 !! @param [in]  g    ガイドセル
-!! @param [in]     X,Y,Z  座標
-!! @param [in]     pvt  行の最大係数
+!! @param [in]  cf   係数
 !! @param [in,out] flop flop count
 !<
-subroutine calc_ax_maf(ap, p, sz, idx, g, X, Y, Z, pvt, flop)
+subroutine blas_calc_ax(ap, p, sz, idx, g, cf, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer, dimension(3)                                  ::  sz
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(0:5)                                ::  idx
-real                                                   ::  GX, EY, TZ, YJA, YJAI
-real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
-real                                                   ::  C1, C2, C3, C7, C8, C9
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  ap, p, pvt
+real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p
 double precision                                       ::  flop
-real, dimension(-1:sz(1)+2)                            ::  X
-real, dimension(-1:sz(2)+2)                            ::  Y
-real, dimension(-1:sz(3)+2)                            ::  Z
+real, dimension(7)                                     ::  cf
+!dir$ assume_aligned ap:64, p:64
 
 ist = idx(0)
 ied = idx(1)
@@ -865,7 +943,15 @@ jed = idx(3)
 kst = idx(4)
 ked = idx(5)
 
-flop = flop + 63.0d0   &
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 13.0d0   &
      * dble(ied-ist+1) &
      * dble(jed-jst+1) &
      * dble(ked-kst+1)
@@ -873,15 +959,611 @@ flop = flop + 63.0d0   &
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(3)
+!$acc loop independent collapse(3) private(ss)
 #else
 #ifdef __NEC__
-!$OMP PARALLEL DO &
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss)
 #else
-!$OMP PARALLEL DO Collapse(2) &
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss)
 #endif
-!$OMP PRIVATE(XG, YE, ZT, XGG, YEE, ZTT) &
-!$OMP PRIVATE(GX, EY, TZ, YJA, YJAI) &
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  ap(k, i, j) = (ss - dd * p(k, i, j))
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine blas_calc_ax
+
+
+!> ********************************************************************
+!! @brief AXと内積の融合
+!! @param [out] ap   AX
+!! @param [in]  p    解ベクトル
+!! @param [in]  r0   ベクトル
+!! @param [out] rr   内積 (AX, r0)
+!! @param [in]  sz   配列長
+!! @param [in]  idx  インデクス範囲
+!! @param [in]  g    ガイドセル
+!! @param [in]  cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine blas_calc_ax_dot(ap, p, r0, rr, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
+real                                                   ::  rr, q
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, r0
+double precision                                       ::  flop
+real, dimension(7)                                     ::  cf
+!dir$ assume_aligned ap:64, p:64, r0:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+rr = 0.0
+
+flop = flop + 15.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, q) reduction(+:rr)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, q) REDUCTION(+:rr)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, q) REDUCTION(+:rr)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  q = ss - dd * p(k, i, j)
+  ap(k, i, j) = q
+  rr = rr + q * r0(k, i, j)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine blas_calc_ax_dot
+
+
+!> ********************************************************************
+!! @brief AXと2つの内積の融合
+!! @param [out] ap   AX
+!! @param [in]  p    解ベクトル
+!! @param [in]  s    ベクトル
+!! @param [out] as   内積 (AX, s)
+!! @param [out] aa   内積 (AX, AX)
+!! @param [in]  sz   配列長
+!! @param [in]  idx  インデクス範囲
+!! @param [in]  g    ガイドセル
+!! @param [in]  cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine blas_calc_ax_dot2(ap, p, s, as, aa, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
+real                                                   ::  as, aa, q
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, s
+double precision                                       ::  flop
+real, dimension(7)                                     ::  cf
+!dir$ assume_aligned ap:64, p:64, s:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+as = 0.0
+aa = 0.0
+
+flop = flop + 17.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, q) reduction(+:as, aa)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, q) REDUCTION(+:as, aa)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, q) REDUCTION(+:as, aa)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  q = ss - dd * p(k, i, j)
+  ap(k, i, j) = q
+  as = as + q * s(k, i, j)
+  aa = aa + q * q
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine blas_calc_ax_dot2
+
+
+!> ********************************************************************
+!! @brief 残差ベクトルの計算
+!! @param [out]    r    残差ベクトル
+!! @param [in]     p    解ベクトル
+!! @param [in]     b    定数項
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in,out] flop flop count
+!<
+subroutine blas_calc_rk(r, p, b, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real                                                   ::  dd, ss, c1, c2, c3, c4, c5, c6
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  r, p, b
+double precision                                       ::  flop
+real, dimension(7)                                     ::  cf
+!dir$ assume_aligned r:64, p:64, b:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 14.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  r(k, i, j) = (b(k, i, j) - (ss - dd * p(k, i, j)))
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine blas_calc_rk
+
+
+!> ********************************************************************
+!! @brief 反復改良の残差ベクトル（倍精度で計算）
+!! @param [out]    r    残差ベクトル b - A (x + xl) の丸め
+!! @param [in]     x    解ベクトルの上位
+!! @param [in]     xl   解ベクトルの下位
+!! @param [in]     b    定数項
+!! @param [out]    res  残差の二乗和（倍精度）
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in,out] flop flop count
+!! @note 解は x + xl の2語で倍精度相当の値を保持する
+!<
+subroutine ir_residual(r, x, xl, b, res, sz, idx, g, cf, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  dd, ss, rr, res
+double precision                                       ::  c1, c2, c3, c4, c5, c6
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  r, x, xl, b
+double precision                                       ::  flop
+real, dimension(7)                                     ::  cf
+!dir$ assume_aligned r:64, x:64, xl:64, b:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = dble(cf(1))
+c2 = dble(cf(2))
+c3 = dble(cf(3))
+c4 = dble(cf(4))
+c5 = dble(cf(5))
+c6 = dble(cf(6))
+dd = dble(cf(7))
+
+res = 0.0d0
+
+flop = flop + 23.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, rr) reduction(+:res)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, rr) REDUCTION(+:res)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, rr) REDUCTION(+:res)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  ss = c1 * (dble(x(k  , i+1,j  )) + dble(xl(k  , i+1,j  ))) &
+     + c2 * (dble(x(k  , i-1,j  )) + dble(xl(k  , i-1,j  ))) &
+     + c3 * (dble(x(k  , i  ,j+1)) + dble(xl(k  , i  ,j+1))) &
+     + c4 * (dble(x(k  , i  ,j-1)) + dble(xl(k  , i  ,j-1))) &
+     + c5 * (dble(x(k+1, i  ,j  )) + dble(xl(k+1, i  ,j  ))) &
+     + c6 * (dble(x(k-1, i  ,j  )) + dble(xl(k-1, i  ,j  )))
+  rr = dble(b(k, i, j)) - (ss - dd * (dble(x(k, i, j)) + dble(xl(k, i, j))))
+  r(k, i, j) = real(rr)
+  res = res + rr * rr
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine ir_residual
+
+
+!> ********************************************************************
+!! @brief 反復改良の解の更新 x + xl <- x + xl + d
+!! @param [in,out] x    解ベクトルの上位
+!! @param [in,out] xl   解ベクトルの下位
+!! @param [in]     d    修正量
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop flop count
+!! @note 和を倍精度で求め，上位に丸めた値と丸め誤差を下位に分けて格納する
+!<
+subroutine ir_update(x, xl, d, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  s
+real                                                   ::  h
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, xl, d
+double precision                                       ::  flop
+!dir$ assume_aligned x:64, xl:64, d:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 3.0d0    &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(s, h)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(s, h)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s, h)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  s = dble(x(k, i, j)) + dble(xl(k, i, j)) + dble(d(k, i, j))
+  h = real(s)
+  x(k, i, j)  = h
+  xl(k, i, j) = real(s - dble(h))
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine ir_update
+
+
+!> ********************************************************************
+!! @brief 残差ベクトルの計算
+!! @param [out]    r    残差ベクトル
+!! @param [in]     p    解ベクトル
+!! @param [in]     b    定数項
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     X,Y,Z  座標
+!! @param [in]     pvt  行の最大係数
+!! @param [in,out] flop flop count
+!<
+subroutine calc_rk_maf(r, p, b, sz, idx, g, X, Y, Z, pvt, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real                                                   ::  GX, EY, TZ, YJA, YJAI
+real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
+real                                                   ::  C1, C2, C3, C7, C8, C9
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  r, p, b, pvt
+double precision                                       ::  flop
+real, dimension(-1:sz(1)+2)                            ::  X
+real, dimension(-1:sz(2)+2)                            ::  Y
+real, dimension(-1:sz(3)+2)                            ::  Z
+!dir$ assume_aligned r:64, p:64, b:64, X:64, Y:64, Z:64, pvt:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 63.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO &
+#else
+!$OMP PARALLEL DO Collapse(2) &
+#endif
+!$OMP PRIVATE(XG, YE, ZT, XGG, YEE, ZTT) &
+!$OMP PRIVATE(GX, EY, TZ, YJA, YJAI) &
+!$OMP PRIVATE(C1, C2, C3, C7, C8, C9)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+
+XG = 0.5 * (X(i+1) - X(i-1))
+YE = 0.5 * (Y(j+1) - Y(j-1))
+ZT = 0.5 * (Z(k+1) - Z(k-1)) ! 6
+
+XGG= X(i+1) - 2.0*X(i) + X(i-1)
+YEE= Y(j+1) - 2.0*Y(j) + Y(j-1)
+ZTT= Z(k+1) - 2.0*Z(k) + Z(k-1) ! 9
+
+! Jacobian
+YJA  = XG * YE * ZT
+YJAI = 1.0 / YJA    ! 3
+
+! 1st order
+GX =  YE * ZT * YJAI
+EY =  XG * ZT * YJAI
+TZ =  XG * YE * YJAI ! 6
+
+! Laplacian
+C1 =  GX * GX
+C2 =  EY * EY
+C3 =  TZ * TZ
+C7 = -XGG * C1 * GX
+C8 = -YEE * C2 * EY
+C9 = -ZTT * C3 * TZ ! 9
+
+r(k,i,j) = ( b(k,i,j)                           &
+         + 2.0 * (C1 + C2 + C3) * P(k,i,j)      &
+         - (C1 + 0.5 * C7) * P(k  , i+1, j  )   &
+         - (C1 - 0.5 * C7) * P(k  , i-1, j  )   &
+         - (C2 + 0.5 * C8) * P(k  , i  , j+1)   &
+         - (C2 - 0.5 * C8) * P(k  , i  , j-1)   &
+         - (C3 + 0.5 * C9) * P(k+1, i  , j  )   &
+         - (C3 - 0.5 * C9) * P(k-1, i  , j  ) ) &
+         * pvt(k,i,j) ! 30
+enddo
+enddo
+enddo
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+
+return
+end subroutine calc_rk_maf
+
+
+!> ********************************************************************
+!! @brief AX
+!! @param [out] ap   AX
+!! @param [in]  p    解ベクトル
+!! @param [in]  sz   配列長
+!! @param [in]  idx  インデクス範囲
+!! @param [in]  g    ガイドセル
+!! @param [in]     X,Y,Z  座標
+!! @param [in]     pvt  行の最大係数
+!! @param [in,out] flop flop count
+!<
+subroutine calc_ax_maf(ap, p, sz, idx, g, X, Y, Z, pvt, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real                                                   ::  GX, EY, TZ, YJA, YJAI
+real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
+real                                                   ::  C1, C2, C3, C7, C8, C9
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, pvt
+double precision                                       ::  flop
+real, dimension(-1:sz(1)+2)                            ::  X
+real, dimension(-1:sz(2)+2)                            ::  Y
+real, dimension(-1:sz(3)+2)                            ::  Z
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 63.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO &
+#else
+!$OMP PARALLEL DO Collapse(2) &
+#endif
+!$OMP PRIVATE(XG, YE, ZT, XGG, YEE, ZTT) &
+!$OMP PRIVATE(GX, EY, TZ, YJA, YJAI) &
 !$OMP PRIVATE(C1, C2, C3, C7, C8, C9)
 #endif
 do j = jst, jed
@@ -936,6 +1618,157 @@ return
 end subroutine calc_ax_maf
 
 
+!> ********************************************************************
+!! @brief 残差ベクトルの計算（計量係数の配列版）
+!! @param [out]    r    残差ベクトル
+!! @param [in]     p    解ベクトル
+!! @param [in]     b    定数項
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     MX,MY,MZ  計量係数
+!! @param [in]     pvt  行の最大係数
+!! @param [in,out] flop flop count
+!<
+subroutine calc_rk_mtr(r, p, b, sz, idx, g, MX, MY, MZ, pvt, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  r, p, b, pvt
+double precision                                       ::  flop
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+!dir$ assume_aligned r:64, p:64, b:64, pvt:64
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 17.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO
+#else
+!$OMP PARALLEL DO Collapse(2)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+r(k,i,j) = ( b(k,i,j)                                    &
+         + (MX(3,i) + MY(3,j) + MZ(3,k)) * P(k,i,j) &
+         - MX(2,i) * P(k  , i+1, j  )   &
+         - MX(1,i) * P(k  , i-1, j  )   &
+         - MY(2,j) * P(k  , i  , j+1)   &
+         - MY(1,j) * P(k  , i  , j-1)   &
+         - MZ(2,k) * P(k+1, i  , j  )   &
+         - MZ(1,k) * P(k-1, i  , j  ) ) &
+         * pvt(k,i,j) ! 17
+enddo
+enddo
+enddo
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+
+return
+end subroutine calc_rk_mtr
+
+
+!> ********************************************************************
+!! @brief AX（計量係数の配列版）
+!! @param [out] ap   AX
+!! @param [in]  p    解ベクトル
+!! @param [in]  sz   配列長
+!! @param [in]  idx  インデクス範囲
+!! @param [in]  g    ガイドセル
+!! @param [in]     MX,MY,MZ  計量係数
+!! @param [in]     pvt  行の最大係数
+!! @param [in,out] flop flop count
+!<
+subroutine calc_ax_mtr(ap, p, sz, idx, g, MX, MY, MZ, pvt, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  ap, p, pvt
+double precision                                       ::  flop
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 17.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO
+#else
+!$OMP PARALLEL DO Collapse(2)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+ap(k,i,j) = (                                        &
+          + MX(2,i) * P(k  , i+1, j  )               &
+          + MX(1,i) * P(k  , i-1, j  )               &
+          + MY(2,j) * P(k  , i  , j+1)               &
+          + MY(1,j) * P(k  , i  , j-1)               &
+          + MZ(2,k) * P(k+1, i  , j  )               &
+          + MZ(1,k) * P(k-1, i  , j  )               &
+          - (MX(3,i) + MY(3,j) + MZ(3,k)) * P(k,i,j) ) &
+          * pvt(k,i,j) ! 17
+enddo
+enddo
+enddo
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+
+return
+end subroutine calc_ax_mtr
+
+
 !> ********************************************************************
 !! @brief 最大要素探索
 !! @param [out]    pvt  行の最大要素
@@ -945,6 +1778,7 @@ end subroutine calc_ax_maf
 !! @param [in]     X,Y,Z  座標
 !<
 subroutine search_pivot(pvt, sz, idx, g, X, Y, Z)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -955,7 +1789,7 @@ real                                                   ::  GX, EY, TZ, YJA, YJAI
 real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
 real                                                   ::  C1, C2, C3, C7, C8, C9
 real                                                   ::  s1, s2, s3, s4, s5, s6, s7, ss
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  pvt
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  pvt
 real, dimension(-1:sz(1)+2)                            ::  X
 real, dimension(-1:sz(2)+2)                            ::  Y
 real, dimension(-1:sz(3)+2)                            ::  Z
@@ -0,0 +1,249 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+
+!> ********************************************************************
+!! @brief s-step法の基底ベクトル vn = a * A v + b * v
+!! @param [out]    vn   次の基底ベクトル
+!! @param [in]     v    基底ベクトル
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲（ガイドセルへの拡張を含む）
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in]     a    係数 1/sigma
+!! @param [in]     b    係数 -theta/sigma
+!! @param [in,out] flop 浮動小数点演算数
+!! @note Newton基底 (A - theta I) v / sigma，theta=0 で単項式基底
+!<
+subroutine ca_basis (vn, v, sz, idx, g, cf, a, b, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  vn, v
+double precision                                       ::  flop
+real, dimension(7)                                     ::  cf
+real                                                   ::  a, b, dd, ss, pp
+real                                                   ::  c1, c2, c3, c4, c5, c6
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 16.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, pp)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, pp)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, pp)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  pp = v(k,i,j)
+  ss = c1 * v(k  , i+1,j  ) &
+     + c2 * v(k  , i-1,j  ) &
+     + c3 * v(k  , i  ,j+1) &
+     + c4 * v(k  , i  ,j-1) &
+     + c5 * v(k+1, i  ,j  ) &
+     + c6 * v(k-1, i  ,j  )
+  vn(k,i,j) = a * (ss - dd * pp) + b * pp
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine ca_basis
+
+
+!> ********************************************************************
+!! @brief s-step法のGram行列 G = Y^T Y と g = Y^T rt
+!! @param [out]    gm   Gram行列の上三角（列順に詰める）
+!! @param [out]    gv   Y^T rt
+!! @param [in]     y    基底ベクトル群
+!! @param [in]     rt   シャドウ残差
+!! @param [in]     nb   基底ベクトル数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!! @note 全ての内積を1パスで求め，1回のAllreduceで集計する
+!<
+subroutine ca_gram (gm, gv, y, rt, nb, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                      ::  i, j, k, g, l, m, n, nb
+integer                                                      ::  ist, jst, kst
+integer                                                      ::  ied, jed, ked
+integer, dimension(3)                                        ::  sz
+integer, dimension(0:5)                                      ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g, 0:nb-1) ::  y
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  rt
+double precision, dimension(nb*(nb+1)/2)                     ::  gm
+double precision, dimension(0:nb-1)                          ::  gv
+double precision                                             ::  flop, r
+double precision, dimension(0:nb-1)                          ::  v
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+gm = 0.0d0
+gv = 0.0d0
+
+flop = flop + dble(nb*(nb+1) + 2*nb) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(v, r, n) reduction(+:gm, gv)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(v, r, n, l, m) REDUCTION(+:gm, gv)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(v, r, n, l, m) REDUCTION(+:gm, gv)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  r = dble(rt(k,i,j))
+  do l = 0, nb-1
+    v(l) = dble(y(k,i,j,l))
+    gv(l) = gv(l) + v(l) * r
+  end do
+  n = 0
+  do m = 0, nb-1
+  do l = 0, m
+    n = n + 1
+    gm(n) = gm(n) + v(l) * v(m)
+  end do
+  end do
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine ca_gram
+
+
+!> ********************************************************************
+!! @brief s-step法の外側反復の更新
+!! @param [in,out] x    解ベクトル x = x + Y cx
+!! @param [in,out] y    基底ベクトル群 y(ip) = Y cp, y(ir) = Y cr
+!! @param [in]     cx   解の係数
+!! @param [in]     cp   探索方向の係数
+!! @param [in]     cr   残差の係数
+!! @param [in]     nb   基底ベクトル数
+!! @param [in]     ip   探索方向を書き込む列
+!! @param [in]     ir   残差を書き込む列
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!! @note 格子点毎に閉じた線形結合なので，読んだ列へそのまま書き戻してよい
+!<
+subroutine ca_update (x, y, cx, cp, cr, nb, ip, ir, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                      ::  i, j, k, g, l, nb, ip, ir
+integer                                                      ::  ist, jst, kst
+integer                                                      ::  ied, jed, ked
+integer, dimension(3)                                        ::  sz
+integer, dimension(0:5)                                      ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g, 0:nb-1) ::  y
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+double precision, dimension(0:nb-1)                          ::  cx, cp, cr
+double precision                                             ::  flop, sx, sp, sr, v
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + dble(6*nb+1) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(sx, sp, sr, v)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(sx, sp, sr, v, l)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(sx, sp, sr, v, l)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  sx = 0.0d0
+  sp = 0.0d0
+  sr = 0.0d0
+  do l = 0, nb-1
+    v  = dble(y(k,i,j,l))
+    sx = sx + cx(l) * v
+    sp = sp + cp(l) * v
+    sr = sr + cr(l) * v
+  end do
+  x(k,i,j)  = x(k,i,j) + real(sx)
+  y(k,i,j,ip) = real(sp)
+  y(k,i,j,ir) = real(sr)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine ca_update
@@ -0,0 +1,275 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+
+!> ********************************************************************
+!! @brief Lanczos法の初期ベクトル（擬似乱数）
+!! @param [out]    x    ベクトル
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     hd   自ランクのHeadIndex
+!! @note グローバルインデクスのハッシュで値を決めるので，並列数によらず同じベクトルになる
+!!       内点以外は0のまま
+!<
+subroutine cheby_seed (x, sz, idx, g, hd)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz, hd
+integer, dimension(0:5)                                ::  idx
+integer(8)                                             ::  n
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(n)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(n)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  n = ieor( ieor( int(i+hd(1)-1, 8) * 73856093_8, &
+                  int(j+hd(2)-1, 8) * 19349663_8 ), &
+                  int(k+hd(3)-1, 8) * 83492791_8 )
+  x(k,i,j) = real( mod(abs(n), 10007_8) ) / 10007.0 - 0.5
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine cheby_seed
+
+
+!> ********************************************************************
+!! @brief Lanczos法の直交化とノルム
+!! @param [in,out] w    w = w - a * v - b * vp
+!! @param [in]     v    Lanczosベクトル
+!! @param [in]     vp   1つ前のLanczosベクトル
+!! @param [in]     a    係数 alpha
+!! @param [in]     b    係数 beta
+!! @param [out]    ww   内積 (w, w)
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine cheby_lanczos (w, v, vp, a, b, ww, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  w, v, vp
+double precision                                       ::  flop
+real                                                   ::  a, b, ww, s
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+ww = 0.0
+
+flop = flop + 6.0d0    &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(s) reduction(+:ww)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s) REDUCTION(+:ww)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  s = w(k,i,j) - a * v(k,i,j) - b * vp(k,i,j)
+  w(k,i,j) = s
+  ww = ww + s * s
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine cheby_lanczos
+
+
+!> ********************************************************************
+!! @brief スカラー倍 y = a * x
+!! @param [out]    y    ベクトル
+!! @param [in]     x    ベクトル
+!! @param [in]     a    係数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!<
+subroutine cheby_scal (y, x, a, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  y, x
+double precision                                       ::  flop
+real                                                   ::  a
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 1.0d0    &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2)
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  y(k,i,j) = a * x(k,i,j)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine cheby_scal
+
+
+!> ********************************************************************
+!! @brief Chebyshev反復の1ステップ
+!! @param [in,out] x    解ベクトル x = x + d
+!! @param [in,out] r    残差ベクトル r = r - A d
+!! @param [in]     d    修正量（ガイドセルは同期済み）
+!! @param [out]    dn   次の修正量 dn = c1 * d + c2 * r
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in]     cf   係数
+!! @param [in]     c1   係数 rho_1 * rho_0
+!! @param [in]     c2   係数 2 rho_1 / delta にJacobi前処理 D^{-1}を含めたもの
+!! @param [in,out] res  修正量の二乗和
+!! @param [in,out] flop 浮動小数点演算数
+!! @note 内積を含まないので，反復中の集団通信は不要
+!<
+subroutine cheby_iter (x, r, d, dn, sz, idx, g, cf, c1, c2, res, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer, dimension(3)                                  ::  sz
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, r, d, dn
+double precision                                       ::  flop, res
+real, dimension(7)                                     ::  cf
+real                                                   ::  c1, c2, dd, ss, dp, rn, res1
+real                                                   ::  a1, a2, a3, a4, a5, a6
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+a1 = cf(1)
+a2 = cf(2)
+a3 = cf(3)
+a4 = cf(4)
+a5 = cf(5)
+a6 = cf(6)
+dd = cf(7)
+
+res1 = 0.0
+
+flop = flop + 21.0d0   &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, dp, rn) reduction(+:res1)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ss, dp, rn) REDUCTION(+:res1)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ss, dp, rn) REDUCTION(+:res1)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  dp = d(k,i,j)
+  ss = a1 * d(k  , i+1,j  ) &
+     + a2 * d(k  , i-1,j  ) &
+     + a3 * d(k  , i  ,j+1) &
+     + a4 * d(k  , i  ,j-1) &
+     + a5 * d(k+1, i  ,j  ) &
+     + a6 * d(k-1, i  ,j  )
+  rn = r(k,i,j) - (ss - dd * dp)
+  r(k,i,j) = rn
+  x(k,i,j) = x(k,i,j) + dp
+  dn(k,i,j) = c1 * dp + c2 * rn
+  res1 = res1 + dp * dp
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine cheby_iter
@@ -0,0 +1,147 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+
+!> ********************************************************************
+!! @brief Gram-Schmidt法の内積 h(l) = (v_l, w), h(n) = (w, w)
+!! @param [out]    h    内積 (0:n)
+!! @param [in]     v    Krylov基底 (0:n-1)
+!! @param [in]     w    ベクトル
+!! @param [in]     n    基底ベクトル数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!! @note 全ての内積を1パスで求め，1回のAllreduceで集計する
+!<
+subroutine gmres_mdot (h, v, w, n, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                     ::  i, j, k, g, l, n
+integer                                                     ::  ist, jst, kst
+integer                                                     ::  ied, jed, ked
+integer, dimension(3)                                       ::  sz
+integer, dimension(0:5)                                     ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g, 0:*) ::  v
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  w
+double precision, dimension(0:n)                            ::  h
+double precision                                            ::  flop, s
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+h = 0.0d0
+
+flop = flop + dble(2*n+2) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(s) reduction(+:h)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(s, l) REDUCTION(+:h)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s, l) REDUCTION(+:h)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  s = dble(w(k,i,j))
+  do l = 0, n-1
+    h(l) = h(l) + dble(v(k,i,j,l)) * s
+  end do
+  h(n) = h(n) + s * s
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine gmres_mdot
+
+
+!> ********************************************************************
+!! @brief Gram-Schmidt法の射影 w = a * (w - sum h(l) v_l)
+!! @param [in,out] w    ベクトル
+!! @param [in]     v    基底 (0:n-1)
+!! @param [in]     h    係数 (0:n-1)
+!! @param [in]     a    スケール
+!! @param [in]     n    基底ベクトル数
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル
+!! @param [in,out] flop 浮動小数点演算数
+!! @note n=0 でスカラー倍，h=-y, a=1 で解の更新 x = x + Z y
+!<
+subroutine gmres_maxpy (w, v, h, a, n, sz, idx, g, flop)
+use cz_layout
+implicit none
+integer                                                     ::  i, j, k, g, l, n
+integer                                                     ::  ist, jst, kst
+integer                                                     ::  ied, jed, ked
+integer, dimension(3)                                       ::  sz
+integer, dimension(0:5)                                     ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g, 0:*) ::  v
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  w
+double precision, dimension(0:*)                            ::  h
+double precision                                            ::  flop, a, s
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + dble(2*n+1) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(s)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(s, l)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(s, l)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  s = dble(w(k,i,j))
+  do l = 0, n-1
+    s = s - h(l) * dble(v(k,i,j,l))
+  end do
+  w(k,i,j) = real(a * s)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine gmres_maxpy
@@ -0,0 +1,109 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+!> ********************************************************************
+!! @brief S3D配列の確保形状
+!! @note  S3D配列は p(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) で確保し，
+!!        カーネルの宣言も同じ上限を用いる．内点と袖の範囲は sz, g のまま変わらない
+!!        pad_mode = 0 : パディングなし
+!!                   1 : K方向の長さを64バイトの倍数に揃え，列やI-J面の間隔が4KBの倍数となる場合は
+!!                       1行(64バイト)または1列ずらしてキャッシュのセット競合を避ける
+!!                   2 : K, I方向にそれぞれ pad_k, pad_i 要素を足す
+!<
+module cz_layout
+implicit none
+integer, save  ::  pad_mode = 0
+integer, save  ::  pad_k    = 0
+integer, save  ::  pad_i    = 0
+
+integer, parameter  ::  PAD_ALIGN = 64    !< 揃えるバイト数
+integer, parameter  ::  PAD_SET   = 4096  !< キャッシュのセットが一巡するバイト数
+
+contains
+
+!> K方向の配列の上限
+pure integer function cz_ek (sz, g)
+integer, dimension(3), intent(in)  ::  sz
+integer, intent(in)                ::  g
+integer                            ::  nk, nb, na
+
+nk = sz(3) + 2*g
+
+if ( pad_mode == 1 ) then
+  nb = storage_size(0.0) / 8
+  na = PAD_ALIGN / nb
+  nk = ( (nk + na - 1) / na ) * na
+  if ( mod(nk, PAD_SET/nb) == 0 ) nk = nk + na
+else if ( pad_mode == 2 ) then
+  nk = nk + pad_k
+endif
+
+cz_ek = nk - g
+end function cz_ek
+
+!> I方向の配列の上限
+pure integer function cz_ei (sz, g)
+integer, dimension(3), intent(in)  ::  sz
+integer, intent(in)                ::  g
+integer                            ::  nk, ni, nb
+
+ni = sz(1) + 2*g
+
+if ( pad_mode == 1 ) then
+  nb = storage_size(0.0) / 8
+  nk = cz_ek(sz, g) + g
+  if ( mod(nk*ni, PAD_SET/nb) == 0 ) ni = ni + 1
+else if ( pad_mode == 2 ) then
+  ni = ni + pad_i
+endif
+
+cz_ei = ni - g
+end function cz_ei
+
+end module cz_layout
+
+
+!> ********************************************************************
+!! @brief S3D配列のパディングの指定
+!! @param [in] mode 0-なし, 1-自動, 2-指定
+!! @param [in] pk   K方向に足す要素数 (mode=2)
+!! @param [in] pi   I方向に足す要素数 (mode=2)
+!! @note 配列の確保前に1度だけ呼ぶ
+!<
+subroutine cz_layout_set (mode, pk, pi)
+use cz_layout
+implicit none
+integer  ::  mode, pk, pi
+
+pad_mode = mode
+pad_k    = max(pk, 0)
+pad_i    = max(pi, 0)
+
+return
+end subroutine cz_layout_set
+
+
+!> ********************************************************************
+!! @brief S3D配列の確保形状
+!! @param [in]  sz  配列長
+!! @param [in]  g   ガイドセル長
+!! @param [out] ext K, I, J方向の配列の長さ（ガイドセルとパディングを含む）
+!<
+subroutine cz_layout_ext (sz, g, ext)
+use cz_layout
+implicit none
+integer                  ::  g
+integer, dimension(3)    ::  sz, ext
+
+ext(1) = cz_ek(sz, g) + g
+ext(2) = cz_ei(sz, g) + g
+ext(3) = sz(2) + 2*g
+
+return
+end subroutine cz_layout_ext
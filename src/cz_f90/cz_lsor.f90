@@ -74,14 +74,15 @@ end subroutine matx3
 !! @param [in,out] flop flop count
 !<
 subroutine lsor_pcr_kij (sz, idx, g, pn, x, a, c, d, a1, c1, d1, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g, kl, kr, s, p, pn
 integer                                                ::  ist, ied, jst, jed, kst, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 double precision                                       ::  flop, res
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
 real                                                   ::  r, ap, cp, e, omg, pp, dp
 !dir$ assume_aligned x:64, msk:64, rhs:64, a:64, c:64, d:64, a1:64, c1:64, d1:64
 
@@ -229,14 +230,15 @@ end subroutine lsor_pcr_kij
 !! @note lsor_pcr_kij()からの変更 最終段を直接反転
 !<
 subroutine lsor_pcr_kij2 (sz, idx, g, pn, x, a, c, d, a1, c1, d1, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g, kl, kr, s, p, pn
 integer                                                ::  ist, ied, jst, jed, kst, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 double precision                                       ::  flop, res
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
 real                                                   ::  r, ap, cp, e, omg, pp, dp
 double precision, dimension(3)                         ::  aa, cc, dd
 !dir$ assume_aligned x:64, msk:64, rhs:64, a:64, c:64, d:64, a1:64, c1:64, d1:64
@@ -436,14 +438,15 @@ end subroutine lsor_pcr_kij2
 !! @note lsor_pcr_kij2()からの変更 分割
 !<
 subroutine lsor_pcr_kij3 (sz, idx, g, pn, x, a, c, d, a1, c1, d1, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g, kl, kr, s, p, pn, t
 integer                                                ::  ist, ied, jst, jed, kst, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 double precision                                       ::  flop, res
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
 real                                                   ::  r, ap, cp, e, omg, pp, dp
 double precision, dimension(3)                         ::  aa, cc, dd
 !dir$ assume_aligned x:64, msk:64, rhs:64, a:64, c:64, d:64, a1:64, c1:64, d1:64
@@ -654,14 +657,15 @@ end subroutine lsor_pcr_kij3
 !! @note lsor_pcr_kij4()からの変更 matx2, matx3を手動展開
 !<
 subroutine lsor_pcr_kij4 (sz, idx, g, pn, x, a, c, d, a1, c1, d1, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g, kl, kr, s, p, pn
 integer                                                ::  ist, ied, jst, jed, kst, ked
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 double precision                                       ::  flop, res
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  a, c, d, a1, c1, d1
 real                                                   ::  r, ap, cp, e, omg, pp, dp
 double precision                                       ::  jj, dd1, dd2, dd3, aa2, aa3, cc1, cc2, f1, f2, f3
 !dir$ assume_aligned x:64, msk:64, rhs:64, a:64, c:64, d:64, a1:64, c1:64, d1:64
@@ -870,12 +874,13 @@ end subroutine lsor_pcr_kij4
 
 !********************************************************************************
 subroutine lsor_pcr_kij5 (sz, idx, g, pn, x, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 ! arguments
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
@@ -1061,12 +1066,13 @@ end subroutine lsor_pcr_kij5
 
 !********************************************************************************
 subroutine lsor_pcr_kij6 (sz, idx, g, pn, x, msk, rhs, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
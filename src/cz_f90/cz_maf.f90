@@ -21,6 +21,7 @@
 !! @param [in,out] flop flop count
 !<
 subroutine psor_maf (p, sz, idx, g, X, Y, Z, omg, b, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -33,7 +34,7 @@ real                                                   ::  omg, dd, dp, pp, bb,
 real                                                   ::  GX, EY, TZ, YJA, YJAI
 real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
 real                                                   ::  C1, C2, C3, C7, C8, C9, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
 real, dimension(-1:sz(1)+2)                            ::  X
 real, dimension(-1:sz(2)+2)                            ::  Y
 real, dimension(-1:sz(3)+2)                            ::  Z
@@ -129,6 +130,7 @@ end subroutine psor_maf
 !! @param [in,out] flop flop count
 !<
 subroutine jacobi_maf (p, sz, idx, g, X, Y, Z, omg, b, res, wk2, tmp, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -141,7 +143,7 @@ real                                                   ::  omg, dd, dp, pp, bb,
 real                                                   ::  GX, EY, TZ, YJA, YJAI
 real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
 real                                                   ::  C1, C2, C3, C7, C8, C9, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b, wk2
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b, wk2
 real, dimension(-1:sz(1)+2)                            ::  X
 real, dimension(-1:sz(2)+2)                            ::  Y
 real, dimension(-1:sz(3)+2)                            ::  Z, tmp
@@ -299,6 +301,7 @@ end subroutine jacobi_maf
 !! @note resは積算
 !<
 subroutine psor2sma_core_maf (p, sz, idx, g, X, Y, Z, ofst, color, omg, b, res, tmp, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -311,7 +314,7 @@ real                                                   ::  omg, dd, dp, pp, bb,
 real                                                   ::  GX, EY, TZ, YJA, YJAI
 real                                                   ::  XG, YE, ZT, XGG, YEE, ZTT
 real                                                   ::  C1, C2, C3, C7, C8, C9, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
 integer                                                ::  kp, color, ofst
 real, dimension(-1:sz(1)+2)                            ::  X
 real, dimension(-1:sz(2)+2)                            ::  Y
@@ -438,19 +441,420 @@ return
 end subroutine psor2sma_core_maf
 
 
+!> ********************************************************************
+!! @brief MAFの計量係数を軸毎に計算
+!! @param [in]  sz   配列長
+!! @param [in]  X,Y,Z  座標
+!! @param [out] MX,MY,MZ 計量係数 (1)-負側の係数, (2)-正側の係数, (3)-対角項
+!! @note 格子はテンソル積なので，C1, C7 は i のみ，C2, C8 は j のみ，C3, C9 は k のみに依存する
+!!       _mtr カーネルはこの係数を読むので，格子点毎の計量の再計算（66 flops）が不要になる
+!<
+subroutine maf_metric (sz, X, Y, Z, MX, MY, MZ)
+implicit none
+integer                                                ::  i, j, k
+integer, dimension(3)                                  ::  sz
+real, dimension(-1:sz(1)+2)                            ::  X
+real, dimension(-1:sz(2)+2)                            ::  Y
+real, dimension(-1:sz(3)+2)                            ::  Z
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+
+MX = 0.0
+MY = 0.0
+MZ = 0.0
+
+do i = 1, sz(1)
+  call maf_metric_1d(X(i-1), X(i), X(i+1), MX(1,i))
+end do
+
+do j = 1, sz(2)
+  call maf_metric_1d(Y(j-1), Y(j), Y(j+1), MY(1,j))
+end do
+
+do k = 1, sz(3)
+  call maf_metric_1d(Z(k-1), Z(k), Z(k+1), MZ(1,k))
+end do
+
+return
+end subroutine maf_metric
+
+
+!> ********************************************************************
+!! @brief 1方向の計量係数
+!! @param [in]  xm, x0, xp  座標
+!! @param [out] m    計量係数 (1)-負側の係数, (2)-正側の係数, (3)-対角項
+!! @note psor_maf の C1 = GX*GX, C7 = -XGG*C1*GX で GX = 1/XG，倍精度で計算する
+!<
+subroutine maf_metric_1d (xm, x0, xp, m)
+implicit none
+real                                                   ::  xm, x0, xp
+real, dimension(3)                                     ::  m
+double precision                                       ::  xg, xgg, gx, c1, c7
+
+xg  = 0.5d0 * (dble(xp) - dble(xm))
+xgg = dble(xp) - 2.0d0*dble(x0) + dble(xm)
+gx  = 1.0d0 / xg
+c1  = gx * gx
+c7  = -xgg * c1 * gx
+
+m(1) = real(c1 - 0.5d0 * c7)
+m(2) = real(c1 + 0.5d0 * c7)
+m(3) = real(2.0d0 * c1)
+
+return
+end subroutine maf_metric_1d
+
+
+!> ********************************************************************
+!! @brief point SOR法（計量係数の配列版）
+!! @param [in,out] p    圧力
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     MX,MY,MZ  計量係数
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [out]    res  residual
+!! @param [in,out] flop flop count
+!<
+subroutine psor_mtr (p, sz, idx, g, MX, MY, MZ, omg, b, res, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  res
+double precision                                       ::  flop
+real                                                   ::  omg, dd, dp, pp, bb, pn, rp, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+
+res1 = 0.0
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 20.0d0      &
+* dble(ied-ist+1) &
+* dble(jed-jst+1) &
+* dble(ked-kst+1)
+
+
+!$OMP PARALLEL DO Collapse(2) &
+!$OMP REDUCTION(+:res1) &
+!$OMP PRIVATE(rp, pp, bb, dd, dp, pn)
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+bb = b(k,i,j)
+pp = p(k,i,j)
+dd = MX(3,i) + MY(3,j) + MZ(3,k)
+rp = MX(2,i) * P(k  , i+1, j  ) &
+   + MX(1,i) * P(k  , i-1, j  ) &
+   + MY(2,j) * P(k  , i  , j+1) &
+   + MY(1,j) * P(k  , i  , j-1) &
+   + MZ(2,k) * P(k+1, i  , j  ) &
+   + MZ(1,k) * P(k-1, i  , j  ) &
+   + bb
+dp = ( rp / dd - pp ) * omg
+pn = pp + dp
+P(k,i,j) = pn
+res1 = res1 + dp * dp ! 20
+enddo
+enddo
+enddo
+!$OMP END PARALLEL DO
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor_mtr
+
+
+!> **********************************************************************
+!! @brief 緩和Jacobi法（計量係数の配列版）
+!! @param [in,out] p    圧力
+!! @param [in]     sz   配列長
+!! @param [in]     idx         インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     MX,MY,MZ  計量係数
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [in,out] res  residual
+!! @param [out]    wk2  ワーク用配列
+!! @param [in]     tmp  ワーク
+!! @param [in,out] flop flop count
+!<
+subroutine jacobi_mtr (p, sz, idx, g, MX, MY, MZ, omg, b, res, wk2, tmp, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  res
+double precision                                       ::  flop
+real                                                   ::  omg, dd, dp, pp, bb, pn, rp, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b, wk2
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+real, dimension(-1:sz(3)+2)                            ::  tmp
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+res1 = 0.0
+
+#ifdef _SVR
+tmp = 0.0
+#endif
+
+flop = flop + 20.0d0  &
+* dble(ied-ist+1) &
+* dble(jed-jst+1) &
+* dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(3) reduction(+:res1)
+#else
+!$OMP PARALLEL &
+#ifdef _SVR
+!$OMP REDUCTION(+:tmp) &
+#else
+!$OMP REDUCTION(+:res1) &
+#endif
+!$OMP PRIVATE(rp, pp, bb, dd, dp, pn)
+#ifdef __NEC__
+!$OMP DO SCHEDULE(static)
+#else
+!$OMP DO SCHEDULE(static) COLLAPSE(2)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+bb = b(k,i,j)
+pp = p(k,i,j)
+dd = MX(3,i) + MY(3,j) + MZ(3,k)
+rp = MX(2,i) * P(k  , i+1, j  ) &
+   + MX(1,i) * P(k  , i-1, j  ) &
+   + MY(2,j) * P(k  , i  , j+1) &
+   + MY(1,j) * P(k  , i  , j-1) &
+   + MZ(2,k) * P(k+1, i  , j  ) &
+   + MZ(1,k) * P(k-1, i  , j  ) &
+   + bb
+dp = ( rp / dd - pp ) * omg
+pn = pp + dp
+wk2(k,i,j) = pn
+
+#ifdef _SVR
+tmp(k) = tmp(k) + dp * dp ! 20
+#else
+res1 = res1 + dp * dp ! 20
+#endif
+
+enddo
+enddo
+enddo
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(3)
+#else
+#ifdef __NEC__
+!$OMP DO SCHEDULE(static)
+#else
+!$OMP DO SCHEDULE(static) COLLAPSE(2)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+p(k,i,j)=wk2(k,i,j)
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+
+#ifdef _SVR
+do k = kst, ked
+  res1 = res1 + tmp(k)
+end do
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine jacobi_mtr
+
+
+!> ********************************************************************
+!! @brief 2-colored SOR法 stride memory access（計量係数の配列版）
+!! @param [in,out] p     圧力
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     MX,MY,MZ  計量係数
+!! @param [in]     ofst  開始点オフセット
+!! @param [in]     color グループ番号
+!! @param [in]     omg   加速係数
+!! @param [in]     b     RHS vector
+!! @param [out]    res  residual
+!! @param [in]     tmp  ワーク
+!! @param [in,out] flop  浮動小数演算数
+!! @note resは積算
+!<
+subroutine psor2sma_core_mtr (p, sz, idx, g, MX, MY, MZ, ofst, color, omg, b, res, tmp, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  flop
+double precision                                       ::  res
+real                                                   ::  omg, dd, dp, pp, bb, pn, rp, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+integer                                                ::  kp, color, ofst
+real, dimension(3, -1:sz(1)+2)                         ::  MX
+real, dimension(3, -1:sz(2)+2)                         ::  MY
+real, dimension(3, -1:sz(3)+2)                         ::  MZ
+real, dimension(-1:sz(3)+2)                            ::  tmp
+
+kp = ofst+color
+res1 = 0.0
+
+#ifdef _SVR
+tmp = 0.0
+#endif
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + 20.0d0*0.5d0  &
+* dble(ied-ist+1) &
+* dble(jed-jst+1) &
+* dble(ked-kst+1)
+
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang reduction(+:res1)
+do j=jst,jed
+!$acc loop independent gang reduction(+:res1)
+do i=ist,ied
+!$acc loop independent vector(128) reduction(+:res1)
+do k=kst+mod(i+j+kp,2), ked, 2
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) &
+#ifdef _SVR
+!$OMP REDUCTION(+:tmp) &
+#else
+!$OMP REDUCTION(+:res1) &
+#endif
+!$OMP PRIVATE(rp, pp, bb, dd, dp, pn)
+do j=jst,jed
+!pgi$ novector
+do i=ist,ied
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+!pgi$ vector
+do k=kst+mod(i+j+kp,2), ked, 2
+#endif
+
+pp = p(k,i,j)
+bb = b(k,i,j)
+dd = MX(3,i) + MY(3,j) + MZ(3,k)
+rp = MX(2,i) * P(k  , i+1, j  ) &
+   + MX(1,i) * P(k  , i-1, j  ) &
+   + MY(2,j) * P(k  , i  , j+1) &
+   + MY(1,j) * P(k  , i  , j-1) &
+   + MZ(2,k) * P(k+1, i  , j  ) &
+   + MZ(1,k) * P(k-1, i  , j  ) &
+   + bb
+
+dp = ( rp / dd - pp ) * omg
+pn = pp + dp
+P(k,i,j) = pn
+
+#ifdef _SVR
+tmp(k) = tmp(k) + dp * dp ! 20
+#else
+res1 = res1 + dp * dp ! 20
+#endif
+
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#endif
+!$OMP END PARALLEL DO
+
+#ifdef _SVR
+do k = kst, ked
+res1 = res1 + tmp(k)
+end do
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor2sma_core_mtr
+
+
 !********************************************************************************
-subroutine pcr_rb_maf (sz, idx, g, pn, ofst, color, x, msk, rhs, XX, YY, ZZ, &
+subroutine pcr_rb_maf (sz, idx, g, pn, nl, lst, x, msk, rhs, XX, YY, ZZ, &
                        a, c, d, aw, cw, dw, omg, res, tmp, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+integer                                                ::  g, pn, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
-integer                                  ::  i, j, k, kl, kr, s, p, color, ip, ofst
+integer                                  ::  i, j, k, l, kl, kr, s, p
 integer                                  ::  ist, ied, jst, jed, kst, ked
 real, dimension(-1:sz(3)+2)              ::  a, c, d, aw, cw, dw
 real                                     ::  ap, cp, e, pp, dp, res1
@@ -469,7 +873,7 @@ ked = idx(5)
 
 
 flop = flop + dble(           &
-  (jed-jst+1)*(ied-ist+1)* (  &
+  nl * (  &
     ( 24.0d0                  & ! metrics
      + 3.0 * 2.0 + 12.0       & ! coef BC
     )                         &
@@ -479,10 +883,9 @@ flop = flop + dble(           &
    + 2**(pn-1) * 11.0           & ! 2x2
    + (ked-kst+1)*6.0          & ! Relaxation
    )                          &
- ) * 0.5
+ )
 
 
-ip = ofst + color
 res1 = 0.0
 
 #ifdef _SVR
@@ -492,7 +895,8 @@ tmp = 0.0
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(2) gang reduction(+:res1) &
+!$acc loop independent gang reduction(+:res1) &
+!$acc& private(i, j) &
 !$acc& private(a, c, d, aw, cw, dw) &
 !$acc& private(kl, kr, ap, cp, e, s, p, k, pp, dp) &
 !$acc& private(jj, dd1, dd2, aa2, aa3, cc1, cc2, f1, f2, f3) &
@@ -504,17 +908,16 @@ tmp = 0.0
 #else
 !$OMP REDUCTION(+:res1) &
 #endif
+!$OMP private(i, j) &
 !$OMP private(kl, kr, ap, cp, e, s, p, k, pp, dp) &
 !$OMP private(jj, dd1, dd2, aa2, aa3, cc1, cc2, f1, f2, f3) &
 !$OMP private(a, c, d, aw, cw, dw) &
 !$OMP private(C1, C2, C7, C8, GX, EY, TZ, ZTT)
-!$OMP DO SCHEDULE(static) collapse(2)
+!$OMP DO SCHEDULE(static)
 #endif
-do j=jst, jed
-do i=ist, ied
-if(mod(i+j,2) /= color) cycle
-
-! do i=ist+mod(j+ip,2), ied, 2
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
 
 GX =  2.0 / (XX(i+1) - XX(i-1))
 EY =  2.0 / (YY(j+1) - YY(j-1))
@@ -647,7 +1050,6 @@ res1 = res1 + dp * dp ! 30
 
 end do  !  >> 6 flops
 
-end do
 end do
 #ifdef _OPENACC
 !$acc end kernels
@@ -671,12 +1073,13 @@ end subroutine pcr_rb_maf
 !********************************************************************************
 subroutine pcr_maf (sz, idx, g, pn, x, msk, rhs, XX, YY, ZZ, &
                     a, c, d, aw, cw, dw, omg, res, tmp, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
@@ -895,12 +1298,13 @@ end subroutine pcr_maf
 !********************************************************************************
 subroutine pcr_eda_maf (sz, idx, g, pn, x, msk, rhs, XX, YY, ZZ, &
 aw, cw, dw, omg, res, tmp, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
@@ -1116,12 +1520,13 @@ end subroutine pcr_eda_maf
 !********************************************************************************
 subroutine pcr_esa_maf (sz, idx, g, pn, s, x, msk, rhs, XX, YY, ZZ, &
 a, c, d, aw, cw, dw, omg, res, tmp, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
@@ -1278,7 +1683,7 @@ sq = 2**(pn-1)
 !NEC$ IVDEP
 !pgi$ ivdep
 !$acc loop independent
-do k = kst, kst+sq-1
+do k = kst, ked-sq
 cc1 = c(k)
 aa2 = a(k+sq)
 f1  = d(k)
@@ -1290,6 +1695,13 @@ dw(k   ) = dd1
 dw(k+sq) = dd2
 end do  ! >>  9 flops
 
+! 対になる点が ked を超える場合は c(k)=0 なので1元
+!dir$ vector aligned
+!dir$ simd
+do k = ked-sq+1, kst+sq-1
+dw(k) = d(k)
+end do
+
 
 ! a_{i-1} x_{i-2} + x_{i-1} + c_{i-1} x_i     = d_{i-1}
 ! a_{i}   x_{i-1} + x_{i}   + c_{i}   x_{i+1} = d_{i}
@@ -1336,18 +1748,20 @@ end subroutine pcr_esa_maf
 
 
 !********************************************************************************
-subroutine pcr_rb_esa_maf (sz, idx, g, pn, ofst, color, s, x, msk, rhs, XX, YY, ZZ, &
+subroutine pcr_rb_esa_maf (sz, idx, g, pn, nl, lst, s, x, msk, rhs, XX, YY, ZZ, &
 a, c, d, aw, cw, dw, omg, res, tmp, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+integer                                                ::  g, pn, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
-integer                                  ::  i, j, k, p, color, ip, ofst, sq, s
+integer                                  ::  i, j, k, l, p, sq, s
 integer                                  ::  ist, ied, jst, jed, kst, ked
 real, dimension(-1:sz(3)+2)              ::  aw, cw, dw
 real, dimension(idx(4)-s:idx(5)+s)       ::  a, c, d
@@ -1366,7 +1780,7 @@ kst = idx(4)
 ked = idx(5)
 
 flop = flop + dble(           &
-(jed-jst+1)*(ied-ist+1)* (  &
+nl * (  &
 ( 24.0d0                  & ! metrics
  + 3.0 * 2.0 + 12.0       & ! coef BC
 )                         &
@@ -1376,10 +1790,9 @@ flop = flop + dble(           &
 + 2**(pn-1) * 11.0           & ! 2x2
 + (ked-kst+1)*6.0          & ! Relaxation
 )                          &
-) * 0.5
+)
 
 
-ip = ofst + color
 res1 = 0.0
 
 #ifdef _SVR
@@ -1388,7 +1801,8 @@ tmp = 0.0
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(2) reduction(+:res1) &
+!$acc loop independent reduction(+:res1) &
+!$acc& private(i, j) &
 !$acc& private(a, c, d, aw, cw, dw) &
 !$acc& private(ap, cp, e, sq, p, k, pp, dp) &
 !$acc& private(jj, dd1, dd2, aa2, aa3, cc1, cc2, f1, f2, f3) &
@@ -1400,18 +1814,17 @@ tmp = 0.0
 #else
 !$OMP REDUCTION(+:res1) &
 #endif
+!$OMP private(i, j) &
 !$OMP private(ap, cp, e, sq, p, k, pp, dp) &
 !$OMP private(jj, dd1, dd2, aa2, aa3, cc1, cc2, f1, f2, f3) &
 !$OMP private(aw, cw, dw) &
 !$OMP firstprivate(a, c, d) &
 !$OMP private(C1, C2, C7, C8, GX, EY, TZ, ZTT)
-!$OMP DO SCHEDULE(static) collapse(2)
+!$OMP DO SCHEDULE(static)
 #endif
-do j=jst, jed
-do i=ist, ied
-if(mod(i+j,2) /= color) cycle
-
-!do i=ist+mod(j+ip,2), ied, 2
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
 
 GX =  2.0 / (XX(i+1) - XX(i-1))
 EY =  2.0 / (YY(j+1) - YY(j-1))
@@ -1504,7 +1917,7 @@ sq = 2**(pn-1)
 !dir$ simd
 !NEC$ IVDEP
 !$acc loop independent
-do k = kst, kst+sq-1
+do k = kst, ked-sq
 cc1 = c(k)
 aa2 = a(k+sq)
 f1  = d(k)
@@ -1516,6 +1929,13 @@ dw(k   ) = dd1
 dw(k+sq) = dd2
 end do  ! >>  11 flops
 
+! 対になる点が ked を超える場合は c(k)=0 なので1元
+!dir$ vector aligned
+!dir$ simd
+do k = ked-sq+1, kst+sq-1
+dw(k) = d(k)
+end do
+
 
 ! a_{i-1} x_{i-2} + x_{i-1} + c_{i-1} x_i     = d_{i-1}
 ! a_{i}   x_{i-1} + x_{i}   + c_{i}   x_{i+1} = d_{i}
@@ -1539,7 +1959,6 @@ res1 = res1 + dp * dp ! 30
 
 end do  !  >> 6 flops
 
-end do
 end do
 #ifdef _OPENACC
 !$acc end kernels
@@ -0,0 +1,330 @@
+!###################################################################################
+!#
+!# CubeZ
+!#
+!# Copyright (C) 2018-2020 Research Institute for Information Technology(RIIT), Kyushu University.
+!# All rights reserved.
+!#
+!###################################################################################
+
+
+!> ********************************************************************
+!! @brief 残差の計算と制限（細格子 -> 粗格子）
+!! @param [in]     szf  細格子の配列長
+!! @param [in]     idxf 細格子のインデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     cf   係数
+!! @param [in]     x    細格子の解ベクトル
+!! @param [in]     b    細格子のRHS vector
+!! @param [in]     szc  粗格子の配列長
+!! @param [in]     idxc 粗格子のインデクス範囲
+!! @param [out]    bc   粗格子のRHS vector
+!! @param [in,out] flop flop count
+!! @note 粗格子セル(kc,ic,jc)は細格子の2x2x2セル 2kc-2, 2kc-1 を束ねる
+!!       係数は格子幅によらず共通なので，格子幅2倍の (2h)^2/h^2 = 4 を掛けた
+!!       8セルの平均，すなわち和の1/2を粗格子の右辺とする
+!!       残差配列を持たず，残差を計算しながら束ねる
+!<
+subroutine mg_restrict (szf, idxf, g, cf, x, b, szc, idxc, bc, flop)
+use cz_layout
+implicit none
+integer                                                   ::  i, j, k, g, ic, jc, kc, ii, jj, kk
+integer                                                   ::  ist, jst, kst
+integer                                                   ::  ied, jed, ked
+integer, dimension(3)                                     ::  szf, szc
+integer, dimension(0:5)                                   ::  idxf, idxc
+double precision                                          ::  flop
+real                                                      ::  dd, ss, rr
+real                                                      ::  c1, c2, c3, c4, c5, c6
+real, dimension(1-g:cz_ek(szf,g), 1-g:cz_ei(szf,g), 1-g:szf(2)+g) ::  x, b
+real, dimension(1-g:cz_ek(szc,g), 1-g:cz_ei(szc,g), 1-g:szc(2)+g) ::  bc
+real, dimension(7)                                        ::  cf
+
+ist = idxc(0)
+ied = idxc(1)
+jst = idxc(2)
+jed = idxc(3)
+kst = idxc(4)
+ked = idxc(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + (8.0d0*14.0d0 + 8.0d0) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ss, rr)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(i, j, k, ii, jj, kk, ss, rr)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(i, j, k, ii, jj, kk, ss, rr)
+#endif
+#endif
+do jc = jst, jed
+do ic = ist, ied
+do kc = kst, ked
+  rr = 0.0
+  do jj = 0, 1
+  do ii = 0, 1
+  do kk = 0, 1
+    j = 2*jc - 2 + jj
+    i = 2*ic - 2 + ii
+    k = 2*kc - 2 + kk
+    ss = c1 * x(k  , i+1,j  ) &
+       + c2 * x(k  , i-1,j  ) &
+       + c3 * x(k  , i  ,j+1) &
+       + c4 * x(k  , i  ,j-1) &
+       + c5 * x(k+1, i  ,j  ) &
+       + c6 * x(k-1, i  ,j  )
+    rr = rr + (b(k,i,j) - (ss - dd * x(k,i,j)))
+  end do
+  end do
+  end do
+  bc(kc,ic,jc) = 0.5 * rr
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine mg_restrict
+
+
+!> ********************************************************************
+!! @brief 補正量の補間と加算（粗格子 -> 細格子）
+!! @param [in]     szc  粗格子の配列長
+!! @param [in]     idxc 粗格子のインデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     xc   粗格子の補正量
+!! @param [in]     szf  細格子の配列長
+!! @param [in]     idxf 細格子のインデクス範囲
+!! @param [in,out] x    細格子の解ベクトル
+!! @param [in,out] flop flop count
+!! @note 親セルと子の側の面隣接3セルによる線形補間，重みは各1/4
+!!       三重線形補間と同じ2次精度で，稜・頂点のガイドセルを参照しない
+!!       細格子の偶数インデクスは親セルの負側，奇数インデクスは正側の子
+!!       粗格子の面のガイドセルは同期済みであること
+!<
+subroutine mg_prolong (szc, idxc, g, xc, szf, idxf, x, flop)
+use cz_layout
+implicit none
+integer                                                   ::  i, j, k, g, ic, jc, kc, ip, jp, kp
+integer                                                   ::  ist, jst, kst
+integer                                                   ::  ied, jed, ked
+integer, dimension(3)                                     ::  szf, szc
+integer, dimension(0:5)                                   ::  idxf, idxc
+double precision                                          ::  flop
+real                                                      ::  w
+real, dimension(1-g:cz_ek(szc,g), 1-g:cz_ei(szc,g), 1-g:szc(2)+g) ::  xc
+real, dimension(1-g:cz_ek(szf,g), 1-g:cz_ei(szf,g), 1-g:szf(2)+g) ::  x
+
+ist = idxf(0)
+ied = idxf(1)
+jst = idxf(2)
+jed = idxf(3)
+kst = idxf(4)
+ked = idxf(5)
+
+w = 0.25
+
+flop = flop + 5.0d0    &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent collapse(3) private(ic, jc, kc, ip, jp, kp)
+#else
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(ic, jc, kc, ip, jp, kp)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(ic, jc, kc, ip, jp, kp)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  jc = (j+2)/2
+  ic = (i+2)/2
+  kc = (k+2)/2
+  jp = jc + 2*mod(j,2) - 1
+  ip = ic + 2*mod(i,2) - 1
+  kp = kc + 2*mod(k,2) - 1
+
+  x(k,i,j) = x(k,i,j) + w * ( xc(kc,ic,jc) &
+                            + xc(kp,ic,jc) &
+                            + xc(kc,ip,jc) &
+                            + xc(kc,ic,jp) )
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END PARALLEL DO
+#endif
+
+return
+end subroutine mg_prolong
+
+
+!> ********************************************************************
+!! @brief 粗格子の物理境界のガイドセル（同次Dirichlet）
+!! @param [in,out] x    粗格子の補正量
+!! @param [in]     sz   配列長
+!! @param [in]     g    ガイドセル長
+!! @param [in]     nID  隣接ランク番号
+!! @param [in]     s    外挿係数
+!! @note 細格子の境界は節点上にあり，粗格子の最外セル中心から境界までの距離は
+!!       d*H (1/2 < d < 1) となる．補正量が境界で0となるよう線形外挿し，
+!!       ガイドセルに -s*x (s = (1-d)/d) を与える
+!<
+subroutine mg_bc (x, sz, g, nID, s)
+use cz_layout
+implicit none
+include 'cz_fparam.fi'
+integer                                                :: i, j, k, ix, jx, kx, g
+integer, dimension(3)                                  :: sz
+integer, dimension(0:5)                                :: nID
+real                                                   :: s
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) :: x
+
+ix = sz(1)
+jx = sz(2)
+kx = sz(3)
+
+!$OMP PARALLEL
+
+if( nID(K_MINUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do j=1,jx
+do i=1,ix
+x(1,i,j) = -s * x(2,i,j)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+if( nID(K_PLUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do j=1,jx
+do i=1,ix
+x(kx,i,j) = -s * x(kx-1,i,j)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+!$OMP BARRIER
+
+if( nID(I_MINUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do j=1,jx
+do k=1,kx
+x(k,1,j) = -s * x(k,2,j)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+if( nID(I_PLUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do j=1,jx
+do k=1,kx
+x(k,ix,j) = -s * x(k,ix-1,j)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+!$OMP BARRIER
+
+if( nID(J_MINUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do i=1,ix
+do k=1,kx
+x(k,i,1) = -s * x(k,i,2)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+if( nID(J_PLUS) < 0 ) then
+#ifdef _OPENACC
+!$acc kernels
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+do i=1,ix
+do k=1,kx
+x(k,i,jx) = -s * x(k,i,jx-1)
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO NOWAIT
+#endif
+endif
+
+!$OMP END PARALLEL
+
+return
+end subroutine mg_bc
@@ -20,13 +20,14 @@
 !!       側面の境界条件はディリクレ。pBiCGSTABの係数がディリクレを想定している実装のため。
 !<
 subroutine bc_k (sz, g, p, dh, org, nID)
+use cz_layout
 implicit none
 include 'cz_fparam.fi'
 integer                                                :: i, j, k, ix, jx, kx, g
 integer, dimension(3)                                  :: sz
 integer, dimension(0:5)                                :: nID
 real, dimension(3)                                     :: org
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) :: p
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) :: p
 real                                                   :: pi, x, y, dh
 
 ix = sz(1)
@@ -205,6 +206,7 @@ end subroutine bc_k
 !! @param [in,out] flop flop count
 !<
 subroutine psor (p, sz, idx, g, cf, omg, b, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -215,7 +217,7 @@ double precision                                       ::  res
 double precision                                       ::  flop
 real                                                   ::  omg, dd, ss, dp, pp, bb, pn
 real                                                   ::  c1, c2, c3, c4, c5, c6, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
 real, dimension(7)                                     ::  cf
 
 res1 = 0.0
@@ -269,6 +271,85 @@ return
 end subroutine psor
 
 
+!> ********************************************************************
+!! @brief point SOR法 逆順の掃引
+!! @param [in,out] p    圧力
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     cf   係数
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [out]    res  residual
+!! @param [in,out] flop flop count
+!! @note psor と組み合わせて対称SOR (SSOR) とする
+!<
+subroutine psor_bwd (p, sz, idx, g, cf, omg, b, res, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  res
+double precision                                       ::  flop
+real                                                   ::  omg, dd, ss, dp, pp, bb, pn
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+real, dimension(7)                                     ::  cf
+
+res1 = 0.0
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 18.0     &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) &
+!$OMP REDUCTION(+:res1) &
+!$OMP PRIVATE(pp, bb, ss, dp, pn)
+do j = jed, jst, -1
+do i = ied, ist, -1
+do k = ked, kst, -1
+  pp = p(k,i,j)
+  bb = b(k,i,j)
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  dp = ( (ss - bb)/dd - pp ) * omg
+  pn = pp + dp
+  p(k,i,j) = pn
+  res1 = res1 + dp*dp
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor_bwd
+
+
 !> **********************************************************************
 !! @brief 緩和Jacobi法
 !! @param [in,out] p    圧力
@@ -282,6 +363,7 @@ end subroutine psor
 !! @param [in,out] flop flop count
 !<
 subroutine jacobi (p, sz, idx, g, cf, omg, b, res, wk2, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -292,7 +374,7 @@ double precision                                       ::  res
 double precision                                       ::  flop
 real                                                   ::  omg, dd, ss, dp, pp, bb, pn
 real                                                   ::  c1, c2, c3, c4, c5, c6, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b, wk2
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b, wk2
 real, dimension(7)                                     ::  cf
 
 ist = idx(0)
@@ -387,6 +469,101 @@ return
 end subroutine jacobi
 
 
+!> **********************************************************************
+!! @brief 緩和Jacobi法 部分領域の更新値をwk2に書き込む
+!! @param [in]     p    圧力
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲（部分領域）
+!! @param [in]     g    ガイドセル長
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [in,out] res  residual
+!! @param [out]    wk2  ワーク用配列
+!! @param [in,out] flop flop count
+!! @note 通信と計算のオーバーラップ用，pへの書き戻しは全領域の計算後にblas_copy_idx()で行う
+!<
+subroutine jacobi_sub (p, sz, idx, g, cf, omg, b, res, wk2, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  res
+double precision                                       ::  flop
+real                                                   ::  omg, dd, ss, dp, pp, bb, pn
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b, wk2
+real, dimension(7)                                     ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+res1 = 0.0
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+flop = flop + 18.0  &
+            * dble(max(ied-ist+1, 0)) &
+            * dble(max(jed-jst+1, 0)) &
+            * dble(max(ked-kst+1, 0))
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(3) reduction(+:res1)
+#else
+!$OMP PARALLEL PRIVATE(pp, bb, ss, dp, pn) &
+!$OMP REDUCTION(+:res1)
+! auroraはここにcollapseを入れると完全に並列化しない
+#ifdef __NEC__
+!$OMP DO SCHEDULE(static)
+#else
+!$OMP DO SCHEDULE(static) COLLAPSE(2)
+#endif
+#endif
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  pp = p(k,i,j)
+  bb = b(k,i,j)
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  dp = ( (ss - bb)/dd - pp ) * omg
+  pn = pp + dp
+  wk2(k,i,j) = pn
+  res1 = res1 + dp*dp
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine jacobi_sub
+
+
 !> ********************************************************************
 !! @brief 2-colored SOR法 stride memory access
 !! @param [in,out] p     圧力
@@ -402,6 +579,7 @@ end subroutine jacobi
 !! @note resは積算
 !<
 subroutine psor2sma_core (p, sz, idx, g, cf, ofst, color, omg, b, res, flop)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, g
 integer                                                ::  ist, jst, kst
@@ -412,7 +590,7 @@ double precision                                       ::  flop
 double precision                                       ::  res
 real                                                   ::  omg, dd, ss, dp, pp, bb, pn
 real                                                   ::  c1, c2, c3, c4, c5, c6, res1
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, b
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
 integer                                                ::  kp, color, ofst
 real, dimension(7)                                     ::  cf
 
@@ -462,23 +640,1648 @@ do i=ist,ied
 !dir$ vector aligned
 !dir$ simd
 !NEC$ IVDEP
-!pgi$ vector
-do k=kst+mod(i+j+kp,2), ked, 2
-#endif
-  pp = p(k,i,j)
-  bb = b(k,i,j)
-  ss = c1 * p(k  , i+1,j  ) &
-     + c2 * p(k  , i-1,j  ) &
-     + c3 * p(k  , i  ,j+1) &
-     + c4 * p(k  , i  ,j-1) &
-     + c5 * p(k+1, i  ,j  ) &
-     + c6 * p(k-1, i  ,j  )
-  dp = ( (ss - bb)/dd - pp ) * omg
-  pn = pp + dp
-  p(k,i,j) = pn
-  res1 = res1 + dp*dp
+!pgi$ vector
+do k=kst+mod(i+j+kp,2), ked, 2
+#endif
+  pp = p(k,i,j)
+  bb = b(k,i,j)
+  ss = c1 * p(k  , i+1,j  ) &
+     + c2 * p(k  , i-1,j  ) &
+     + c3 * p(k  , i  ,j+1) &
+     + c4 * p(k  , i  ,j-1) &
+     + c5 * p(k+1, i  ,j  ) &
+     + c6 * p(k-1, i  ,j  )
+  dp = ( (ss - bb)/dd - pp ) * omg
+  pn = pp + dp
+  p(k,i,j) = pn
+  res1 = res1 + dp*dp
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor2sma_core
+
+
+!> ********************************************************************
+!! @brief 2-colored SOR法 色毎に分けた配列
+!! @param [in,out] pc    更新する色の圧力
+!! @param [in]     po    他方の色の圧力
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     nh    色毎の配列のK方向の長さ
+!! @param [in]     ofst  開始点オフセット
+!! @param [in]     color グループ番号
+!! @param [in]     omg   加速係数
+!! @param [in]     bc    更新する色のRHS vector
+!! @param [out]    res   residual
+!! @param [in,out] flop  浮動小数演算数
+!! @note 点(k,i,j)は色 mod(k+i+j+kst+ofst,2) の配列の h=(k+g-1)/2 に置く（rb_split_pack()）
+!!       I,J方向の隣接点は他方の色の同じ h に，K方向の隣接点は h+e-1, h+e にあり，
+!!       e=mod(k+g-1,2) は(i,j)毎に一定なので，全ての参照が h 方向に連続となる
+!!       演算の順序は psor2sma_core() と同じ
+!<
+subroutine psor2sma_split (pc, po, sz, idx, g, nh, cf, ofst, color, omg, bc, res, flop)
+implicit none
+integer                                                ::  i, j, h, g, nh, e, h0, h1, k0
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  flop
+double precision                                       ::  res
+real                                                   ::  omg, dd, ss, dp, pp, bb, pn
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(0:nh-1, 1-g:sz(1)+g, 1-g:sz(2)+g)      ::  pc, po, bc
+integer                                                ::  kp, color, ofst
+real, dimension(7)                                     ::  cf
+
+kp = ofst+color
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+res1 = 0.0
+
+flop = flop + 18.0d0*0.5d0  &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang reduction(+:res1)
+do j=jst,jed
+!$acc loop independent gang private(k0, e, h0, h1) reduction(+:res1)
+do i=ist,ied
+#else
+!$OMP PARALLEL REDUCTION(+:res1) &
+!$OMP PRIVATE(pp, bb, ss, dp, pn, k0, e, h0, h1)
+#ifdef __NEC__
+!$OMP DO SCHEDULE(static)
+#else
+!$OMP DO SCHEDULE(static) COLLAPSE(2)
+#endif
+do j=jst,jed
+do i=ist,ied
+#endif
+k0 = kst+mod(i+j+kp,2)
+e  = mod(k0+g-1, 2)
+h0 = (k0+g-1)/2
+h1 = (ked-mod(ked-k0+2,2)+g-1)/2
+#ifdef _OPENACC
+!$acc loop independent vector(128) reduction(+:res1)
+#else
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+!pgi$ vector
+#endif
+do h=h0, h1
+  pp = pc(h,i,j)
+  bb = bc(h,i,j)
+  ss = c1 * po(h    , i+1,j  ) &
+     + c2 * po(h    , i-1,j  ) &
+     + c3 * po(h    , i  ,j+1) &
+     + c4 * po(h    , i  ,j-1) &
+     + c5 * po(h+e  , i  ,j  ) &
+     + c6 * po(h+e-1, i  ,j  )
+  dp = ( (ss - bb)/dd - pp ) * omg
+  pn = pp + dp
+  pc(h,i,j) = pn
+  res1 = res1 + dp*dp
+end do
+end do
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor2sma_split
+
+
+!> ********************************************************************
+!! @brief 自然順の配列を色毎の配列に分ける
+!! @param [out] xr    色0の配列
+!! @param [out] xb    色1の配列
+!! @param [in]  x     自然順の配列
+!! @param [in]  sz    配列長
+!! @param [in]  idx   インデクス範囲
+!! @param [in]  g     ガイドセル長
+!! @param [in]  nh    色毎の配列のK方向の長さ (sz(3)+2g+1)/2
+!! @param [in]  ofst  開始点オフセット
+!! @note ガイドセルを含む全点を写す
+!<
+subroutine rb_split_pack (xr, xb, x, sz, idx, g, nh, ofst)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g, nh, ofst, kst, kr, kb
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+real, dimension(0:nh-1, 1-g:sz(1)+g, 1-g:sz(2)+g)      ::  xr, xb
+
+kst = idx(4)
+
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(i, k, kr, kb)
+do j=1-g, sz(2)+g
+do i=1-g, sz(1)+g
+kr = 1-g + modulo(1-g+i+j+kst+ofst, 2)
+kb = 1-g + modulo(  g+i+j+kst+ofst, 2)
+
+!dir$ simd
+do k=kr, sz(3)+g, 2
+  xr((k+g-1)/2, i, j) = x(k, i, j)
+end do
+
+!dir$ simd
+do k=kb, sz(3)+g, 2
+  xb((k+g-1)/2, i, j) = x(k, i, j)
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine rb_split_pack
+
+
+!> ********************************************************************
+!! @brief 色毎の配列の内点を自然順の配列に戻す
+!! @param [in,out] x     自然順の配列
+!! @param [in]     xr    色0の配列
+!! @param [in]     xb    色1の配列
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     nh    色毎の配列のK方向の長さ
+!! @param [in]     ofst  開始点オフセット
+!! @note 内点の外側の層は反復中に自然順の配列側で更新されている
+!<
+subroutine rb_split_merge (x, xr, xb, sz, idx, g, nh, ofst)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g, nh, ofst, kr, kb
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+real, dimension(0:nh-1, 1-g:sz(1)+g, 1-g:sz(2)+g)      ::  xr, xb
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+#ifdef __NEC__
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(i, k, kr, kb)
+#else
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(k, kr, kb)
+#endif
+do j=jst, jed
+do i=ist, ied
+kr = kst + mod(i+j+ofst,   2)
+kb = kst + mod(i+j+ofst+1, 2)
+
+!dir$ simd
+do k=kr, ked, 2
+  x(k, i, j) = xr((k+g-1)/2, i, j)
+end do
+
+!dir$ simd
+do k=kb, ked, 2
+  x(k, i, j) = xb((k+g-1)/2, i, j)
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine rb_split_merge
+
+
+!> ********************************************************************
+!! @brief 色毎の配列と自然順の配列の間で面の1層を写す
+!! @param [in,out] xr    色0の配列
+!! @param [in,out] xb    色1の配列
+!! @param [in,out] x     自然順の配列
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     nh    色毎の配列のK方向の長さ
+!! @param [in]     ofst  開始点オフセット
+!! @param [in]     dir   0-内点の最外層を x へ（通信前）, 1-その外側の層を x から（通信・境界条件の後）
+!<
+subroutine rb_split_face (xr, xb, x, sz, idx, g, nh, ofst, dir)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g, nh, ofst, dir, f, h
+integer                                                ::  ist, jst, kst, is, js, ks
+integer                                                ::  ied, jed, ked, ie, je, ke
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x
+real, dimension(0:nh-1, 1-g:sz(1)+g, 1-g:sz(2)+g)      ::  xr, xb
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+do f=0, 5
+is = ist
+ie = ied
+js = jst
+je = jed
+ks = kst
+ke = ked
+
+select case (f)
+case (0)
+  is = ist - dir
+  ie = is
+case (1)
+  ie = ied + dir
+  is = ie
+case (2)
+  js = jst - dir
+  je = js
+case (3)
+  je = jed + dir
+  js = je
+case (4)
+  ks = kst - dir
+  ke = ks
+case (5)
+  ke = ked + dir
+  ks = ke
+end select
+
+!$OMP PARALLEL DO SCHEDULE(static) PRIVATE(i, k, h)
+do j=js, je
+do i=is, ie
+do k=ks, ke
+  h = (k+g-1)/2
+  if ( mod(k+i+j+kst+ofst, 2) == 0 ) then
+    if ( dir == 0 ) then
+      x(k, i, j) = xr(h, i, j)
+    else
+      xr(h, i, j) = x(k, i, j)
+    endif
+  else
+    if ( dir == 0 ) then
+      x(k, i, j) = xb(h, i, j)
+    else
+      xb(h, i, j) = x(k, i, j)
+    endif
+  endif
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+end do
+
+return
+end subroutine rb_split_face
+
+
+!> ********************************************************************
+!! @brief 多色SOR法の区間ブロックの逆行列（定数係数）
+!! @param [in]  cf    係数
+!! @param [out] ti    長さ L=1..MC_W の区間の三重対角行列 tridiag(-c6, dd, -c5) の逆行列 ti(:,:,L)
+!! @note 領域端で区間が短くなる場合のため，全ての長さについて求めておく
+!<
+subroutine psor_mc_factorize (cf, ti)
+implicit none
+include 'cz_fparam.fi'
+integer                                        ::  l, m, k
+real, dimension(7)                             ::  cf
+real, dimension(0:MC_W-1, 0:MC_W-1, MC_W)      ::  ti
+real, dimension(0:MC_W-1)                      ::  cp, d
+real                                           ::  a, c, dd, e
+
+a  = -cf(6)
+c  = -cf(5)
+dd =  cf(7)
+
+ti = 0.0
+
+do l=1, MC_W
+
+! 単位ベクトルをThomas法で解き，逆行列の列 m を得る
+do m=0, l-1
+d = 0.0
+d(m) = 1.0
+
+cp(0) = c / dd
+d(0)  = d(0) / dd
+do k=1, l-1
+  e = 1.0 / (dd - a * cp(k-1))
+  cp(k) = c * e
+  d(k)  = (d(k) - a * d(k-1)) * e
+end do
+
+do k=l-2, 0, -1
+  d(k) = d(k) - cp(k) * d(k+1)
+end do
+
+do k=0, l-1
+  ti(k, m, l) = d(k)
+end do
+end do
+
+end do
+
+return
+end subroutine psor_mc_factorize
+
+
+!> ********************************************************************
+!! @brief 多色SOR法 K方向の連続する MC_W 点の区間を単位とするブロックSOR
+!! @param [in,out] p     圧力
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     cf    係数
+!! @param [in]     off   全体領域での自領域の起点 head-1
+!! @param [in]     color 色番号 0:nc-1
+!! @param [in]     nc    色数 4 or 8
+!! @param [in]     ti    区間ブロックの逆行列 psor_mc_factorize()
+!! @param [in]     omg   加速係数
+!! @param [in]     b     RHS vector
+!! @param [out]    res   residual
+!! @param [in,out] flop  浮動小数演算数
+!! @note 全体領域のK方向を長さ MC_W の区間 s=(kg-1)/MC_W に分け，
+!!       4色は mod(ig+jg,2) + 2*mod(s,2)，8色は mod(ig,2) + 2*mod(jg,2) + 4*mod(s,2) で色を決める
+!!       同色の区間は互いに隣接しない．区間内のK方向の結合は逆行列との積で厳密に解くので，
+!!       区間の更新は全てK方向に連続なSIMDとなる．区間長はコンパイル時定数とし，
+!!       領域端の短い区間のみ一般の長さで処理する
+!<
+subroutine psor_mc (p, sz, idx, g, cf, off, color, nc, ti, omg, b, res, flop)
+use cz_layout
+implicit none
+include 'cz_fparam.fi'
+integer                                                ::  i, j, k, g, s, ks, ke, s0, s1, l, m
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer                                                ::  color, nc, cij, cs
+integer, dimension(3)                                  ::  sz, off
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  flop
+double precision                                       ::  res
+real                                                   ::  omg, dp, pp, tm
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+real, dimension(7)                                     ::  cf
+real, dimension(0:MC_W-1, 0:MC_W-1, MC_W)              ::  ti
+real, dimension(0:MC_W-1)                              ::  t, u
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+
+res1 = 0.0
+
+! (i,j)方向と区間方向の色
+if ( nc == 8 ) then
+  cij = mod(color, 4)
+  cs  = color / 4
+else
+  cij = mod(color, 2)
+  cs  = color / 2
+endif
+
+s0 = (kst+off(3)-1)/MC_W
+s1 = (ked+off(3)-1)/MC_W
+
+flop = flop + dble(13+2*MC_W)/dble(nc)  &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+!$OMP PARALLEL REDUCTION(+:res1) &
+!$OMP PRIVATE(pp, dp, tm, s, ks, ke, l, m, k, t, u)
+#ifdef __NEC__
+!$OMP DO SCHEDULE(static)
+#else
+!$OMP DO SCHEDULE(static) COLLAPSE(2)
+#endif
+do j=jst,jed
+do i=ist,ied
+
+if ( nc == 8 ) then
+  if ( mod(i+off(1),2) + 2*mod(j+off(2),2) /= cij ) cycle
+else
+  if ( mod(i+j+off(1)+off(2),2) /= cij ) cycle
+endif
+
+do s=s0+mod(s0+cs,2), s1, 2
+ks = max(kst, s*MC_W+1-off(3))
+ke = min(ked, (s+1)*MC_W-off(3))
+l  = ke-ks+1
+
+if ( l == MC_W ) then
+
+! 区間外からの寄与 4 + 5 flops
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+do k=0, MC_W-1
+  t(k) = c1 * p(ks+k, i+1,j  ) &
+       + c2 * p(ks+k, i-1,j  ) &
+       + c3 * p(ks+k, i  ,j+1) &
+       + c4 * p(ks+k, i  ,j-1) &
+       - b(ks+k,i,j)
+end do
+t(0)      = t(0)      + c6 * p(ks-1,i,j)
+t(MC_W-1) = t(MC_W-1) + c5 * p(ke+1,i,j)
+
+! 区間ブロックの逆行列との積 2*MC_W flops
+tm = t(0)
+!dir$ simd
+do k=0, MC_W-1
+  u(k) = ti(k, 0, MC_W) * tm
+end do
+do m=1, MC_W-1
+tm = t(m)
+!dir$ simd
+!NEC$ IVDEP
+do k=0, MC_W-1
+  u(k) = u(k) + ti(k, m, MC_W) * tm
+end do
+end do
+
+! 緩和 4 flops
+!dir$ simd
+do k=0, MC_W-1
+  pp = p(ks+k,i,j)
+  dp = ( u(k) - pp ) * omg
+  p(ks+k,i,j) = pp + dp
+  res1 = res1 + dp*dp
+end do
+
+else
+
+! 領域端の短い区間
+do k=0, l-1
+  t(k) = c1 * p(ks+k, i+1,j  ) &
+       + c2 * p(ks+k, i-1,j  ) &
+       + c3 * p(ks+k, i  ,j+1) &
+       + c4 * p(ks+k, i  ,j-1) &
+       - b(ks+k,i,j)
+  u(k) = 0.0
+end do
+t(0)   = t(0)   + c6 * p(ks-1,i,j)
+t(l-1) = t(l-1) + c5 * p(ke+1,i,j)
+
+do m=0, l-1
+tm = t(m)
+do k=0, l-1
+  u(k) = u(k) + ti(k, m, l) * tm
+end do
+end do
+
+do k=0, l-1
+  pp = p(ks+k,i,j)
+  dp = ( u(k) - pp ) * omg
+  p(ks+k,i,j) = pp + dp
+  res1 = res1 + dp*dp
+end do
+
+endif
+
+end do
+
+end do
+end do
+!$OMP END DO
+!$OMP END PARALLEL
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor_mc
+
+
+!> **********************************************************************
+!! @brief 緩和Jacobi法 時間ブロッキング（j方向のウェーブフロント）
+!! @param [in,out] p    圧力
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     cf   係数
+!! @param [in]     omg  加速係数
+!! @param [in]     b    RHS vector
+!! @param [in,out] res  residual（最終段のみ）
+!! @param [in]     nt   1ブロックで進める反復数 (2 <= nt)
+!! @param [in]     ex   各面の拡張フラグ（隣接ランクがあれば1）
+!! @param [out]    wb   中間段のリングバッファ（各段3面）
+!! @param [in,out] flop flop count
+!! @note 段tの面jは段t-1の面j-1, j, j+1だけに依存するので，段ごとに1面ずつ
+!!       遅らせて進めると，各段の作業面はキャッシュに載ったまま再利用される
+!!       最終段は段1が読み終えた面にpへ直接書き込む
+!!       隣接ランクのある面は段ごとに1セルずつ狭めてガイドセル内を冗長に計算する
+!!       このため ex=1 の面があるときは nt <= g で，nt層分のガイドセルが同期済みであること
+!<
+subroutine jacobi_tb (p, sz, idx, g, cf, omg, b, res, nt, ex, wb, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g, t, jj, nt
+integer                                                ::  m, jm, jp
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx, ex
+integer, dimension(nt)                                 ::  is, ie, js, je, ks, ke
+double precision                                       ::  res
+double precision                                       ::  flop
+real                                                   ::  omg, dd, ss, dp, pp, bb, pn
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 0:2, nt-1)   ::  wb
+real, dimension(7)                                     ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+res1 = 0.0
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+! 各段の計算範囲
+do t=1, nt
+  is(t) = ist - ex(0)*(nt-t)
+  ie(t) = ied + ex(1)*(nt-t)
+  js(t) = jst - ex(2)*(nt-t)
+  je(t) = jed + ex(3)*(nt-t)
+  ks(t) = kst - ex(4)*(nt-t)
+  ke(t) = ked + ex(5)*(nt-t)
+
+  flop = flop + 18.0  &
+              * dble(ie(t)-is(t)+1) &
+              * dble(je(t)-js(t)+1) &
+              * dble(ke(t)-ks(t)+1)
+end do
+
+
+#ifndef _OPENACC
+!$OMP PARALLEL PRIVATE(pp, bb, ss, dp, pn, m, jm, jp, j) &
+!$OMP REDUCTION(+:res1)
+#endif
+do jj = js(1)-1, je(nt)+nt-1
+do t = 1, nt
+  j = jj - t + 1
+
+  if ( t < nt ) then
+
+    ! 段tの面jを用意する．範囲外の面にはpの値（境界値）が残る
+    if ( j < js(t)-1 .or. j > je(t)+1 ) cycle
+    m = modulo(j, 3)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(2)
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+    do i = 1-g, sz(1)+g
+    do k = 1-g, sz(3)+g
+      wb(k,i,m,t) = p(k,i,j)
+    end do
+    end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+    if ( j < js(t) .or. j > je(t) ) cycle
+
+    if ( t == 1 ) then
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(2)
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+      do i = is(1), ie(1)
+      do k = ks(1), ke(1)
+        pp = p(k,i,j)
+        bb = b(k,i,j)
+        ss = c1 * p(k  , i+1,j  ) &
+           + c2 * p(k  , i-1,j  ) &
+           + c3 * p(k  , i  ,j+1) &
+           + c4 * p(k  , i  ,j-1) &
+           + c5 * p(k+1, i  ,j  ) &
+           + c6 * p(k-1, i  ,j  )
+        dp = ( (ss - bb)/dd - pp ) * omg
+        pn = pp + dp
+        wb(k,i,m,1) = pn
+      end do
+      end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+    else
+
+      jm = modulo(j-1, 3)
+      jp = modulo(j+1, 3)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(2)
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+      do i = is(t), ie(t)
+      do k = ks(t), ke(t)
+        pp = wb(k,i,m,t-1)
+        bb = b(k,i,j)
+        ss = c1 * wb(k  , i+1,m ,t-1) &
+           + c2 * wb(k  , i-1,m ,t-1) &
+           + c3 * wb(k  , i  ,jp,t-1) &
+           + c4 * wb(k  , i  ,jm,t-1) &
+           + c5 * wb(k+1, i  ,m ,t-1) &
+           + c6 * wb(k-1, i  ,m ,t-1)
+        dp = ( (ss - bb)/dd - pp ) * omg
+        pn = pp + dp
+        wb(k,i,m,t) = pn
+      end do
+      end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+    endif
+
+  else
+
+    ! 最終段 pへ書き戻す
+    if ( j < js(nt) .or. j > je(nt) ) cycle
+    m  = modulo(j, 3)
+    jm = modulo(j-1, 3)
+    jp = modulo(j+1, 3)
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop collapse(2) reduction(+:res1)
+#else
+!$OMP DO SCHEDULE(static)
+#endif
+    do i = is(nt), ie(nt)
+    do k = ks(nt), ke(nt)
+      pp = wb(k,i,m,nt-1)
+      bb = b(k,i,j)
+      ss = c1 * wb(k  , i+1,m ,nt-1) &
+         + c2 * wb(k  , i-1,m ,nt-1) &
+         + c3 * wb(k  , i  ,jp,nt-1) &
+         + c4 * wb(k  , i  ,jm,nt-1) &
+         + c5 * wb(k+1, i  ,m ,nt-1) &
+         + c6 * wb(k-1, i  ,m ,nt-1)
+      dp = ( (ss - bb)/dd - pp ) * omg
+      pn = pp + dp
+      p(k,i,j) = pn
+      res1 = res1 + dp*dp
+    end do
+    end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+  endif
+
+end do
+end do
+#ifndef _OPENACC
+!$OMP END PARALLEL
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine jacobi_tb
+
+
+!> ********************************************************************
+!! @brief 2-colored SOR法 時間ブロッキング（j方向のウェーブフロント）
+!! @param [in,out] p     圧力
+!! @param [in]     sz    配列長
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     g     ガイドセル長
+!! @param [in]     cf    係数
+!! @param [in]     ofst  開始点オフセット
+!! @param [in]     omg   加速係数
+!! @param [in]     b     RHS vector
+!! @param [in,out] res   residual（最後の反復のみ）
+!! @param [in]     nt    1ブロックで進める反復数
+!! @param [in,out] flop  浮動小数演算数
+!! @note 半反復（1色分）hの面は半反復h-1の面より1面遅れて更新する
+!!       各色の更新はj-1, j, j+1面の他色だけを参照するので，psor2sma_core()を
+!!       nt回呼んだ結果と一致し，作業面はキャッシュに載ったまま再利用される
+!!       ガイドセルはnt反復の間固定なので，隣接ランクのない領域でのみ使う
+!<
+subroutine psor2sma_tb (p, sz, idx, g, cf, ofst, omg, b, res, nt, flop)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g, h, jj, nt
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+double precision                                       ::  flop
+double precision                                       ::  res
+real                                                   ::  omg, dd, ss, dp, pp, bb, pn
+real                                                   ::  c1, c2, c3, c4, c5, c6, res1
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, b
+integer                                                ::  kp, ofst
+real, dimension(7)                                     ::  cf
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+c1 = cf(1)
+c2 = cf(2)
+c3 = cf(3)
+c4 = cf(4)
+c5 = cf(5)
+c6 = cf(6)
+dd = cf(7)
+
+res1 = 0.0
+
+flop = flop + 18.0d0 * dble(nt) &
+     * dble(ied-ist+1) &
+     * dble(jed-jst+1) &
+     * dble(ked-kst+1)
+
+
+#ifndef _OPENACC
+!$OMP PARALLEL PRIVATE(pp, bb, ss, dp, pn, kp, j) &
+!$OMP REDUCTION(+:res1)
+#endif
+do jj = jst, jed+2*nt-1
+do h = 1, 2*nt
+  j = jj - h + 1
+  if ( j < jst .or. j > jed ) cycle
+
+  ! color = mod(h-1, 2)
+  kp = ofst + mod(h-1, 2)
+
+  if ( h > 2*nt-2 ) then
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang reduction(+:res1)
+do i=ist,ied
+!$acc loop independent vector(128) reduction(+:res1)
+do k=kst+mod(i+j+kp,2), ked, 2
+#else
+!$OMP DO SCHEDULE(static)
+do i=ist,ied
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+!pgi$ vector
+do k=kst+mod(i+j+kp,2), ked, 2
+#endif
+      pp = p(k,i,j)
+      bb = b(k,i,j)
+      ss = c1 * p(k  , i+1,j  ) &
+         + c2 * p(k  , i-1,j  ) &
+         + c3 * p(k  , i  ,j+1) &
+         + c4 * p(k  , i  ,j-1) &
+         + c5 * p(k+1, i  ,j  ) &
+         + c6 * p(k-1, i  ,j  )
+      dp = ( (ss - bb)/dd - pp ) * omg
+      pn = pp + dp
+      p(k,i,j) = pn
+      res1 = res1 + dp*dp
+    end do
+    end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+  else
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang
+do i=ist,ied
+!$acc loop independent vector(128)
+do k=kst+mod(i+j+kp,2), ked, 2
+#else
+!$OMP DO SCHEDULE(static)
+do i=ist,ied
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+!pgi$ vector
+do k=kst+mod(i+j+kp,2), ked, 2
+#endif
+      pp = p(k,i,j)
+      bb = b(k,i,j)
+      ss = c1 * p(k  , i+1,j  ) &
+         + c2 * p(k  , i-1,j  ) &
+         + c3 * p(k  , i  ,j+1) &
+         + c4 * p(k  , i  ,j-1) &
+         + c5 * p(k+1, i  ,j  ) &
+         + c6 * p(k-1, i  ,j  )
+      dp = ( (ss - bb)/dd - pp ) * omg
+      p(k,i,j) = pp + dp
+    end do
+    end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+#endif
+
+  endif
+
+end do
+end do
+#ifndef _OPENACC
+!$OMP END PARALLEL
+#endif
+
+res = res + real(res1, kind=8)
+
+return
+end subroutine psor2sma_tb
+
+
+!> ********************************************************************
+!! @brief PCRの係数行列の分解（定数係数）
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     pn    段数（nを超える最小の2べき数の乗数）
+!! @param [out]    fe    各段の対角スケール e
+!! @param [out]    fa    各段の e*a
+!! @param [out]    fc    各段の e*c
+!! @param [out]    f2    pn-1段後の2x2系の逆行列
+!! @param [out]    f4    pn-2段後の4x4系の逆行列
+!! @note 係数 a=c=-1/6 は全ての(i,j)ラインで共通なので，反復前に一度だけ計算しておく
+!!       各段では d1(k) = fe(k)*d(k) - fa(k)*d(k-s) - fc(k)*d(k+s) となる
+!!       範囲外の行は単位行列として扱う
+!<
+subroutine pcr_factorize (idx, pn, fe, fa, fc, f2, f4)
+implicit none
+!args
+integer, dimension(0:5)                        ::  idx
+integer                                        ::  pn
+real, dimension(idx(4):idx(5), pn)             ::  fe, fa, fc
+real, dimension(4, idx(4):idx(5))              ::  f2
+real, dimension(16, idx(4):idx(5))             ::  f4
+! work
+integer                                        ::  k, kl, km, kr, p, s, sq, kst, ked, l, m
+real, dimension(idx(4)-2**pn:idx(5)+2**pn)     ::  a, c, a1, c1, a4, c4
+real                                           ::  r, ap, cp, e, jj
+real                                           ::  dd1, dd2, dd3, dd4
+real                                           ::  aa2, aa3, aa4, cc1, cc2, cc3
+real                                           ::  inv_detA
+
+kst = idx(4)
+ked = idx(5)
+
+r = 1.0/6.0
+
+a  = 0.0
+c  = 0.0
+a1 = 0.0
+c1 = 0.0
+fe = 0.0
+fa = 0.0
+fc = 0.0
+f2 = 0.0
+f4 = 0.0
+
+do k=kst+1, ked
+a(k) = -r
+end do
+
+do k=kst, ked-1
+c(k) = -r
+end do
+
+
+! 各段の係数
+do p=1, pn-1
+s = 2**(p-1)
+
+! pn-2段後の係数を4x4系用に保持
+if ( p == pn-1 ) then
+  a4 = a
+  c4 = c
+endif
+
+do k = kst, ked
+ap = a(k)
+cp = c(k)
+e = 1.0 / ( 1.0 - ap * c(k-s) - cp * a(k+s) )
+fe(k, p) = e
+fa(k, p) = e * ap
+fc(k, p) = e * cp
+a1(k) =  -e * ap * a(k-s)
+c1(k) =  -e * cp * c(k+s)
+end do
+
+do k = kst, ked
+a(k) = a1(k)
+c(k) = c1(k)
+end do
+
+end do ! p反復
+
+if ( pn == 1 ) then
+  a4 = a
+  c4 = c
+endif
+
+
+! pn-1段後の2x2系
+s = 2**(pn-1)
+
+do k = kst, min(kst+s-1, ked)
+cc1 = c(k)
+aa2 = a(k+s)
+jj  = 1.0 / (1.0 - aa2 * cc1)
+f2(1, k) =  jj
+f2(2, k) = -cc1 * jj
+f2(3, k) = -aa2 * jj
+f2(4, k) =  jj
+end do
+
+
+! pn-2段後の4x4系 Cramerの公式を単位ベクトルに適用して逆行列の各列を得る
+sq = max(2**(pn-2), 1)
+
+do k = kst, min(kst+sq-1, ked)
+kl = k +   sq
+km = k + 2*sq
+kr = k + 3*sq
+
+cc1 = c4(k)
+cc2 = c4(kl)
+cc3 = c4(km)
+aa2 = a4(kl)
+aa3 = a4(km)
+aa4 = a4(kr)
+
+inv_detA= 1.0 / (1.0 - aa4*cc3 - aa3*cc2 - aa2*cc1*(1.0 - cc3*aa4))
+
+do m=1, 4
+dd1 = 0.0
+dd2 = 0.0
+dd3 = 0.0
+dd4 = 0.0
+if ( m == 1 ) dd1 = 1.0
+if ( m == 2 ) dd2 = 1.0
+if ( m == 3 ) dd3 = 1.0
+if ( m == 4 ) dd4 = 1.0
+
+! f4(l,k) : l = 4*(行-1) + 列
+l = m
+f4(l, k) = ( -cc3*(aa4*dd1 + cc1*cc2*dd4 - aa4*cc1*dd2) &
+           +       dd1 + cc1*cc2*dd3 - aa3*cc2*dd1 - cc1*dd2 ) * inv_detA
+
+l = 4 + m
+f4(l, k) = ( dd2 + cc2*cc3*dd4 - aa4*cc3*dd2 - cc2*dd3 &
+           -       aa2*(dd1 - aa4*cc3*dd1) ) * inv_detA
+
+l = 8 + m
+f4(l, k) = ( dd3 - cc3*dd4 - aa3*dd2 &
+           -       aa2*(cc1*dd3 - cc1*cc3*dd4 - aa3*dd1) ) * inv_detA
+
+l = 12 + m
+f4(l, k) = ( dd4 + aa3*aa4*dd2 - aa4*dd3 - aa3*cc2*dd4 &
+           -       aa2*(cc1*dd4 + aa3*aa4*dd1 - aa4*cc1*dd3) ) * inv_detA
+end do
+
+end do
+
+return
+end subroutine pcr_factorize
+
+
+!> ********************************************************************
+!! @brief PCR-Thomas法の係数行列の分解（定数係数）
+!! @param [in]     idx   インデクス範囲
+!! @param [in]     q     PCRの段数
+!! @param [in]     nt    Thomas法の対象長 w=2**q の倍数
+!! @param [out]    tw    前進消去の対角の逆数 1/(1 - a(k) tc(k-w))
+!! @param [out]    ta    前進消去の係数 a(k)*tw(k)
+!! @param [out]    tc    後退代入の係数 c(k)*tw(k)
+!! @note q段のPCRで各ラインは間隔 w の独立な w 本の部分系に分かれる
+!!       a(k) x(k-w) + x(k) + c(k) x(k+w) = d(k) を部分系毎にThomas法で解く
+!!       ked を超える点は単位行列として nt まで埋め，部分系の長さを揃える
+!<
+subroutine pcr_hyb_factorize (idx, q, nt, tw, ta, tc)
+implicit none
+!args
+integer, dimension(0:5)                        ::  idx
+integer                                        ::  q, nt
+real, dimension(idx(4):idx(4)+nt-1)            ::  tw, ta, tc
+! work
+integer                                        ::  k, p, s, w, kst, ked
+real, dimension(idx(4)-2**q:idx(4)+nt-1+2**q)  ::  a, c, a1, c1
+real                                           ::  r, ap, cp, e
+
+kst = idx(4)
+ked = idx(5)
+w = 2**q
+
+r = 1.0/6.0
+
+a  = 0.0
+c  = 0.0
+a1 = 0.0
+c1 = 0.0
+
+do k=kst+1, ked
+a(k) = -r
+end do
+
+do k=kst, ked-1
+c(k) = -r
+end do
+
+
+! q段後の係数 pcr_factorize() と同じ漸化式
+do p=1, q
+s = 2**(p-1)
+
+do k = kst, ked
+ap = a(k)
+cp = c(k)
+e = 1.0 / ( 1.0 - ap * c(k-s) - cp * a(k+s) )
+a1(k) =  -e * ap * a(k-s)
+c1(k) =  -e * cp * c(k+s)
+end do
+
+do k = kst, ked
+a(k) = a1(k)
+c(k) = c1(k)
+end do
+
+end do ! p反復
+
+
+! 部分系毎のThomas法 前進消去の係数 c1 に tc を k-w の参照用に写す
+c1 = 0.0
+
+do k = kst, kst+nt-1
+e = 1.0 / ( 1.0 - a(k) * c1(k-w) )
+tw(k) = e
+ta(k) = a(k) * e
+tc(k) = c(k) * e
+c1(k) = tc(k)
+end do
+
+return
+end subroutine pcr_hyb_factorize
+
+
+!********************************************************************************
+subroutine pcr_rb (sz, idx, g, pn, nl, lst, x, msk, rhs, fe, fa, fc, f2, d, d1, omg, res, flop)
+use cz_layout
+implicit none
+!args
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+integer                                                ::  g, pn, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(4, idx(4):idx(5))                      ::  f2
+real                                                   ::  omg
+double precision                                       ::  res, flop
+! work
+integer                                  ::  i, j, k, l, kl, kr, s, p
+integer                                  ::  ist, ied, jst, jed, kst, ked
+real, dimension(-1:sz(3)+2)              ::  d, d1
+real                                     ::  r, pp, dp, res1
+real                                     ::  dd1, dd2
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+res1 = 0.0
+r = 1.0/6.0
+
+flop = flop + dble(          &
+  nl * ( &
+     (ked-kst+1)* 6.0        &  ! Source
+   + (ked-kst+1)*(pn-1)*5.0  &  ! PCR
+   + 2**(pn-1)*6.0           &
+   + (ked-kst+1)*6.0         &  ! Relaxation
+     + 6.0 )                 &  ! BC
+  )
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang private(i, j, d, d1) reduction(+:res)
+#else
+!$OMP PARALLEL &
+!$OMP reduction(+:res) &
+!$OMP private(i, j) &
+!$OMP private(kl, kr, s, p, k, pp, dp) &
+!$OMP private(dd1, dd2) &
+!$OMP private(d, d1)
+!$OMP DO SCHEDULE(static)
+#endif
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
+
+
+! 係数は pcr_factorize() で計算済み，範囲外の参照のため端を0にしておく
+d(kst-1) = 0.0
+d(ked+1) = 0.0
+
+! Source
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+d(k) = (   ( x(k, i  , j-1)        &
+       +     x(k, i  , j+1)        &
+       +     x(k, i-1, j  )        &
+       +     x(k, i+1, j  ) - rhs(k, i, j) ) * r ) &
+       *   msk(k, i, j)
+end do ! 6 flops
+
+! BC  6 flops
+d(kst) = ( d(kst) + x(kst-1, i, j) * r ) * msk(kst, i, j)
+d(ked) = ( d(ked) + x(ked+1, i, j) * r ) * msk(ked, i, j)
+
+
+! PCR  最終段の一つ手前で停止
+!$acc loop seq
+do p=1, pn-1
+s = 2**(p-1)
+
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+kl = max(k-s, kst-1)
+kr = min(k+s, ked+1)
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(kl) - fc(k,p) * d(kr)
+end do
+
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+d(k) = d1(k)
+end do
+
+end do ! p反復
+
+
+! 最終段の反転
+s = 2**(pn-1)
+
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+!$acc loop independent
+do k = kst, kst+s-1
+kr = min(k+s, ked+1)
+dd1 = d(k)
+dd2 = d(kr)
+d1(k ) = f2(1,k) * dd1 + f2(2,k) * dd2
+d1(kr) = f2(3,k) * dd1 + f2(4,k) * dd2
+end do
+
+
+! a_{i-1} x_{i-2} + x_{i-1} + c_{i-1} x_i     = d_{i-1}
+! a_{i}   x_{i-1} + x_{i}   + c_{i}   x_{i+1} = d_{i}
+! a_{i+1} x_{i}   + x_{i+1} + c_{i+1} x_{i+2} = d_{i+1}
+
+
+! Relaxation
+!dir$ vector aligned
+!dir$ simd
+!$acc loop reduction(+:res)
+do k = kst, ked
+pp =   x(k, i, j)
+dp = ( d1(k) - pp ) * omg * msk(k, i, j)
+x(k, i, j) = pp + dp
+!res1 = res1 + dp*dp
+res = res + dp*dp
+end do
+
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+!res = res + real(res1, kind=8)
+
+return
+end subroutine pcr_rb
+
+
+!********************************************************************************
+!> @brief 2色オーダリングのPCR 隣接するnv本のラインを1本ずつSIMDレーンに割り当てて同時に解く
+!! @param [in] nv  同時に解くライン数（レーン数）8 or 16
+!! @note ラインは K 方向に連続なので，ソース項の計算と緩和は1ライン毎に K 方向に読み書きし，
+!!       作業配列 d(nv, k) との間でレーン方向に転置する．PCRの各段はレーン方向の最内ループとなり，
+!!       K 方向の長さに依らずベクトル長は nv となる．作業配列の両端に 2**(pn-1) の0を置き，
+!!       pcr_rb() の max(), min() によるクランプを除いている．計算結果は pcr_rb() と同じ
+!<
+subroutine pcr_rb_lanes (sz, idx, g, pn, nl, lst, nv, x, msk, rhs, fe, fa, fc, f2, omg, res, flop)
+use cz_layout
+implicit none
+!args
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+integer                                                ::  g, pn, nl, nv
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(4, idx(4):idx(5))                      ::  f2
+real                                                   ::  omg
+double precision                                       ::  res, flop
+! work
+integer                                  ::  i, j, k, l, m, lg, nb, s, p, sp, c0, c1
+integer                                  ::  ist, ied, jst, jed, kst, ked
+real, dimension(nv, idx(4)-2**(pn-1):idx(5)+2**(pn-1), 0:1) ::  d
+real                                     ::  r, pp, dp, e, ea, ec
+real                                     ::  dd1, dd2, f21, f22, f23, f24
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+r = 1.0/6.0
+sp = 2**(pn-1)
+
+flop = flop + dble(          &
+  nl * ( &
+     (ked-kst+1)* 6.0        &  ! Source
+   + (ked-kst+1)*(pn-1)*5.0  &  ! PCR
+   + 2**(pn-1)*6.0           &
+   + (ked-kst+1)*6.0         &  ! Relaxation
+     + 6.0 )                 &  ! BC
+  )
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang private(d) reduction(+:res)
+#else
+!$OMP PARALLEL &
+!$OMP reduction(+:res) &
+!$OMP private(i, j, k, l, m, nb, s, p, c0, c1, pp, dp) &
+!$OMP private(e, ea, ec, dd1, dd2, f21, f22, f23, f24) &
+!$OMP private(d)
+#endif
+
+! 両端の袖は参照のみで書き込まないので，スレッド毎に一度だけ0にする
+#ifndef _OPENACC
+d = 0.0
+
+!$OMP DO SCHEDULE(static)
+#endif
+do lg=1, nl, nv
+nb = min(nv, nl-lg+1)
+
+#ifdef _OPENACC
+d(:, kst-sp:kst-1, :) = 0.0
+d(:, ked+1:ked+sp, :) = 0.0
+#endif
+
+! 端数のグループでは空きレーンを0のまま解く
+if ( nb < nv ) then
+  do k = kst, ked
+  do m = nb+1, nv
+    d(m, k, 0) = 0.0
+  end do
+  end do
+endif
+
+! Source  ラインを K 方向に読み，レーンへ転置
+do m = 1, nb
+i = lst(1, lg+m-1)
+j = lst(2, lg+m-1)
+
+!dir$ simd
+do k = kst, ked
+d(m, k, 0) = (   ( x(k, i  , j-1)        &
+             +     x(k, i  , j+1)        &
+             +     x(k, i-1, j  )        &
+             +     x(k, i+1, j  ) - rhs(k, i, j) ) * r ) &
+             *   msk(k, i, j)
+end do ! 6 flops
+
+! BC  6 flops
+d(m, kst, 0) = ( d(m, kst, 0) + x(kst-1, i, j) * r ) * msk(kst, i, j)
+d(m, ked, 0) = ( d(m, ked, 0) + x(ked+1, i, j) * r ) * msk(ked, i, j)
+end do
+
+
+! PCR  最終段の一つ手前で停止，d(:,:,c0) から d(:,:,c1) へ交互に更新
+c0 = 0
+c1 = 1
+
+!$acc loop seq
+do p=1, pn-1
+s = 2**(p-1)
+
+do k = kst, ked
+e  = fe(k,p)
+ea = fa(k,p)
+ec = fc(k,p)
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+do m = 1, nv
+d(m, k, c1) = e * d(m, k, c0) - ea * d(m, k-s, c0) - ec * d(m, k+s, c0)
+end do
+end do
+
+c0 = c1
+c1 = 1 - c0
+end do ! p反復
+
+
+! 最終段の反転 対になる点が ked を超える場合は f2 が単位行列なので1元
+s = sp
+
+do k = kst, ked-s
+f21 = f2(1,k)
+f22 = f2(2,k)
+f23 = f2(3,k)
+f24 = f2(4,k)
+!dir$ vector aligned
+!dir$ simd
+!NEC$ IVDEP
+do m = 1, nv
+dd1 = d(m, k  , c0)
+dd2 = d(m, k+s, c0)
+d(m, k  , c1) = f21 * dd1 + f22 * dd2
+d(m, k+s, c1) = f23 * dd1 + f24 * dd2
+end do
+end do
+
+do k = max(ked-s+1, kst), min(kst+s-1, ked)
+!dir$ vector aligned
+!dir$ simd
+do m = 1, nv
+d(m, k, c1) = d(m, k, c0)
+end do
+end do
+
+
+! Relaxation  レーンから転置して K 方向に書き戻す
+do m = 1, nb
+i = lst(1, lg+m-1)
+j = lst(2, lg+m-1)
+
+!dir$ simd
+!$acc loop reduction(+:res)
+do k = kst, ked
+pp =   x(k, i, j)
+dp = ( d(m, k, c1) - pp ) * omg * msk(k, i, j)
+x(k, i, j) = pp + dp
+res = res + dp*dp
+end do
+end do
+
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+return
+end subroutine pcr_rb_lanes
+
+
+!********************************************************************************
+!> @brief 2色オーダリングのPCR-Thomas法
+!! @param [in] q    PCRの段数
+!! @param [in] nt   Thomas法の対象長 2**q の倍数
+!! @param [in] tw   前進消去の対角の逆数
+!! @param [in] ta   前進消去の係数
+!! @param [in] tc   後退代入の係数
+!! @note q段のPCRで間隔 w=2**q の w 本の独立な部分系に分け，部分系を並べてThomas法で解く
+!!       前進消去と後退代入は w 点毎に逐次となり，連続する w 点が部分系方向のベクトルとなる
+!!       演算量は (5q+5)N で pcr_rb() の 5(pn-1)N + 6*2**(pn-1) より少ない
+!<
+subroutine pcr_rb_hyb (sz, idx, g, pn, q, nt, nl, lst, x, msk, rhs, fe, fa, fc, tw, ta, tc, omg, res, flop)
+use cz_layout
+implicit none
+!args
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+integer                                                ::  g, pn, q, nt, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(idx(4):idx(4)+nt-1)                    ::  tw, ta, tc
+real                                                   ::  omg
+double precision                                       ::  res, flop
+! work
+integer                                  ::  i, j, k, l, m, kb, s, p, w, c0, c1
+integer                                  ::  ist, ied, jst, jed, kst, ked
+real, dimension(idx(4)-2**q:idx(4)+nt-1+2**q, 0:1) ::  d
+real                                     ::  r, pp, dp
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+r = 1.0/6.0
+w = 2**q
+
+flop = flop + dble(          &
+  nl * ( &
+     (ked-kst+1)* 6.0        &  ! Source
+   + (ked-kst+1)*q*5.0       &  ! PCR
+   + nt*5.0                  &  ! Thomas
+   + (ked-kst+1)*6.0         &  ! Relaxation
+     + 6.0 )                 &  ! BC
+  )
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang private(i, j, d) reduction(+:res)
+#else
+!$OMP PARALLEL &
+!$OMP reduction(+:res) &
+!$OMP private(i, j, k, m, kb, s, p, c0, c1, pp, dp) &
+!$OMP private(d)
+#endif
+
+! ked を超える点と両端の袖は0のまま使う
+#ifndef _OPENACC
+d = 0.0
+
+!$OMP DO SCHEDULE(static)
+#endif
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
+
+#ifdef _OPENACC
+d = 0.0
+#endif
+
+! Source
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+d(k, 0) = (   ( x(k, i  , j-1)        &
+          +     x(k, i  , j+1)        &
+          +     x(k, i-1, j  )        &
+          +     x(k, i+1, j  ) - rhs(k, i, j) ) * r ) &
+          *   msk(k, i, j)
+end do ! 6 flops
+
+! BC  6 flops
+d(kst, 0) = ( d(kst, 0) + x(kst-1, i, j) * r ) * msk(kst, i, j)
+d(ked, 0) = ( d(ked, 0) + x(ked+1, i, j) * r ) * msk(ked, i, j)
+
+
+! PCR q段  d(:,c0) から d(:,c1) へ交互に更新
+c0 = 0
+c1 = 1
+
+!$acc loop seq
+do p=1, q
+s = 2**(p-1)
+
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+d(k, c1) = fe(k,p) * d(k, c0) - fa(k,p) * d(k-s, c0) - fc(k,p) * d(k+s, c0)
+end do
+
+c0 = c1
+c1 = 1 - c0
+end do ! p反復
+
+
+! Thomas法 前進消去
+!$acc loop seq
+do kb = kst, kst+nt-1, w
+!dir$ simd
+!NEC$ IVDEP
+do m = 0, w-1
+k = kb + m
+d(k, c0) = tw(k) * d(k, c0) - ta(k) * d(k-w, c0)
+end do
+end do
+
+! 後退代入
+!$acc loop seq
+do kb = kst+nt-w, kst, -w
+!dir$ simd
+!NEC$ IVDEP
+do m = 0, w-1
+k = kb + m
+d(k, c0) = d(k, c0) - tc(k) * d(k+w, c0)
 end do
 end do
+
+
+! Relaxation
+!dir$ vector aligned
+!dir$ simd
+!$acc loop reduction(+:res)
+do k = kst, ked
+pp =   x(k, i, j)
+dp = ( d(k, c0) - pp ) * omg * msk(k, i, j)
+x(k, i, j) = pp + dp
+res = res + dp*dp
+end do
+
 end do
 #ifdef _OPENACC
 !$acc end kernels
@@ -487,28 +2290,38 @@ end do
 !$OMP END PARALLEL
 #endif
 
-res = res + real(res1, kind=8)
-
 return
-end subroutine psor2sma_core
+end subroutine pcr_rb_hyb
 
 
 !********************************************************************************
-subroutine pcr_rb (sz, idx, g, pn, ofst, color, x, msk, rhs, a, c, d, a1, c1, d1, omg, res, flop)
+!> @brief K方向に分割されたラインの局所解（2色オーダリング）
+!! @param [in]  ex   K方向の隣接ランクの有無 ex(1):minus面, ex(2):plus面
+!! @param [out] y    局所解
+!! @param [out] ye   ラインの両端の局所解 ye(1,l)=y(kst), ye(2,l)=y(ked)
+!! @note 隣接ランク側の境界値を0として解く．境界値の寄与は線形なので，
+!!       縮約系で境界値を求めた後に pcr_rb_relax() で重ね合わせる
+!<
+subroutine pcr_rb_y (sz, idx, g, pn, nl, lst, x, msk, rhs, fe, fa, fc, f2, ex, y, ye, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
-real                                                   ::  omg
-double precision                                       ::  res, flop
+integer                                                ::  g, pn, nl
+integer, dimension(2, nl)                              ::  lst
+integer, dimension(2)                                  ::  ex
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs, y
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(4, idx(4):idx(5))                      ::  f2
+real, dimension(2, nl)                                 ::  ye
+double precision                                       ::  flop
 ! work
-integer                                  ::  i, j, k, kl, kr, s, p, color, ip, ofst
+integer                                  ::  i, j, k, l, kl, kr, s, p
 integer                                  ::  ist, ied, jst, jed, kst, ked
-real, dimension(-1:sz(3)+2)              ::  a, c, d, a1, c1, d1
-real                                     ::  r, ap, cp, e, pp, dp, res1
-real                                     ::  jj, dd1, dd2, aa2, cc1, cc2, f1, f2
+real, dimension(-1:sz(3)+2)              ::  d, d1
+real                                     ::  r, wl, wr
+real                                     ::  dd1, dd2
 
 ist = idx(0)
 ied = idx(1)
@@ -517,51 +2330,38 @@ jed = idx(3)
 kst = idx(4)
 ked = idx(5)
 
-res1 = 0.0
 r = 1.0/6.0
 
+! 隣接ランク側の境界値は0
+wl = real(1 - ex(1))
+wr = real(1 - ex(2))
+
 flop = flop + dble(          &
-  (jed-jst+1)*(ied-ist+1)* ( &
+  nl * ( &
      (ked-kst+1)* 6.0        &  ! Source
-   + (ked-kst+1)*(pn-1)*14.0 &  ! PCR
-   + 2**(pn-1)*9.0                 &
-   + (ked-kst+1)*6.0         &  ! Relaxation
-     + 6.0 )                 &  ! BC
-  ) * 0.5
-
-
-ip = ofst + color
+   + (ked-kst+1)*(pn-1)*5.0  &  ! PCR
+   + 2**(pn-1)*6.0           &
+     + 8.0 )                 &  ! BC
+  )
 
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(2) gang private(a, c, d, a1, c1, d1) reduction(+:res)
+!$acc loop independent gang private(i, j, d, d1)
 #else
 !$OMP PARALLEL &
-!$OMP reduction(+:res) &
-!$OMP private(kl, kr, ap, cp, e, s, p, k, pp, dp) &
-!$OMP private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2) &
-!$OMP private(a, c, d, a1, c1, d1)
-!$OMP DO SCHEDULE(static) collapse(2)
+!$OMP private(i, j) &
+!$OMP private(kl, kr, s, p, k) &
+!$OMP private(dd1, dd2) &
+!$OMP private(d, d1)
+!$OMP DO SCHEDULE(static)
 #endif
-do j=jst, jed
-do i=ist, ied
-if(mod(i+j,2) /= color) cycle
-
-! do i=ist+mod(j+ip,2), ied, 2
-
-
-
-! Reflesh coef. due to override
-a(kst) = 0.0
-do k=kst+1, ked
-a(k) = -r
-end do
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
 
-do k=kst, ked-1
-c(k) = -r
-end do
-c(ked) = 0.0
+d(kst-1) = 0.0
+d(ked+1) = 0.0
 
 ! Source
 !dir$ vector aligned
@@ -574,9 +2374,9 @@ d(k) = (   ( x(k, i  , j-1)        &
        *   msk(k, i, j)
 end do ! 6 flops
 
-! BC  6 flops
-d(kst) = ( d(kst) + x(kst-1, i, j) * r ) * msk(kst, i, j)
-d(ked) = ( d(ked) + x(ked+1, i, j) * r ) * msk(ked, i, j)
+! BC  8 flops
+d(kst) = ( d(kst) + x(kst-1, i, j) * wl * r ) * msk(kst, i, j)
+d(ked) = ( d(ked) + x(ked+1, i, j) * wr * r ) * msk(ked, i, j)
 
 
 ! PCR  最終段の一つ手前で停止
@@ -589,19 +2389,12 @@ s = 2**(p-1)
 do k = kst, ked
 kl = max(k-s, kst-1)
 kr = min(k+s, ked+1)
-ap = a(k)
-cp = c(k)
-e = 1.0 / ( 1.0 - ap * c(kl) - cp * a(kr) )
-a1(k) =  -e * ap * a(kl)
-c1(k) =  -e * cp * c(kr)
-d1(k) =   e * ( d(k) - ap * d(kl) - cp * d(kr) )
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(kl) - fc(k,p) * d(kr)
 end do
 
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-a(k) = a1(k)
-c(k) = c1(k)
 d(k) = d1(k)
 end do
 
@@ -616,38 +2409,91 @@ s = 2**(pn-1)
 !NEC$ IVDEP
 !$acc loop independent
 do k = kst, kst+s-1
-kl = max(k-s, kst-1)
 kr = min(k+s, ked+1)
-cc1 = c(k)
-aa2 = a(kr)
-f1  = d(k)
-f2  = d(kr)
-jj  = 1.0 / (1.0 - aa2 * cc1)
-dd1 = (f1 - cc1 * f2) * jj
-dd2 = (f2 - aa2 * f1) * jj
-d1(k ) = dd1
-d1(kr) = dd2
+dd1 = d(k)
+dd2 = d(kr)
+d1(k ) = f2(1,k) * dd1 + f2(2,k) * dd2
+d1(kr) = f2(3,k) * dd1 + f2(4,k) * dd2
 end do
 
 
-! a_{i-1} x_{i-2} + x_{i-1} + c_{i-1} x_i     = d_{i-1}
-! a_{i}   x_{i-1} + x_{i}   + c_{i}   x_{i+1} = d_{i}
-! a_{i+1} x_{i}   + x_{i+1} + c_{i+1} x_{i+2} = d_{i+1}
+!dir$ vector aligned
+!dir$ simd
+do k = kst, ked
+y(k, i, j) = d1(k)
+end do
 
+ye(1, l) = d1(kst)
+ye(2, l) = d1(ked)
+
+end do
+#ifdef _OPENACC
+!$acc end kernels
+#else
+!$OMP END DO
+!$OMP END PARALLEL
+#endif
+
+return
+end subroutine pcr_rb_y
+
+
+!********************************************************************************
+!> @brief K方向に分割されたラインの重ね合わせと緩和（2色オーダリング）
+!! @param [in]  y    pcr_rb_y() の局所解
+!! @param [in]  fu   minus側の境界値1に対する応答
+!! @param [in]  fv   plus側の境界値1に対する応答
+!! @param [in]  xe   隣接ランク側の境界値 xe(1,l):minus側, xe(2,l):plus側
+!! @note 解は y + fu*xe(1) + fv*xe(2)
+!<
+subroutine pcr_rb_relax (sz, idx, g, nl, lst, x, msk, y, fu, fv, xe, omg, res, flop)
+use cz_layout
+implicit none
+!args
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+integer                                                ::  g, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, y
+real, dimension(idx(4):idx(5))                         ::  fu, fv
+real, dimension(2, nl)                                 ::  xe
+real                                                   ::  omg
+double precision                                       ::  res, flop
+! work
+integer                                  ::  i, j, k, l, kst, ked
+real                                     ::  pp, dp, xl, xr
+
+kst = idx(4)
+ked = idx(5)
+
+flop = flop + dble( nl * (ked-kst+1) * 10.0 )
+
+
+#ifdef _OPENACC
+!$acc kernels
+!$acc loop independent gang private(i, j, xl, xr) reduction(+:res)
+#else
+!$OMP PARALLEL &
+!$OMP reduction(+:res) &
+!$OMP private(i, j, k, pp, dp, xl, xr)
+!$OMP DO SCHEDULE(static)
+#endif
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
+xl = xe(1, l)
+xr = xe(2, l)
 
-! Relaxation
 !dir$ vector aligned
 !dir$ simd
 !$acc loop reduction(+:res)
 do k = kst, ked
 pp =   x(k, i, j)
-dp = ( d1(k) - pp ) * omg * msk(k, i, j)
+dp = ( y(k, i, j) + fu(k) * xl + fv(k) * xr - pp ) * omg * msk(k, i, j)
 x(k, i, j) = pp + dp
-!res1 = res1 + dp*dp
 res = res + dp*dp
 end do
 
-end do
 end do
 #ifdef _OPENACC
 !$acc end kernels
@@ -656,29 +2502,29 @@ end do
 !$OMP END PARALLEL
 #endif
 
-!res = res + real(res1, kind=8)
-
 return
-end subroutine pcr_rb
+end subroutine pcr_rb_relax
 
 
 !********************************************************************************
-subroutine pcr (sz, idx, g, pn, x, msk, rhs, a, c, d, a1, c1, d1, omg, res, flop)
+subroutine pcr (sz, idx, g, pn, x, msk, rhs, fe, fa, fc, f4, d, d1, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(16, idx(4):idx(5))                     ::  f4
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
 integer                                  ::  i, j, k, kl, km, kr, s, p
 integer                                  ::  ist, ied, jst, jed, kst, ked
-real, dimension(1-g:sz(3)+g)             ::  a, c, d, a1, c1, d1
-real                                     ::  r, ap, cp, e, pp, dp, res1
-real                                     ::  jj, dd1, dd2, dd3, dd4, aa2, aa3, aa4, cc1, cc2, cc3
-real                                     ::  inv_detA, detA1, detA2, detA3, detA4
+real, dimension(1-g:sz(3)+g)             ::  d, d1
+real                                     ::  r, pp, dp, res1
+real                                     ::  dd1, dd2, dd3, dd4
 
 
 ist = idx(0)
@@ -694,8 +2540,8 @@ r = 1.0/6.0
 flop = flop + dble(          &
 (jed-jst+1)*(ied-ist+1)* ( &
 (ked-kst+1)* 6.0        &  ! Source
-+ (ked-kst+1)*(pn-2)*14.0 & ! PCR4x4
-+ 2**(pn-2)*74.0                 &
++ (ked-kst+1)*(pn-2)*5.0 & ! PCR4x4
++ 2**(pn-2)*28.0                 &
 + (ked-kst+1)*6.0         &  ! Relaxation
 + 6.0 )                 &  ! BC
 )
@@ -704,36 +2550,22 @@ flop = flop + dble(          &
 #ifdef _OPENACC
 !$acc kernels
 !$acc loop independent collapse(2) reduction(+:res1) &
-!$acc& private(a, c, d, a1, c1, d1) &
-!$acc& private(kl, kr, ap, cp, e, s, p, k, pp, dp) &
-!$acc& private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2)
+!$acc& private(d, d1) &
+!$acc& private(kl, km, kr, s, p, k, pp, dp) &
+!$acc& private(dd1, dd2, dd3, dd4)
 #else
 !$OMP PARALLEL reduction(+:res1) &
-!$OMP private(kl, km, kr, ap, cp, e, s, p, k, pp, dp) &
-!$OMP private(jj, dd1, dd2, dd3, dd4, aa2, aa3, aa4, cc1, cc2, cc3) &
-!$OMP private(a, c, d, a1, c1, d1) &
-!$OMP private(inv_detA, detA1, detA2, detA3, detA4)
+!$OMP private(kl, km, kr, s, p, k, pp, dp) &
+!$OMP private(dd1, dd2, dd3, dd4) &
+!$OMP private(d, d1)
 !$OMP DO SCHEDULE(static) Collapse(2)
 #endif
 do j=jst, jed
 do i=ist, ied
 
-! Reflesh coef. due to override
-! 係数行列a[1-g:sz(3)+g]を初期化
-! r = 1.0 / 6.0
-a(kst-1) = 0.0
-a(kst) = 0.0
-do k=kst+1, ked
-a(k) = -r
-end do
-a(ked+1) = 0.0
-
-c(kst-1) = 0.0
-do k=kst, ked-1
-c(k) = -r
-end do
-c(ked) = 0.0
-c(ked+1) = 0.0
+! 係数は pcr_factorize() で計算済み，範囲外の参照のため端を0にしておく
+d(kst-1) = 0.0
+d(ked+1) = 0.0
 
 ! Source
 !dir$ vector aligned
@@ -765,19 +2597,12 @@ s = 2**(p-1)
 do k = kst, ked
 kl = max(k-s, kst-1)
 kr = min(k+s, ked+1)
-ap = a(k)
-cp = c(k)
-e = 1.0 / ( 1.0 - ap * c(kl) - cp * a(kr) )
-a1(k) =  -e * ap * a(kl)
-c1(k) =  -e * cp * c(kr)
-d1(k) =   e * ( d(k) - ap * d(kl) - cp * d(kr) )
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(kl) - fc(k,p) * d(kr)
 end do
 
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-a(k) = a1(k)
-c(k) = c1(k)
 d(k) = d1(k)
 end do
 
@@ -798,49 +2623,17 @@ kl = min(k+  s, ked+1)
 km = min(k+2*s, ked+1)
 kr = min(k+3*s, ked+1)
 
-! A = \\
-! \begin{pmatrix}
-! 1   & cc1 & 0   & 0   \\
-! aa2 & 1   & cc2 & 0   \\
-! 0   & aa3 & 1   & cc3 \\
-! 0   & 0   & aa4 & 1   \\
-! \end{pmatrix}
-cc1 = c(k)
-cc2 = c(kl)
-cc3 = c(km)
-aa2 = a(kl)
-aa3 = a(km)
-aa4 = a(kr)
-
 ! (dd1, dd2, dd3, dd4 ) = ( d(k) & d(kl) & d(km) & d(kr) )
 dd1 = d(k)
 dd2 = d(kl)
 dd3 = d(km)
 dd4 = d(kr)
 
-! 1.0 / |A|
-inv_detA= 1.0 / (1.0 - aa4*cc3 - aa3*cc2 - aa2*cc1*(1.0 - cc3*aa4))
-
-! |A_i|
-! A_i = A の第 i-列 (i = 1, 2, …, n) を系の右辺である d で置き換えて得られる行列
-detA1 = -cc3*(aa4*dd1 + cc1*cc2*dd4 - aa4*cc1*dd2) &
-+       dd1 + cc1*cc2*dd3 - aa3*cc2*dd1 - cc1*dd2
-
-detA2 = dd2 + cc2*cc3*dd4 - aa4*cc3*dd2 - cc2*dd3 &
--       aa2*(dd1 - aa4*cc3*dd1)
-
-detA3 = dd3 - cc3*dd4 - aa3*dd2 &
--       aa2*(cc1*dd3 - cc1*cc3*dd4 - aa3*dd1)
-
-detA4 = dd4 + aa3*aa4*dd2 - aa4*dd3 - aa3*cc2*dd4 &
--       aa2*(cc1*dd4 + aa3*aa4*dd1 - aa4*cc1*dd3)
-
-
-! Cramer's rule
-d1(k)  = detA1 * inv_detA
-d1(kl) = detA2 * inv_detA
-d1(km) = detA3 * inv_detA
-d1(kr) = detA4 * inv_detA
+! x = A^{-1} d
+d1(k)  = f4( 1,k)*dd1 + f4( 2,k)*dd2 + f4( 3,k)*dd3 + f4( 4,k)*dd4
+d1(kl) = f4( 5,k)*dd1 + f4( 6,k)*dd2 + f4( 7,k)*dd3 + f4( 8,k)*dd4
+d1(km) = f4( 9,k)*dd1 + f4(10,k)*dd2 + f4(11,k)*dd3 + f4(12,k)*dd4
+d1(kr) = f4(13,k)*dd1 + f4(14,k)*dd2 + f4(15,k)*dd3 + f4(16,k)*dd4
 end do
 
 
@@ -881,12 +2674,13 @@ end subroutine pcr
 !********************************************************************************
 ! pcr for vector (Aurora and GPU)
 subroutine pcr_eda (sz, idx, g, pn, x, msk, rhs, a1, c1, d1, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
@@ -1047,24 +2841,24 @@ end subroutine pcr_eda
 
 !********************************************************************************
 ! pcr for vector (Aurora and GPU)
-subroutine pcr_esa (sz, idx, g, pn, s, x, msk, rhs, a, c, d, a1, c1, d1, omg, res, flop)
+subroutine pcr_esa (sz, idx, g, pn, s, x, msk, rhs, fe, fa, fc, f4, d, d1, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(16, idx(4):idx(5))                     ::  f4
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
 integer                                  ::  i, j, k, kl, km, kr, p, sq, s
 integer                                  ::  ist, ied, jst, jed, kst, ked
-real, dimension(1-g:sz(3)+g)             ::  a1, c1, d1
-real, dimension(idx(4)-s:idx(5)+s)       ::  a, c, d
-real                                     ::  r, ap, cp, e, pp, dp, res1
-real                                     ::  jj, dd1, dd2, dd3, dd4
-real                                     ::  aa2, aa3, aa4, cc1, cc2, cc3
-real                                     ::  inv_detA, detA1, detA2, detA3, detA4
+real, dimension(idx(4)-s:idx(5)+s)       ::  d, d1
+real                                     ::  r, pp, dp, res1
+real                                     ::  dd1, dd2, dd3, dd4
 
 ist = idx(0)
 ied = idx(1)
@@ -1079,8 +2873,8 @@ r = 1.0/6.0
 flop = flop + dble(          &
 (jed-jst+1)*(ied-ist+1)* ( &
 (ked-kst+1)* 6.0        &  ! Source
-+ (ked-kst+1)*(pn-2)*14.0 &  ! PCR
-+ 2**(pn-2)*78.0                 &
++ (ked-kst+1)*(pn-2)*5.0 &  ! PCR
++ 2**(pn-2)*28.0                 &
 + (ked-kst+1)*6.0         &  ! Relaxation
 + 6.0 )                 &  ! BC
 )
@@ -1088,46 +2882,22 @@ flop = flop + dble(          &
 #ifdef _OPENACC
 !$acc kernels
 !$acc loop independent collapse(2) gang reduction(+:res1) &
-!$acc& private(a, c, d, a1, c1, d1) &
-!$acc& private(ap, cp, e, sq, p, k, pp, dp) &
-!$acc& private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2)
+!$acc& private(d1) firstprivate(d) &
+!$acc& private(sq, p, k, kl, km, kr, pp, dp) &
+!$acc& private(dd1, dd2, dd3, dd4)
 #else
 !$OMP PARALLEL reduction(+:res1) &
-!$OMP private(ap, cp, e, sq, p, k, km, kl, kr, pp, dp) &
-!$OMP private(jj, dd1, dd2, dd3, dd4, aa2, aa3, aa4, cc1, cc2, cc3) &
-!$OMP private(a1, c1, d1) &
-!$OMP private(inv_detA, detA1, detA2, detA3, detA4) &
-!$OMP firstprivate(a, c, d)
+!$OMP private(sq, p, k, km, kl, kr, pp, dp) &
+!$OMP private(dd1, dd2, dd3, dd4) &
+!$OMP private(d1) &
+!$OMP firstprivate(d)
 !$OMP DO SCHEDULE(static) Collapse(2)
 #endif
 do j=jst, jed
 do i=ist, ied
 
-! Reflesh coef. due to override
-
-do sq=0, s
-a(kst-sq) = 0.0
-a(ked+sq) = 0.0
-end do
-! override a(ked) = -r
-
-do k=kst+1, ked
-a(k) = -r
-end do
-do k=ked+1, ked+s
-a(k) = 0.0
-end do
-
-
-do sq=0, s
-c(kst-sq) = 0.0
-c(ked+sq) = 0.0
-end do
-do k=kst, ked-1
-c(k) = -r
-end do
-! over write c(kst)
-
+! 係数は pcr_factorize() で計算済み
+! dの袖 d(kst-s:kst-1), d(ked+1:ked+s) はゼロのまま
 
 ! Source
 !dir$ vector aligned
@@ -1154,19 +2924,12 @@ sq = 2**(p-1)
 !dir$ simd
 !pgi$ ivdep
 do k = kst, ked
-ap = a(k)
-cp = c(k)
-e = 1.0 / ( 1.0 - ap * c(k-sq) - cp * a(k+sq) )
-a1(k) =   -e * ap * a(k-sq)
-c1(k) =   -e * cp * c(k+sq)
-d1(k) =   e * ( d(k) - ap * d(k-sq) - cp * d(k+sq) )
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(k-sq) - fc(k,p) * d(k+sq)
 end do
 
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-a(k) = a1(k)
-c(k) = c1(k)
 d(k) = d1(k)
 end do
 
@@ -1186,42 +2949,17 @@ kl = k + sq
 km = k + 2*sq
 kr = k + 3*sq
 
-cc1 = c(k)
-cc2 = c(kl)
-cc3 = c(km)
-aa2 = a(kl)
-aa3 = a(km)
-aa4 = a(kr)
-
 ! (dd1, dd2, dd3, dd4 ) = ( d(k) & d(kl) & d(km) & d(kr) )
 dd1 = d(k)
 dd2 = d(kl)
 dd3 = d(km)
 dd4 = d(kr)
 
-! 1.0 / |A|
-inv_detA= 1.0 / (1.0 - aa4*cc3 - aa3*cc2 - aa2*cc1*(1.0 - cc3*aa4))
-
-! |A_i|
-! A_i = A の第 i-列 (i = 1, 2, …, n) を系の右辺である d で置き換えて得られる行列
-detA1 = -cc3*(aa4*dd1 + cc1*cc2*dd4 - aa4*cc1*dd2) &
-+       dd1 + cc1*cc2*dd3 - aa3*cc2*dd1 - cc1*dd2
-
-detA2 = dd2 + cc2*cc3*dd4 - aa4*cc3*dd2 - cc2*dd3 &
--       aa2*(dd1 - aa4*cc3*dd1)
-
-detA3 = dd3 - cc3*dd4 - aa3*dd2 &
--       aa2*(cc1*dd3 - cc1*cc3*dd4 - aa3*dd1)
-
-detA4 = dd4 + aa3*aa4*dd2 - aa4*dd3 - aa3*cc2*dd4 &
--       aa2*(cc1*dd4 + aa3*aa4*dd1 - aa4*cc1*dd3)
-
-
-! Cramer's rule
-d1(k)  = detA1 * inv_detA
-d1(kl) = detA2 * inv_detA
-d1(km) = detA3 * inv_detA
-d1(kr) = detA4 * inv_detA
+! x = A^{-1} d
+d1(k)  = f4( 1,k)*dd1 + f4( 2,k)*dd2 + f4( 3,k)*dd3 + f4( 4,k)*dd4
+d1(kl) = f4( 5,k)*dd1 + f4( 6,k)*dd2 + f4( 7,k)*dd3 + f4( 8,k)*dd4
+d1(km) = f4( 9,k)*dd1 + f4(10,k)*dd2 + f4(11,k)*dd3 + f4(12,k)*dd4
+d1(kr) = f4(13,k)*dd1 + f4(14,k)*dd2 + f4(15,k)*dd3 + f4(16,k)*dd4
 end do
 
 
@@ -1258,24 +2996,25 @@ end subroutine pcr_esa
 
 
 !********************************************************************************
-subroutine pcr_rb_esa (sz, idx, g, pn, ofst, color, s, x, msk, rhs, a, c, d, a1, c1, d1, omg, res, flop)
+subroutine pcr_rb_esa (sz, idx, g, pn, nl, lst, s, x, msk, rhs, fe, fa, fc, f4, d, d1, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
-integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs
+integer                                                ::  g, pn, nl
+integer, dimension(2, nl)                              ::  lst
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(16, idx(4):idx(5))                     ::  f4
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
-integer                                  ::  i, j, k, kl, km, kr, p, color, ip, ofst, sq, s
+integer                                  ::  i, j, k, l, kl, km, kr, p, sq, s
 integer                                  ::  ist, ied, jst, jed, kst, ked
-real, dimension(-1:sz(3)+2)              ::  a1, c1, d1
-real, dimension(idx(4)-s:idx(5)+s)       ::  a, c, d
-real                                     ::  r, ap, cp, e, pp, dp, res1
-real                                     ::  jj, dd1, dd2, dd3, dd4
-real                                     ::  aa2, aa3, aa4, cc1, cc2, cc3
-real                                     ::  inv_detA, detA1, detA2, detA3, detA4
+real, dimension(idx(4)-s:idx(5)+s)       ::  d, d1
+real                                     ::  r, pp, dp, res1
+real                                     ::  dd1, dd2, dd3, dd4
 
 
 ist = idx(0)
@@ -1289,60 +3028,38 @@ res1 = 0.0
 r = 1.0/6.0
 
 flop = flop + dble(          &
-(jed-jst+1)*(ied-ist+1)* ( &
+nl * ( &
 (ked-kst+1)* 6.0        &  ! Source
-+ (ked-kst+1)*(pn-2)*14.0 &  ! PCR
-+ 2**(pn-2)*78.0                 &
++ (ked-kst+1)*(pn-2)*5.0 &  ! PCR
++ 2**(pn-2)*28.0                 &
 + (ked-kst+1)*6.0         &  ! Relaxation
 + 6.0 )                 &  ! BC
-) * 0.5
-
-! unused variable
-ip = ofst + color
+)
 
 
 #ifdef _OPENACC
 !$acc kernels
-!$acc loop independent collapse(2) gang reduction(+:res1) &
-!$acc& private(a, c, d, a1, c1, d1) &
-!$acc& private(ap, cp, e, sq, p, k, pp, dp) &
-!$acc& private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2)
+!$acc loop independent gang reduction(+:res1) &
+!$acc& private(i, j) &
+!$acc& private(d1) firstprivate(d) &
+!$acc& private(sq, p, k, kl, km, kr, pp, dp) &
+!$acc& private(dd1, dd2, dd3, dd4)
 #else
 !$OMP PARALLEL reduction(+:res1) &
-!$OMP private(ap, cp, e, sq, p, k, km, kl, kr, pp, dp) &
-!$OMP private(jj, dd1, dd2, dd3, dd4, aa2, aa3, aa4, cc1, cc2, cc3) &
-!$OMP private(a1, c1, d1) &
-!$OMP private(inv_detA, detA1, detA2, detA3, detA4) &
-!$OMP firstprivate(a, c, d)
-!$OMP DO SCHEDULE(static) collapse(2)
+!$OMP private(i, j) &
+!$OMP private(sq, p, k, km, kl, kr, pp, dp) &
+!$OMP private(dd1, dd2, dd3, dd4) &
+!$OMP private(d1) &
+!$OMP firstprivate(d)
+!$OMP DO SCHEDULE(static)
 #endif
-do j=jst, jed
-do i=ist, ied
-if(mod(i+j,2) /= color) cycle
-
-!do i=ist+mod(j+ip,2), ied, 2
+do l=1, nl
+i = lst(1, l)
+j = lst(2, l)
 
 
-! Reflesh coef. due to override
-do k=kst-s, kst
-a(k) = 0.0
-end do
-do k=kst+1, ked
-a(k) = -r
-end do
-do k=ked+1, ked+s
-a(k) = 0.0
-end do
-
-do k=kst-s, kst-1
-c(k) = 0.0
-end do
-do k=kst, ked-1
-c(k) = -r
-end do
-do k=ked, ked+s
-c(k) = 0.0
-end do
+! 係数は pcr_factorize() で計算済み
+! dの袖 d(kst-s:kst-1), d(ked+1:ked+s) はゼロのまま
 
 ! Source
 !dir$ vector aligned
@@ -1368,19 +3085,12 @@ sq = 2**(p-1)
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-ap = a(k)
-cp = c(k)
-e = 1.0 / ( 1.0 - ap * c(k-sq) - cp * a(k+sq) )
-a1(k) =   -e * ap * a(k-sq)
-c1(k) =   -e * cp * c(k+sq)
-d1(k) =   e * ( d(k) - ap * d(k-sq) - cp * d(k+sq) )
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(k-sq) - fc(k,p) * d(k+sq)
 end do
 
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-a(k) = a1(k)
-c(k) = c1(k)
 d(k) = d1(k)
 end do
 
@@ -1399,42 +3109,17 @@ kl = k + sq
 km = k + 2*sq
 kr = k + 3*sq
 
-cc1 = c(k)
-cc2 = c(kl)
-cc3 = c(km)
-aa2 = a(kl)
-aa3 = a(km)
-aa4 = a(kr)
-
 ! (dd1, dd2, dd3, dd4 ) = ( d(k) & d(kl) & d(km) & d(kr) )
 dd1 = d(k)
 dd2 = d(kl)
 dd3 = d(km)
 dd4 = d(kr)
 
-! 1.0 / |A|
-inv_detA= 1.0 / (1.0 - aa4*cc3 - aa3*cc2 - aa2*cc1*(1.0 - cc3*aa4))
-
-! |A_i|
-! A_i = A の第 i-列 (i = 1, 2, …, n) を系の右辺である d で置き換えて得られる行列
-detA1 = -cc3*(aa4*dd1 + cc1*cc2*dd4 - aa4*cc1*dd2) &
-+       dd1 + cc1*cc2*dd3 - aa3*cc2*dd1 - cc1*dd2
-
-detA2 = dd2 + cc2*cc3*dd4 - aa4*cc3*dd2 - cc2*dd3 &
--       aa2*(dd1 - aa4*cc3*dd1)
-
-detA3 = dd3 - cc3*dd4 - aa3*dd2 &
--       aa2*(cc1*dd3 - cc1*cc3*dd4 - aa3*dd1)
-
-detA4 = dd4 + aa3*aa4*dd2 - aa4*dd3 - aa3*cc2*dd4 &
--       aa2*(cc1*dd4 + aa3*aa4*dd1 - aa4*cc1*dd3)
-
-
-! Cramer's rule
-d1(k)  = detA1 * inv_detA
-d1(kl) = detA2 * inv_detA
-d1(km) = detA3 * inv_detA
-d1(kr) = detA4 * inv_detA
+! x = A^{-1} d
+d1(k)  = f4( 1,k)*dd1 + f4( 2,k)*dd2 + f4( 3,k)*dd3 + f4( 4,k)*dd4
+d1(kl) = f4( 5,k)*dd1 + f4( 6,k)*dd2 + f4( 7,k)*dd3 + f4( 8,k)*dd4
+d1(km) = f4( 9,k)*dd1 + f4(10,k)*dd2 + f4(11,k)*dd3 + f4(12,k)*dd4
+d1(kr) = f4(13,k)*dd1 + f4(14,k)*dd2 + f4(15,k)*dd3 + f4(16,k)*dd4
 end do
 
 
@@ -1454,7 +3139,6 @@ x(k, i, j) = pp + dp
 res1 = res1 + dp*dp
 end do
 
-end do
 end do
 #ifdef _OPENACC
 !$acc end kernels
@@ -1470,22 +3154,24 @@ end subroutine pcr_rb_esa
 
 !********************************************************************************
 ! pcr for vector (Aurora and GPU)
-subroutine pcr_j_esa (sz, idx, g, pn, s, x, msk, rhs, a, c, d, a1, c1, d1, src, wrk, omg, res, flop)
+subroutine pcr_j_esa (sz, idx, g, pn, s, x, msk, rhs, fe, fa, fc, f2, d, d1, src, wrk, omg, res, flop)
+use cz_layout
 implicit none
 !args
 integer, dimension(3)                                  ::  sz
 integer, dimension(0:5)                                ::  idx
 integer                                                ::  g, pn
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  x, msk, rhs, src, wrk
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  x, msk, rhs, src, wrk
+real, dimension(idx(4):idx(5), pn)                     ::  fe, fa, fc
+real, dimension(4, idx(4):idx(5))                      ::  f2
 real                                                   ::  omg
 double precision                                       ::  res, flop
 ! work
 integer                                  ::  i, j, k, p, sq, s
 integer                                  ::  ist, ied, jst, jed, kst, ked
-real, dimension(1-g:sz(3)+g)             ::  a1, c1, d1
-real, dimension(idx(4)-s:idx(5)+s)       ::  a, c, d
-real                                     ::  r, ap, cp, e, pp, dp, res1
-real                                     ::  jj, dd1, dd2, aa2, cc1, cc2, f1, f2
+real, dimension(idx(4)-s:idx(5)+s)       ::  d, d1
+real                                     ::  r, pp, dp, res1
+real                                     ::  dd1, dd2
 
 ist = idx(0)
 ied = idx(1)
@@ -1500,8 +3186,8 @@ r = 1.0/6.0
 flop = flop + dble(          &
 (jed-jst+1)*(ied-ist+1)* ( &
 (ked-kst+1)* 6.0        &  ! Source
-+ (ked-kst+1)*(pn-1)*14.0 &  ! PCR
-+ 2**(pn-1)*9.0                 &
++ (ked-kst+1)*(pn-1)*5.0 &  ! PCR
++ 2**(pn-1)*6.0                 &
 + (ked-kst+1)*6.0         &  ! Relaxation
 + 6.0 )                 &  ! BC
 )
@@ -1540,29 +3226,21 @@ end do ! 6 flops
 #ifdef _OPENACC
 !$acc kernels
 !$acc loop independent collapse(2) gang reduction(+:res1) &
-!$acc& private(a, c, d, a1, c1, d1) &
-!$acc& private(ap, cp, e, sq, p, k, pp, dp) &
-!$acc& private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2)
+!$acc& private(d1) firstprivate(d) &
+!$acc& private(sq, p, k, pp, dp) &
+!$acc& private(dd1, dd2)
 #else
 !$OMP DO SCHEDULE(static) Collapse(2) reduction(+:res1) &
-!$OMP private(ap, cp, e, sq, p, k, pp, dp) &
-!$OMP private(jj, dd1, dd2, aa2, cc1, cc2, f1, f2) &
-!$OMP private(a1, c1, d1) &
-!$OMP firstprivate(a, c, d)
+!$OMP private(sq, p, k, pp, dp) &
+!$OMP private(dd1, dd2) &
+!$OMP private(d1) &
+!$OMP firstprivate(d)
 #endif
 do j=jst, jed
 do i=ist, ied
 
-! Reflesh coef. due to override
-!a(kst) = 0.0
-do k=kst+1, ked
-a(k) = -r
-end do
-
-do k=kst, ked-1
-c(k) = -r
-end do
-!c(ked) = 0.0
+! 係数は pcr_factorize() で計算済み
+! dの袖 d(kst-s:kst-1), d(ked+1:ked+s) はゼロのまま
 
 ! Source
 do k = kst, ked
@@ -1584,19 +3262,12 @@ sq = 2**(p-1)
 !pgi$ ivdep
 !$acc loop independent
 do k = kst, ked
-ap = a(k)
-cp = c(k)
-e = 1.0 / ( 1.0 - ap * c(k-sq) - cp * a(k+sq) )
-a1(k) =   -e * ap * a(k-sq)
-c1(k) =   -e * cp * c(k+sq)
-d1(k) =   e * ( d(k) - ap * d(k-sq) - cp * d(k+sq) )
+d1(k) = fe(k,p) * d(k) - fa(k,p) * d(k-sq) - fc(k,p) * d(k+sq)
 end do
 
 !dir$ vector aligned
 !dir$ simd
 do k = kst, ked
-a(k) = a1(k)
-c(k) = c1(k)
 d(k) = d1(k)
 end do
 
@@ -1612,15 +3283,10 @@ sq = 2**(pn-1)
 !pgi$ ivdep
 !$acc loop independent
 do k = kst, kst+sq-1 ! 2, 2+256-1=257
-cc1 = c(k)
-aa2 = a(k+sq)
-f1  = d(k)
-f2  = d(k+sq)
-jj  = 1.0 / (1.0 - aa2 * cc1)
-dd1 = (f1 - cc1 * f2) * jj
-dd2 = (f2 - aa2 * f1) * jj
-d1(k   ) = dd1
-d1(k+sq) = dd2
+dd1 = d(k)
+dd2 = d(k+sq)
+d1(k   ) = f2(1,k) * dd1 + f2(2,k) * dd2
+d1(k+sq) = f2(3,k) * dd1 + f2(4,k) * dd2
 end do
 
 
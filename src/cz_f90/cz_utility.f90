@@ -15,10 +15,11 @@
 
 !> *******************************
 subroutine fileout_t (sz, g, s, dh, org, fname)
+use cz_layout
 implicit none
 integer                                                :: nn, ix, jx, kx, i, j, k, g
 integer, dimension(3)                                  :: sz
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) :: s
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) :: s
 real                                                   :: dh, rtime
 real, dimension(3)                                     :: org
 character*20                                           :: fname
@@ -50,12 +51,13 @@ end subroutine fileout_t
 
 !> *******************************
 subroutine exact_t (sz, g, e, dh, org)
+use cz_layout
 implicit none
 include 'cz_fparam.fi'
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer, dimension(3)                                  ::  sz
 real, dimension(3)                                     ::  org
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  e
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  e
 real                                                   ::  dh, pi, r2, x, y, z
 
 ix = sz(1)
@@ -84,13 +86,14 @@ end subroutine exact_t
 
 !> *******************************
 subroutine err_t (sz, idx, g, d, p, e, loc)
+use cz_layout
 implicit none
 integer                                                ::  i, j, k, ix, jx, kx, g
 integer                                                ::  ist, jst, kst
 integer                                                ::  ied, jed, ked
 integer, dimension(3)                                  ::  sz, loc
 integer, dimension(0:5)                                ::  idx
-real, dimension(1-g:sz(3)+g, 1-g:sz(1)+g, 1-g:sz(2)+g) ::  p, e
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  p, e
 real                                                   ::  r
 double precision                                       ::  d, q
 
@@ -127,3 +130,54 @@ end do
 
 return
 end subroutine err_t
+
+
+!> ********************************************************************
+!! @brief 繰り返し求解の試験用のソース項（ガウス分布）
+!! @param [in,out] b    RHSベクトル
+!! @param [in]     sz   配列長
+!! @param [in]     idx  インデクス範囲
+!! @param [in]     g    ガイドセル長
+!! @param [in]     dh   格子幅
+!! @param [in]     org  自ランクの原点
+!! @param [in]     c    振幅
+!! @param [in]     xs   中心
+!! @param [in]     w    幅
+!! @note 内点のみ上書きし，離散化に合わせて dh^2 を掛ける
+!<
+subroutine warm_source (b, sz, idx, g, dh, org, c, xs, w)
+use cz_layout
+implicit none
+integer                                                ::  i, j, k, g
+integer                                                ::  ist, jst, kst
+integer                                                ::  ied, jed, ked
+integer, dimension(3)                                  ::  sz
+integer, dimension(0:5)                                ::  idx
+real, dimension(3)                                     ::  org, xs
+real, dimension(1-g:cz_ek(sz,g), 1-g:cz_ei(sz,g), 1-g:sz(2)+g) ::  b
+real                                                   ::  dh, c, w, x, y, z, a
+
+ist = idx(0)
+ied = idx(1)
+jst = idx(2)
+jed = idx(3)
+kst = idx(4)
+ked = idx(5)
+
+a = c * dh * dh
+
+!$OMP PARALLEL DO SCHEDULE(static) COLLAPSE(2) PRIVATE(x, y, z)
+do j = jst, jed
+do i = ist, ied
+do k = kst, ked
+  x = org(1) + dh*real(i-1) - xs(1)
+  y = org(2) + dh*real(j-1) - xs(2)
+  z = org(3) + dh*real(k-1) - xs(3)
+  b(k,i,j) = a * exp( -(x*x + y*y + z*z) / (w*w) )
+end do
+end do
+end do
+!$OMP END PARALLEL DO
+
+return
+end subroutine warm_source
@@ -19,12 +19,20 @@ int main(int argc, char *argv[]) {
   if (argc != 7 && argc != 8 && argc != 10 && argc != 11) {
     if ( myRank == 0) {
       printf("\tUsage : ./cz-mpi gsz_x, gsz_y, gsz_z, linear_solver, IterationMax, acc_coef [precond] [gdv_x, gdv_y, gdv_z]\n");
-      printf("\t\tlinear_solver = {jacobi | psor | sor2sma | pbicgstab | lsor | lsorms | lsormsb}\n");
-      printf("\t\tprecond = {none | jacobi | psor | sor2sma}\n\n");
+      printf("\t\tlinear_solver = {jacobi | psor | ssor | sor2sma | sor2sma_sym | mcsor | pbicgstab | pipebicgstab | ca_bicgstab | pcg | mg | mg_w | cheby | ir | fgmres | lsor | lsorms | lsormsb}\n");
+      printf("\t\tprecond = {none | jacobi | psor | ssor | sor2sma | sor2sma_sym | mcsor | mg | cheby}\n");
+      printf("\t\tprecond of ir = inner solver {sor2sma | pcr_rb | ... | pbicgstab}\n");
+      printf("\t\tprecond of fgmres = {sor2sma | pcr_rb | ... | pbicgstab}, may vary between iterations\n\n");
       printf("\t$ ./cz-mpi 64 64 64 jacobi 4000 0.8 2 2 1\n");
       printf("\t$ ./cz-mpi 64 64 64 psor 4000 1.1\n");
+      printf("\t$ ./cz-mpi 64 64 64 sor2sma 4000 auto\n");
       printf("\t$ ./cz-mpi 64 64 64 pbicgstab 4000 1.1 sor2sma\n");
       printf("\t$ ./cz-mpi 64 64 64 pbicgstab 4000 1.1 sor2sma 2 1 3\n");
+      printf("\t$ ./cz-mpi 64 64 64 pcr_rb_hyb 4000 1.2\n");
+      printf("\t$ CZ_EPS=1.0e-10 ./cz-mpi 64 64 64 ir 100 1.2 pcr_rb\n");
+      printf("\t$ CZ_GMRES_M=30 ./cz-mpi 64 64 64 fgmres 4000 1.2 pcr_rb\n");
+      printf("\t$ CZ_STEPS=20 CZ_WARM=proj ./cz-mpi 64 64 64 pbicgstab 4000 1.2 sor2sma\n");
+      printf("\t$ CZ_BATCH=4 ./cz-mpi 64 64 64 sor2sma 4000 1.2\n");
     }
     return 0;
   }
@@ -38,17 +46,18 @@ int main(int argc, char *argv[]) {
   int mode = 0;
   mode = 1; // デバッグ時に定義
 
-  CZ cz;
-  cz.debug(mode);
+  int ret = 0;
 
-
-  if( 0==cz.Evaluate(argc, argv) )
+  // CZの配列はデストラクタで解放するので，MPI_Finalize()の前にスコープを抜ける
   {
-    if ( myRank == 0) printf("\n\tSolver error.\n\n");
-    #ifndef DISABLE_MPI
-    MPI_Finalize();
-    #endif
-    return -1;
+    CZ cz;
+    cz.debug(mode);
+
+    if( 0==cz.Evaluate(argc, argv) )
+    {
+      if ( myRank == 0) printf("\n\tSolver error.\n\n");
+      ret = -1;
+    }
   }
 
 
@@ -56,5 +65,5 @@ int main(int argc, char *argv[]) {
   MPI_Finalize();
   #endif
 
-  return 0;
+  return ret;
 }